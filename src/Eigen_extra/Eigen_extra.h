@@ -11,6 +11,8 @@ using Eigen::VectorXd;
 
 using Ve = VectorXd;
 using Ma = MatrixXd;
+// 只读零拷贝视图：指向外部连续内存的 Ve
+using VeView = Eigen::Map<const VectorXd>;
 
 // 默认有效性判定：仅排除 NaN
 inline bool defaultIsValid(double value) {
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <functional>
+
+namespace EigenExtra {
+
+// 单调双端队列（固定容量，连续存储，push/expire 不做内存分配）
+// 用于滑动窗口极值：队列中保存 (样本序号, 值)，从队首到队尾按 Compare 单调，队首即窗口极值
+// Compare 为 std::greater<double> 时队首为最大值，std::less<double> 时为最小值
+// 相等值保留较早者（严格比较出队），队首序号即窗口内首次出现的极值位置
+template<typename Compare>
+class MonotonicDeque {
+public:
+	MonotonicDeque() = default;
+	explicit MonotonicDeque(size_t windowSize) { resize(windowSize); }
+
+	// 设置窗口大小并清空（容量为窗口大小 + 1：新值先入队再淘汰过期值）
+	void resize(size_t windowSize) {
+		m_windowSize = windowSize;
+		m_capacity = windowSize + 1;
+		m_indices.assign(m_capacity, 0);
+		m_values.assign(m_capacity, 0.0);
+		clear();
+	}
+	void clear() {
+		m_head = 0;
+		m_size = 0;
+		m_nextIndex = 0;
+	}
+
+	// 写入一个新样本（NaN 只占序号不入队），并淘汰滑出窗口的样本
+	void push(double value) {
+		const size_t index = m_nextIndex++;
+		if (!std::isnan(value)) {
+			// 队尾被新值支配的元素出队（严格比较，相等值保留较早者）
+			while (m_size > 0 && Compare()(value, m_values[physical(m_size - 1)])) {
+				--m_size;
+			}
+			const size_t tail = physical(m_size);
+			m_indices[tail] = index;
+			m_values[tail] = value;
+			++m_size;
+		}
+		// 队首过期出队：窗口为最近 m_windowSize 个序号
+		while (m_size > 0 && m_indices[m_head] + m_windowSize < m_nextIndex) {
+			m_head = (m_head + 1 == m_capacity) ? 0 : m_head + 1;
+			--m_size;
+		}
+	}
+
+	bool empty() const { return m_size == 0; }
+	// 窗口极值（队列为空即窗口内全为 NaN 时返回 NaN）
+	double front() const { return m_size > 0 ? m_values[m_head] : std::nan(""); }
+	// 窗口极值的逻辑位置（0 为窗口内最旧样本，队列为空时返回 -1）
+	long frontPosition() const {
+		if (m_size == 0) { return -1; }
+		const size_t oldestIndex = (m_nextIndex > m_windowSize) ? (m_nextIndex - m_windowSize) : 0;
+		return static_cast<long>(m_indices[m_head] - oldestIndex);
+	}
+	size_t size() const { return m_size; }
+
+private:
+	// 队列逻辑位置（0 为队首）映射到物理位置
+	size_t physical(size_t position) const {
+		const size_t pos = m_head + position;
+		return (pos >= m_capacity) ? pos - m_capacity : pos;
+	}
+
+	std::vector<size_t> m_indices; // 样本序号
+	std::vector<double> m_values;  // 样本值
+	size_t m_windowSize{0};
+	size_t m_capacity{0};
+	size_t m_head{0};      // 队首物理位置
+	size_t m_size{0};      // 队列长度
+	size_t m_nextIndex{0}; // 下一个样本的序号
+};
+
+} // namespace EigenExtra
@@ -0,0 +1,235 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace EigenExtra {
+
+// 顺序统计树（带子树计数的 Treap，可重集合，节点池预分配，insert/erase 不做内存分配）
+// 用于滑动窗口排名/分位数：插入、删除、按值求排名、按排名取值均为 O(log W)
+// 相等键合并为一个节点并记录重数；NaN 不入树
+// Key 为 double，或 (值, 样本序号) 以区分相等值并支持按值域反查样本位置
+template<typename Key = double>
+class OrderStatisticTree {
+public:
+	OrderStatisticTree() = default;
+	explicit OrderStatisticTree(size_t capacity) { reserve(capacity); }
+
+	// 预分配节点池（容量为不同值个数上限，通常取窗口大小）并清空
+	void reserve(size_t capacity) {
+		m_nodes.clear();
+		m_nodes.reserve(capacity);
+		m_free.clear();
+		m_free.reserve(capacity);
+		m_root = -1;
+	}
+	void clear() { reserve(m_nodes.capacity()); }
+
+	// 插入一个键（NaN 忽略）
+	void insert(const Key& value) {
+		if (isMissing(value)) { return; }
+		const int found = find(value);
+		if (found >= 0) {
+			// 已存在：重数加一，沿路径子树计数加一
+			for (int t = m_root; t != found; t = value < m_nodes[t].value ? m_nodes[t].left : m_nodes[t].right) {
+				++m_nodes[t].size;
+			}
+			++m_nodes[found].count;
+			++m_nodes[found].size;
+			return;
+		}
+		m_root = insertNode(m_root, allocate(value));
+	}
+
+	// 删除一个键（重数减一；不存在或为 NaN 时返回 false）
+	bool erase(const Key& value) {
+		if (isMissing(value) || find(value) < 0) { return false; }
+		m_root = eraseNode(m_root, value);
+		return true;
+	}
+
+	// 元素总数（含重数）
+	size_t size() const { return static_cast<size_t>(sizeOf(m_root)); }
+	bool empty() const { return m_root < 0; }
+
+	// 严格小于 value 的元素个数
+	size_t countLess(const Key& value) const {
+		uint32_t result = 0;
+		int t = m_root;
+		while (t >= 0) {
+			const Node& node = m_nodes[t];
+			if (!(node.value < value)) {
+				t = node.left;
+			} else {
+				result += sizeOf(node.left) + node.count;
+				t = node.right;
+			}
+		}
+		return result;
+	}
+
+	// 等于 value 的元素个数
+	size_t count(const Key& value) const {
+		const int found = find(value);
+		return found >= 0 ? m_nodes[found].count : 0;
+	}
+
+	// 第 k 小的键（0 起，越界返回 NaN）
+	Key kth(size_t k) const {
+		int t = m_root;
+		while (t >= 0) {
+			const Node& node = m_nodes[t];
+			const size_t leftSize = sizeOf(node.left);
+			if (k < leftSize) {
+				t = node.left;
+			} else if (k < leftSize + node.count) {
+				return node.value;
+			} else {
+				k -= leftSize + node.count;
+				t = node.right;
+			}
+		}
+		return missingKey();
+	}
+
+	// 按升序访问 [lower, upper) 内的键：visitor(键, 重数)，O(log W + 命中个数)
+	template<typename Visitor>
+	void forEachInRange(const Key& lower, const Key& upper, Visitor&& visitor) const {
+		visitRange(m_root, lower, upper, visitor);
+	}
+
+private:
+	struct Node {
+		Key value;
+		uint32_t count;    // 重数
+		uint32_t size;     // 子树元素总数（含重数）
+		uint32_t priority; // 堆序优先级
+		int left;
+		int right;
+	};
+
+	uint32_t sizeOf(int t) const { return t >= 0 ? m_nodes[t].size : 0; }
+	void pull(int t) { m_nodes[t].size = sizeOf(m_nodes[t].left) + sizeOf(m_nodes[t].right) + m_nodes[t].count; }
+
+	static bool isMissing(double value) { return std::isnan(value); }
+	template<typename Tag>
+	static bool isMissing(const std::pair<double, Tag>& value) { return std::isnan(value.first); }
+	static double missing(const double*) { return std::numeric_limits<double>::quiet_NaN(); }
+	template<typename Tag>
+	static std::pair<double, Tag> missing(const std::pair<double, Tag>*) { return {std::numeric_limits<double>::quiet_NaN(), Tag{}}; }
+	static Key missingKey() { return missing(static_cast<const Key*>(nullptr)); }
+
+	template<typename Visitor>
+	void visitRange(int t, const Key& lower, const Key& upper, Visitor& visitor) const {
+		if (t < 0) { return; }
+		const Node& node = m_nodes[t];
+		const bool aboveLower = !(node.value < lower);
+		const bool belowUpper = node.value < upper;
+		if (aboveLower) { visitRange(node.left, lower, upper, visitor); }
+		if (aboveLower && belowUpper) { visitor(node.value, node.count); }
+		if (belowUpper) { visitRange(node.right, lower, upper, visitor); }
+	}
+
+	int find(const Key& value) const {
+		int t = m_root;
+		while (t >= 0 && m_nodes[t].value != value) {
+			t = value < m_nodes[t].value ? m_nodes[t].left : m_nodes[t].right;
+		}
+		return t;
+	}
+
+	// xorshift32：确定性的优先级序列
+	uint32_t nextPriority() {
+		m_seed ^= m_seed << 13;
+		m_seed ^= m_seed >> 17;
+		m_seed ^= m_seed << 5;
+		return m_seed;
+	}
+
+	int allocate(const Key& value) {
+		const Node node{value, 1, 1, nextPriority(), -1, -1};
+		if (!m_free.empty()) {
+			const int t = m_free.back();
+			m_free.pop_back();
+			m_nodes[t] = node;
+			return t;
+		}
+		m_nodes.push_back(node);
+		return static_cast<int>(m_nodes.size()) - 1;
+	}
+
+	// 按值拆分：left 中全部小于 value，right 中全部大于等于 value
+	void split(int t, const Key& value, int& left, int& right) {
+		if (t < 0) { left = right = -1; return; }
+		if (m_nodes[t].value < value) {
+			split(m_nodes[t].right, value, m_nodes[t].right, right);
+			left = t;
+		} else {
+			split(m_nodes[t].left, value, left, m_nodes[t].left);
+			right = t;
+		}
+		pull(t);
+	}
+
+	// 合并：left 中全部小于 right
+	int merge(int left, int right) {
+		if (left < 0) { return right; }
+		if (right < 0) { return left; }
+		if (m_nodes[left].priority > m_nodes[right].priority) {
+			m_nodes[left].right = merge(m_nodes[left].right, right);
+			pull(left);
+			return left;
+		}
+		m_nodes[right].left = merge(left, m_nodes[right].left);
+		pull(right);
+		return right;
+	}
+
+	// 插入新节点（值不在树中）
+	int insertNode(int t, int node) {
+		if (t < 0) { return node; }
+		if (m_nodes[node].priority > m_nodes[t].priority) {
+			split(t, m_nodes[node].value, m_nodes[node].left, m_nodes[node].right);
+			pull(node);
+			return node;
+		}
+		if (m_nodes[node].value < m_nodes[t].value) {
+			m_nodes[t].left = insertNode(m_nodes[t].left, node);
+		} else {
+			m_nodes[t].right = insertNode(m_nodes[t].right, node);
+		}
+		pull(t);
+		return t;
+	}
+
+	// 删除一个值（值在树中）
+	int eraseNode(int t, const Key& value) {
+		if (m_nodes[t].value == value) {
+			if (m_nodes[t].count > 1) {
+				--m_nodes[t].count;
+				--m_nodes[t].size;
+				return t;
+			}
+			const int merged = merge(m_nodes[t].left, m_nodes[t].right);
+			m_free.push_back(t);
+			return merged;
+		}
+		if (value < m_nodes[t].value) {
+			m_nodes[t].left = eraseNode(m_nodes[t].left, value);
+		} else {
+			m_nodes[t].right = eraseNode(m_nodes[t].right, value);
+		}
+		--m_nodes[t].size;
+		return t;
+	}
+
+	std::vector<Node> m_nodes; // 节点池
+	std::vector<int> m_free;   // 空闲节点
+	int m_root{-1};
+	uint32_t m_seed{2463534242u};
+};
+
+} // namespace EigenExtra
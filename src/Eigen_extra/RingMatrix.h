@@ -0,0 +1,114 @@
+#pragma once
+#include "Eigen_extra.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace EigenExtra {
+
+// 固定容量的 T×N 滚动窗口矩阵（时间×股票），全体股票共用一个行主序环形存储
+// 追加一个时间行为 O(N) 的连续写入，不搬动已有数据；按逻辑顺序（最旧 -> 最新）访问行、列与分段视图
+// 物理行数为容量 + 1：新行总是写入空闲行，被挤出的最旧行随即成为下一个空闲行，
+// 因此 pushRow 返回的被挤出行是缓冲内的零拷贝视图，在下一次 pushRow/assign/resize 之前有效
+class RingMatrix {
+public:
+	using RowMa = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+	// 一行（全体股票同一时刻），物理连续
+	using RowView = Eigen::Map<const Eigen::RowVectorXd>;
+	// 一列（单只股票的一段时间序列），行主序下步长为列数
+	using ColumnView = Eigen::Map<const Ve, 0, Eigen::InnerStride<>>;
+	// 连续若干行（整块参与 GEMV 等运算）
+	using BlockView = Eigen::Map<const RowMa>;
+	using RowRef = Eigen::Ref<const Eigen::RowVectorXd, 0, Eigen::InnerStride<>>;
+
+	RingMatrix() = default;
+	RingMatrix(int capacity, int cols) { resize(capacity, cols); }
+
+	// 设置容量（窗口行数）与列数（股票数）并清空
+	void resize(int capacity, int cols) {
+		if (capacity < 0 || cols < 0) { throw std::invalid_argument("RingMatrix::resize capacity/cols < 0"); }
+		m_capacity = capacity;
+		m_buf.setZero(capacity + 1, cols);
+		clear();
+	}
+	void clear() {
+		m_oldest = 0;
+		m_size = 0;
+	}
+
+	int capacity() const { return m_capacity; }
+	int cols() const { return static_cast<int>(m_buf.cols()); }
+	// 当前有效行数
+	int rows() const { return m_size; }
+	bool full() const { return m_size == m_capacity && m_capacity > 0; }
+	bool empty() const { return m_size == 0; }
+
+	// 追加一行（长度为列数）；窗口已满时返回被挤出的最旧行，否则返回空视图
+	RowView pushRow(const RowRef& row) {
+		if (m_capacity == 0) { return RowView(nullptr, 0); }
+		const int physicalRows = static_cast<int>(m_buf.rows());
+		int head = m_oldest + m_size;
+		if (head >= physicalRows) { head -= physicalRows; }
+		m_buf.row(head) = row;
+		if (m_size < m_capacity) {
+			m_size += 1;
+			return RowView(nullptr, 0);
+		}
+		const int evicted = m_oldest;
+		m_oldest = (m_oldest + 1 == physicalRows) ? 0 : m_oldest + 1;
+		return RowView(m_buf.row(evicted).data(), m_buf.cols());
+	}
+	// 用矩阵（逻辑顺序，行数不超过容量、列数一致）整体重置内容
+	void assign(const Eigen::Ref<const Ma>& values) {
+		if (values.rows() > m_capacity || values.cols() != m_buf.cols()) {
+			throw std::invalid_argument("RingMatrix::assign size mismatch with capacity/cols");
+		}
+		m_buf.topRows(values.rows()) = values;
+		m_oldest = 0;
+		m_size = static_cast<int>(values.rows());
+	}
+
+	// 访问：从最旧行起第 logicalRow 行、第 col 列（热路径，不做越界检查）
+	double operator()(int logicalRow, int col) const { return m_buf(physicalRow(logicalRow), col); }
+	// 从最旧行起第 logicalRow 行（零拷贝，热路径，不做越界检查）
+	RowView row(int logicalRow) const { return RowView(m_buf.row(physicalRow(logicalRow)).data(), m_buf.cols()); }
+	// 从最旧行起第 logicalRow 行（越界抛异常）
+	RowView rowAt(int logicalRow) const {
+		if (logicalRow < 0 || logicalRow >= m_size) { throw std::out_of_range("RingMatrix::rowAt index out of range"); }
+		return row(logicalRow);
+	}
+
+	// 分段视图（零拷贝）：两段依次覆盖“最旧 -> 最新”的逻辑顺序，未环回时第二段行数为 0
+	BlockView firstBlock() const { return BlockView(m_buf.row(m_oldest).data(), firstRows(), m_buf.cols()); }
+	BlockView secondBlock() const { return BlockView(m_buf.data(), m_size - firstRows(), m_buf.cols()); }
+	// 单只股票的分段列视图（零拷贝，两段拼接即该股票窗口内的逻辑顺序序列）
+	ColumnView firstColumnSegment(int col) const {
+		return ColumnView(m_buf.data() + static_cast<Eigen::Index>(m_oldest) * m_buf.cols() + col, firstRows(), Eigen::InnerStride<>(m_buf.cols()));
+	}
+	ColumnView secondColumnSegment(int col) const {
+		return ColumnView(m_buf.data() + col, m_size - firstRows(), Eigen::InnerStride<>(m_buf.cols()));
+	}
+	// 单只股票的窗口序列（逻辑顺序，有一次拷贝）
+	Ve column(int col) const {
+		Ve out(m_size);
+		const int first = firstRows();
+		out.head(first) = firstColumnSegment(col);
+		out.tail(m_size - first) = secondColumnSegment(col);
+		return out;
+	}
+
+private:
+	int physicalRow(int logicalRow) const {
+		const int physicalRows = static_cast<int>(m_buf.rows());
+		const int pos = m_oldest + logicalRow;
+		return pos >= physicalRows ? pos - physicalRows : pos;
+	}
+	// 第一段（最旧行到物理末尾）的行数
+	int firstRows() const { return std::min(m_size, static_cast<int>(m_buf.rows()) - m_oldest); }
+
+	RowMa m_buf;        // 行主序存储，行数为容量 + 1
+	int m_capacity{0};  // 容量（窗口行数）
+	int m_oldest{0};    // 最旧行的物理行号
+	int m_size{0};      // 当前有效行数
+};
+
+} // namespace EigenExtra
@@ -1,102 +1,166 @@
 #include "RingVec.h"
 #include <stdexcept>
+#include <algorithm>
 
 namespace EigenExtra {
 
-void RingVec::resize(int capacity) {
+namespace {
+
+// 不小于 capacity 的最小 2 的幂（capacity 为 0 时返回 0）
+int physicalSizeFor(int capacity) {
+	int size = capacity > 0 ? 1 : 0;
+	while (size < capacity) { size <<= 1; }
+	return size;
+}
+
+} // namespace
+
+template <typename T>
+void RingVec<T>::resize(int capacity) {
 	if (capacity < 0) { throw std::invalid_argument("RingVec::resize capacity < 0"); }
+	const int physicalSize = physicalSizeFor(capacity);
 	m_capacity = capacity;
-	m_buf.assign(static_cast<size_t>(m_capacity), 0.0);
+	m_buf.assign(static_cast<size_t>(physicalSize), T{});
+	m_evicted.clear();
+	m_mask = physicalSize > 0 ? static_cast<unsigned>(physicalSize - 1) : 0u;
 	m_size = 0;
 	m_head = 0;
 }
 
-void RingVec::clear() {
-	if (m_capacity > 0) { std::fill(m_buf.begin(), m_buf.end(), 0.0); }
+template <typename T>
+void RingVec<T>::clear() {
+	std::fill(m_buf.begin(), m_buf.end(), T{});
 	m_size = 0;
 	m_head = 0;
 }
 
-double RingVec::pushPop(double newValue) {
-	double old = 0.0;
+template <typename T>
+T RingVec<T>::pushPop(T newValue) {
+	T old{};
 	if (m_capacity == 0) { return old; }
-	if (full()) {
-		old = m_buf[static_cast<size_t>(m_head)];
+	if (m_size == m_capacity) {
+		// 满：最旧元素在 m_head 之前 capacity 个位置（物理长度等于容量时即 m_head 本身）
+		old = m_buf[static_cast<size_t>(static_cast<unsigned>(m_head - m_capacity) & m_mask)];
+	} else {
+		m_size += 1;
 	}
 	m_buf[static_cast<size_t>(m_head)] = newValue;
-	m_head += 1;
-	if (m_head == m_capacity) { m_head = 0; }
-	if (m_size < m_capacity) { m_size += 1; }
+	m_head = static_cast<int>(static_cast<unsigned>(m_head + 1) & m_mask);
 	return old;
 }
 
-int RingVec::logicalToPhysical(int logicalIndex) const {
+template <typename T>
+typename RingVec<T>::Evicted RingVec<T>::pushPopN(const T* values, int count) {
+	if (m_capacity == 0 || count <= 0) { return Evicted{{nullptr, 0}, {nullptr, 0}}; }
+	// 只有最后 kept 个新值留在窗口中，之前的 passed 个写入即被挤出
+	const int kept = std::min(count, m_capacity);
+	const int passed = count - kept;
+	const int evictedOld = std::max(0, m_size + kept - m_capacity);
+	if (evictedOld > 0) {
+		if (static_cast<int>(m_evicted.size()) < m_capacity) {
+			m_evicted.resize(static_cast<size_t>(m_capacity));
+		}
+		// 先拷出被挤出的旧值（物理长度等于容量时写入位置与其重叠）
+		copyOut(0, evictedOld, m_evicted.data());
+	}
+	copyIn(values + passed, kept);
+	m_head = static_cast<int>(static_cast<unsigned>(m_head + kept) & m_mask);
+	m_size = std::min(m_capacity, m_size + kept);
+	return Evicted{{m_evicted.data(), evictedOld}, {values, passed}};
+}
+
+template <typename T>
+T RingVec<T>::popFront() {
+	if (m_size == 0) { throw std::out_of_range("RingVec::popFront empty buffer"); }
+	const T value = m_buf[static_cast<size_t>(oldest())];
+	m_size -= 1;
+	return value;
+}
+
+template <typename T>
+void RingVec<T>::reserve(int capacity) {
+	if (capacity <= m_capacity) { return; }
+	const int physicalSize = physicalSizeFor(capacity);
+	if (physicalSize > static_cast<int>(m_buf.size())) {
+		// 按逻辑顺序搬到新缓冲的开头，下一次写入位置紧随其后
+		std::pmr::vector<T> buffer(static_cast<size_t>(physicalSize), T{}, m_buf.get_allocator());
+		copyOut(0, m_size, buffer.data());
+		m_buf.swap(buffer);
+		m_mask = static_cast<unsigned>(physicalSize - 1);
+		m_head = m_size;
+	}
+	// 物理长度足够时只放宽逻辑容量，现有排布不变
+	m_capacity = capacity;
+}
+
+template <typename T>
+int RingVec<T>::logicalToPhysical(int logicalIndex) const {
 	if (logicalIndex < 0 || logicalIndex >= m_size) { throw std::out_of_range("RingVec::at index out of range"); }
-	// 最旧元素的物理索引：m_head == size 时下一个写入位置，因此最旧在 (m_head - m_size + capacity) % capacity
-	int oldest = m_head - m_size;
-	if (oldest < 0) { oldest += m_capacity; }
-	int pos = oldest + logicalIndex;
-	if (pos >= m_capacity) { pos -= m_capacity; }
-	return pos;
+	return static_cast<int>(static_cast<unsigned>(m_head - m_size + logicalIndex) & m_mask);
 }
 
-double RingVec::at(int logicalIndex) const {
+template <typename T>
+T RingVec<T>::at(int logicalIndex) const {
 	if (m_capacity == 0) { throw std::out_of_range("RingVec::at empty buffer"); }
 	return m_buf[static_cast<size_t>(logicalToPhysical(logicalIndex))];
 }
 
-Ve RingVec::toVe() const {
-	Ve out;
-	out.resize(m_size);
-	if (m_size == 0) { return out; }
-	// 逻辑顺序：最旧 -> 最新
-	int oldest = m_head - m_size;
-	if (oldest < 0) { oldest += m_capacity; }
-	const int firstBlock = std::min(m_size, m_capacity - oldest);
-	if (firstBlock > 0) {
-		Eigen::Map<const Ve> block1(&m_buf[static_cast<size_t>(oldest)], firstBlock);
-		out.segment(0, firstBlock) = block1;
-	}
-	const int remain = m_size - firstBlock;
-	if (remain > 0) {
-		Eigen::Map<const Ve> block2(m_buf.data(), remain);
-		out.segment(firstBlock, remain) = block2;
-	}
+template <typename T>
+typename RingVec<T>::Vector RingVec<T>::toVe() const {
+	Vector out(m_size);
+	copyOut(0, m_size, out.data());
 	return out;
 }
 
-void RingVec::assignFromVe(const Ve& sourceVector) {
+template <typename T>
+void RingVec<T>::assignFromVe(const Vector& sourceVector) {
 	if (sourceVector.size() != m_capacity) {
 		throw std::invalid_argument("RingVec::assignFromVe size mismatch with capacity");
 	}
 	if (m_capacity == 0) { return; }
 	// 直接写入为满缓冲，逻辑顺序即 sourceVector 的顺序
-	m_buf.resize(static_cast<size_t>(m_capacity));
-	Eigen::Map<const Ve> src(sourceVector.data(), m_capacity);
-	std::copy(src.data(), src.data() + m_capacity, m_buf.data());
+	std::copy(sourceVector.data(), sourceVector.data() + m_capacity, m_buf.data());
 	m_size = m_capacity;
-	m_head = 0; // 下次写入覆盖最旧：source 的第 0 个
+	m_head = static_cast<int>(static_cast<unsigned>(m_capacity) & m_mask); // 下次写入紧随 source 的最后一个
 }
 
-std::pair<const double*, int> RingVec::firstSegment() const {
+template <typename T>
+typename RingVec<T>::Span RingVec<T>::firstSegment() const {
 	if (m_size == 0) { return {nullptr, 0}; }
-	int oldest = m_head - m_size;
-	if (oldest < 0) { oldest += m_capacity; }
-	const int firstBlock = std::min(m_size, m_capacity - oldest);
-	return { &m_buf[static_cast<size_t>(oldest)], firstBlock };
+	const int begin = oldest();
+	const int firstBlock = std::min(m_size, static_cast<int>(m_buf.size()) - begin);
+	return { &m_buf[static_cast<size_t>(begin)], firstBlock };
 }
 
-std::pair<const double*, int> RingVec::secondSegment() const {
+template <typename T>
+typename RingVec<T>::Span RingVec<T>::secondSegment() const {
 	if (m_size == 0) { return {nullptr, 0}; }
-	int oldest = m_head - m_size;
-	if (oldest < 0) { oldest += m_capacity; }
-	const int firstBlock = std::min(m_size, m_capacity - oldest);
+	const int firstBlock = std::min(m_size, static_cast<int>(m_buf.size()) - oldest());
 	const int remain = m_size - firstBlock;
 	if (remain <= 0) { return {nullptr, 0}; }
 	return { m_buf.data(), remain };
 }
 
-} // namespace EigenExtra
+template <typename T>
+void RingVec<T>::copyOut(int logicalBegin, int count, T* destination) const {
+	if (count <= 0) { return; }
+	const int begin = static_cast<int>(static_cast<unsigned>(m_head - m_size + logicalBegin) & m_mask);
+	const int firstBlock = std::min(count, static_cast<int>(m_buf.size()) - begin);
+	std::copy(m_buf.data() + begin, m_buf.data() + begin + firstBlock, destination);
+	std::copy(m_buf.data(), m_buf.data() + (count - firstBlock), destination + firstBlock);
+}
 
+template <typename T>
+void RingVec<T>::copyIn(const T* source, int count) {
+	if (count <= 0) { return; }
+	const int firstBlock = std::min(count, static_cast<int>(m_buf.size()) - m_head);
+	std::copy(source, source + firstBlock, m_buf.data() + m_head);
+	std::copy(source + firstBlock, source + count, m_buf.data());
+}
 
+template class RingVec<double>;
+template class RingVec<float>;
+template class RingVec<int32_t>;
+template class RingVec<uint8_t>;
 
+} // namespace EigenExtra
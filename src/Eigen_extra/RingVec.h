@@ -1,60 +1,103 @@
 #pragma once
 #include "Eigen_extra.h"
 #include <vector>
+#include <memory_resource>
 #include <utility>
 #include <iterator>
+#include <cstdint>
 
 namespace EigenExtra {
 
-// 固定容量环形缓冲，存放标量序列，底层使用连续内存（Ve）
+// 固定容量环形缓冲，存放标量序列，底层使用连续内存
+// 元素类型 T 支持 double / float / int32_t / uint8_t（成员定义在 RingVec.cpp 中按这四种类型显式实例化）
+// 物理存储长度取不小于容量的 2 的幂，逻辑下标到物理下标按位与掩码映射（无分支）；
+// 逻辑容量（窗口长度）仍为 resize 指定的值，满/挤出均按逻辑容量判断
+template <typename T>
 class RingVec {
 public:
+	using value_type = T;
+	using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+	using ConstMap = Eigen::Map<const Vector>;
+	// 物理连续的一段：(起始指针, 长度)
+	using Span = std::pair<const T*, int>;
+
+	// 批量写入时被挤出的旧值（逻辑顺序：最旧 -> 最新，first 在前、second 在后）
+	struct Evicted {
+		Span first;   // 环中原有的元素（已暂存到移出缓冲，下次 pushPopN 前有效）
+		Span second;  // 本批写入即被挤出的新值（批量长度超过容量时非空，指向调用方传入的 values）
+		int size() const { return first.second + second.second; }
+	};
+
 	RingVec() = default;
 	explicit RingVec(int capacity) { resize(capacity); }
+	// 指定底层缓冲的内存资源（如节点内存池），之后 resize/reserve/pushPopN 均从该资源分配；拷贝出的副本使用默认堆
+	explicit RingVec(std::pmr::memory_resource* resource) : m_buf(resource), m_evicted(resource) {}
 
 	void resize(int capacity);
 	void clear();
 
 	int capacity() const { return m_capacity; }
+	// 物理存储长度（不小于容量的 2 的幂）
+	int physicalCapacity() const { return static_cast<int>(m_buf.size()); }
 	int size() const { return m_size; }
 	bool full() const { return m_size == m_capacity && m_capacity > 0; }
 	bool empty() const { return m_size == 0; }
 
-	// 头删尾添：写入 newValue，若满则返回被覆盖的旧值，否则返回 0.0
-	double pushPop(double newValue);
+	// 头删尾添：写入 newValue，若满则返回被覆盖的旧值，否则返回 T{}
+	T pushPop(T newValue);
+	// 批量头删尾添：依次写入 values[0..count)，返回被挤出的值（未满时只挤出超出容量的部分）
+	// 旧值整段拷贝到移出缓冲（首次挤出时按容量分配一次），新值整段写入，不逐个取模
+	Evicted pushPopN(const T* values, int count);
+	// 头删：移出并返回最旧元素（须非空）
+	T popFront();
+	// 扩容并保留内容（逻辑顺序不变），容量不小于当前时不做任何事
+	void reserve(int capacity);
 
 	// 访问：从最旧元素起第 logicalIndex 个（0<=logicalIndex<size）
-	double at(int logicalIndex) const;
+	T at(int logicalIndex) const;
+	// 访问（热路径，不做越界检查）：从最旧元素起第 logicalIndex 个
+	T operator[](int logicalIndex) const {
+		return m_buf[static_cast<size_t>(static_cast<unsigned>(m_head - m_size + logicalIndex) & m_mask)];
+	}
 
 	// 直接访问底层缓冲（物理顺序），仅供需要时使用
-	const std::vector<double>& rawBuffer() const { return m_buf; }
+	const std::pmr::vector<T>& rawBuffer() const { return m_buf; }
 
 	// 分段视图（零拷贝）：
 	// 若未环回：firstSegment 覆盖全部数据，secondSegment 长度为 0；
 	// 若已环回：两段依次覆盖“最旧 -> 最新”的逻辑顺序。
-	std::pair<const double*, int> firstSegment() const;
-	std::pair<const double*, int> secondSegment() const;
+	Span firstSegment() const;
+	Span secondSegment() const;
+	// 分段视图的 Eigen 映射（零拷贝，两段上的归约相加即整窗归约）
+	ConstMap firstSegmentMap() const {
+		const Span segment = firstSegment();
+		return ConstMap(segment.first, segment.second);
+	}
+	ConstMap secondSegmentMap() const {
+		const Span segment = secondSegment();
+		return ConstMap(segment.first, segment.second);
+	}
 
-	// 转为 Eigen 向量（逻辑顺序：最旧 -> 最新）。会产生一次拷贝，适合参与 Ve 运算。
-	Ve toVe() const;
-	// 便捷隐式转换：允许在需要 Ve 的场景自动物化（注意有拷贝成本）。
-	operator Ve() const { return toVe(); }
+	// 转为 Eigen 向量（逻辑顺序：最旧 -> 最新）。会产生一次拷贝，适合参与 Ve 运算；只读归约优先用分段映射。
+	Vector toVe() const;
+	// 便捷隐式转换：允许在需要 Eigen 向量的场景自动物化（注意有拷贝成本）。
+	operator Vector() const { return toVe(); }
 	// 用 Eigen 向量（逻辑顺序）整体重置内容；容量需一致。
-	void assignFromVe(const Ve& sourceVector);
+	void assignFromVe(const Vector& sourceVector);
 
 	// 迭代器支持（范围 for 循环）
 	class const_iterator {
 	public:
 		using iterator_category = std::forward_iterator_tag;
-		using value_type = double;
+		using value_type = T;
 		using difference_type = int;
-		using pointer = const double*;
-		using reference = const double&;
+		using pointer = const T*;
+		using reference = const T&;
 
-		const_iterator(const RingVec* ring, int logicalIndex) 
+		const_iterator(const RingVec* ring, int logicalIndex)
 			: m_ring(ring), m_logicalIndex(logicalIndex) {}
 
-		const double& operator*() const {
+		const T& operator*() const {
 			// 直接访问底层缓冲，避免通过 at() 的按值返回
 			const int physicalIndex = m_ring->logicalToPhysical(m_logicalIndex);
 			return m_ring->m_buf[static_cast<size_t>(physicalIndex)];
@@ -93,15 +136,26 @@ public:
 	}
 
 private:
-	// 将逻辑索引 i（相对最旧）映射到物理索引
+	// 将逻辑索引 i（相对最旧）映射到物理索引（越界抛异常）
 	int logicalToPhysical(int logicalIndex) const;
-	std::vector<double> m_buf; // 容量固定的连续存储
-	int m_capacity{0}; // 容量（窗口长度）
-	int m_size{0};     // 当前有效元素数
-	int m_head{0};     // 下一次写入位置（物理索引）
+	// 最旧元素的物理索引
+	int oldest() const { return static_cast<int>(static_cast<unsigned>(m_head - m_size) & m_mask); }
+	// 按逻辑顺序拷出 [logicalBegin, logicalBegin + count) 到 destination（至多两段）
+	void copyOut(int logicalBegin, int count, T* destination) const;
+	// 从 m_head 起按物理顺序写入 count 个值（至多两段），不移动 m_head
+	void copyIn(const T* source, int count);
+
+	std::pmr::vector<T> m_buf;     // 连续存储，长度为 2 的幂
+	std::pmr::vector<T> m_evicted; // pushPopN 的移出缓冲（首次挤出时按容量分配）
+	int m_capacity{0};  // 容量（窗口长度）
+	int m_size{0};      // 当前有效元素数
+	int m_head{0};      // 下一次写入位置（物理索引）
+	unsigned m_mask{0}; // 物理存储长度 - 1
 };
 
-} // namespace EigenExtra
-
-
+extern template class RingVec<double>;
+extern template class RingVec<float>;
+extern template class RingVec<int32_t>;
+extern template class RingVec<uint8_t>;
 
+} // namespace EigenExtra
@@ -1,6 +1,7 @@
 #include "barra_cne5_1_beta.h"
 #include "../../Eigen_extra/RingVec.h"
 #include "../../Tool/profiler.h"
+#include "../../OnlineBaseFactor/OnlineCheckpoint.h"
 
 barra_cne5_1_beta::barra_cne5_1_beta(/* args */)
 {
@@ -23,6 +24,7 @@ int barra_cne5_1_beta::Init(const Ma& initRet, const Ma& initCap, const Ve& init
     //1.假设获取到了初始数据 假设三团数据是完全对齐的（暂时不做股票名字对齐）
     int lagWindow = initRet.rows();  // 从实际数据获取行数（时间窗口大小）
     int stocksNum = initRet.cols();  // 从实际数据获取列数（股票数量）
+    m_lagWindow = lagWindow;
     Ma ret = initRet;
     Ma cap = initCap;
     Ve valid = initValid;
@@ -47,54 +49,47 @@ int barra_cne5_1_beta::Init(const Ma& initRet, const Ma& initCap, const Ve& init
             marketRet[i] = ret.row(i).dot(cap.row(i)) / cap.row(i).sum();
         }
     }
-    //2.为每只股票构建beta值窗口
-    //2.1构建相关系数窗口
-    {
+    //2.为每只股票构建beta值窗口（节点取自节点内存池，按构建顺序连续排布，随因子释放）
+    m_arenas = OnlineArena::createChunks(m_threadPool ? m_threadPool->size() : 1);
+    if(m_useCrossSection){
+        //截面引擎：T×N窗口一次构建
+        PROFILE_SCOPE("Init::构建截面beta窗口");
+        m_crossSection = m_arenas[0]->create<OnlineCrossSection>(ret, marketRet);
+        computeBetaFromCrossSection();
+    } else {
+        //2.1构建相关系数窗口（图构建器自动去重：市场序列的缓存/求和/方差全体股票共享）
         PROFILE_SCOPE("Init::构建beta值窗口");
-        for(int i = 0; i < stocksNum; i++){
-            // 构造该股票与市场的相关系数所需组件（容器层 -> 方法层）
-            // 容器层
-            auto cacheX = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(ret.col(i));
-            auto cacheY = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(marketRet);
-            
-            // 方法层：求和和乘积和
-            auto sumX  = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(ret.col(i), OnlineSum::Window{cacheX});
-            auto sumY  = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(marketRet, OnlineSum::Window{cacheY});
-            auto prodXX = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(ret.col(i), ret.col(i), OnlineSumProduct::Window{cacheX, cacheX});
-            auto prodYY = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(marketRet, marketRet, OnlineSumProduct::Window{cacheY, cacheY});
-            auto prodXY = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(ret.col(i), marketRet, OnlineSumProduct::Window{cacheX, cacheY});
-
-            // 方法层：均值
-            auto meanX = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(ret.col(i), OnlineMean::Window{sumX});
-            auto meanY = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(marketRet, OnlineMean::Window{sumY});
-
-            // 方法层：方差
-            auto varX = OnlineBaseFactor::createOnlineBaseF<OnlineVar>(ret.col(i), OnlineVar::Window{prodXX, meanX});
-            auto varY = OnlineBaseFactor::createOnlineBaseF<OnlineVar>(marketRet, OnlineVar::Window{prodYY, meanY});
-
-            // 方法层：协方差
-            auto covXY = OnlineBaseFactor::createOnlineBaseF<OnlineCov>(ret.col(i), marketRet, OnlineCov::Window{prodXY, meanX, meanY});
-            
-            // 方法层：相关系数
-            auto correlation = OnlineBaseFactor::createOnlineBaseF<OnlineCorrelation>(OnlineCorrelation::Window{varX, varY, covXY});
-
-            // 应用层：Beta - 为每只股票保存独立的窗口
-            m_windows[i].m_onlineCorrelation = correlation;
-            m_windows[i].m_onlineVarX = varX;
-            m_windows[i].m_onlineVarY = varY;
-            // Beta公式：beta = corr * std(ret) / std(rm) = corr * sqrt(var(ret)) / sqrt(var(rm))
-            double corr = correlation->getValue();
-            double varX_val = varX->getValue();
-            double varY_val = varY->getValue();
-            if(std::isnan(corr) || std::isnan(varX_val) || std::isnan(varY_val) || varY_val <= 0.0){
-                m_value[i] = std::numeric_limits<double>::quiet_NaN();
-            } else {
-                double stdX = std::sqrt(varX_val);
-                double stdY = std::sqrt(varY_val);
-                double beta = corr * stdX / stdY;
-                m_value[i] = beta;
+        OnlineGraphBuilder builder(m_arenas[0]);
+        // 先串行构建第0只股票（同时建好市场序列的共享节点），其余股票逐块构建，块内按首只股票的用量一次预留
+        if(stocksNum > 0){
+            buildWindow(builder, 0, ret, marketRet);
+        }
+        if(m_threadPool && stocksNum > 1){
+            // 并行：各块使用各自的构建器分叉与内存池
+            std::vector<OnlineGraphBuilder> chunkBuilders;
+            for(const auto& arena : m_arenas){
+                chunkBuilders.push_back(builder.fork(arena));
+            }
+            m_threadPool->parallelFor(1, stocksNum, [&](size_t chunk, size_t begin, size_t end){
+                m_arenas[chunk]->buildUniform(begin, end, [&](size_t i){
+                    buildWindow(chunkBuilders[chunk], static_cast<int>(i), ret, marketRet);
+                });
+            });
+            for(const auto& chunkBuilder : chunkBuilders){
+                builder.mergeStats(chunkBuilder);
             }
+        } else {
+            m_arenas[0]->buildUniform(1, static_cast<size_t>(stocksNum), [&](size_t i){
+                buildWindow(builder, static_cast<int>(i), ret, marketRet);
+            });
         }
+        m_graphStats = builder.getStats();
+        m_onlineDataCacheY = builder.createDataCache("marketRet", marketRet);
+        //编译节点图：拓扑序执行序列（非编译模式下仅用于统计）
+        for(int i = 0; i < stocksNum; i++){
+            m_schedule.addRoot(m_windows[i].m_onlineCorrelation, i);
+        }
+        m_schedule.compile();
     }
     // 分位数缩尾
     {
@@ -144,27 +139,52 @@ void barra_cne5_1_beta::Update(const Ma& ret, const Ma& cap, const Ve& valid)
 
     //2.更新beta值窗口
     m_version++;
-    // 为每只股票更新相关系数
-    {
+    // 定期重锚：在本次增量更新前由缓存窗口精确重算
+    if(m_reformWindow > 0 && m_version % m_reformWindow == 0){
+        PROFILE_SCOPE("Update::重锚");
+        if(m_useCrossSection){
+            m_crossSection->reanchor();
+        } else {
+            m_schedule.reanchor();
+        }
+    }
+    if(m_useCrossSection){
+        //截面引擎：整行向量更新全体股票
+        PROFILE_SCOPE("Update::更新截面beta窗口");
+        m_crossSection->update(newRet, newMarketRet, m_version);
+        computeBetaFromCrossSection();
+    } else if(m_threadPool){
+        // 并行模式：共享节点（市场序列）串行更新，各股票独占节点按分块并行执行
+        PROFILE_SCOPE("Update::并行更新beta值窗口");
+        m_onlineDataCacheY->update(newMarketRet, m_version);
+        m_schedule.runShared(m_version);
+        m_threadPool->parallelFor(0, newRet.cols(), [&](size_t, size_t begin, size_t end){
+            for(size_t i = begin; i < end; i++){
+                m_windows[i].m_onlineDataCacheX->update(newRet.col(i), m_version);
+                m_schedule.runGroup(i, m_version);
+                computeBetaFromWindow(static_cast<int>(i));
+            }
+        });
+    } else if(m_useCompiledGraph){
+        // 编译模式：先更新缓存层，再按拓扑序执行一遍计算节点
+        PROFILE_SCOPE("Update::编译模式更新beta值窗口");
+        m_onlineDataCacheY->update(newMarketRet, m_version);
+        for(int i = 0; i < newRet.cols(); i++){
+            m_windows[i].m_onlineDataCacheX->update(newRet.col(i), m_version);
+        }
+        m_schedule.run(m_version);
+        for(int i = 0; i < newRet.cols(); i++){
+            computeBetaFromWindow(i);
+        }
+    } else {
+        // 为每只股票更新相关系数
         PROFILE_SCOPE("Update::更新beta值窗口");
         for(int i = 0; i < newRet.cols(); i++){
             // OnlineCorrelation::update内部会更新m_onlineVarX和m_onlineVarY
             m_windows[i].m_onlineCorrelation->update(newRet.col(i), newMarketRet, m_version);
             
             //3.计算beta值
-            double corr = m_windows[i].m_onlineCorrelation->getValue();
-            double varX = m_windows[i].m_onlineVarX->getValue();
-            double varY = m_windows[i].m_onlineVarY->getValue();
-            
-            // 检查除零和NaN情况
-            if(std::isnan(corr) || std::isnan(varX) || std::isnan(varY) || varY <= 0.0){
-                m_value[i] = std::numeric_limits<double>::quiet_NaN();
-            } else {
-                double stdX = std::sqrt(varX);
-                double stdY = std::sqrt(varY);
-                double beta = corr * stdX / stdY;
-                m_value[i] = beta;
-            }
+            computeBetaFromWindow(i);
         }
     }
     // 分位数缩尾
@@ -188,4 +208,114 @@ void barra_cne5_1_beta::Update(const Ma& ret, const Ma& cap, const Ve& valid)
         BaseFactor::nanstd(m_value, betaStd, true);
         m_value = (m_value.array() - betaMean) / betaStd;
     }
-}
\ No newline at end of file
+}
+
+void barra_cne5_1_beta::computeBetaFromCrossSection()
+{
+    const Ve& correlation = m_crossSection->getCorrelation();
+    const Ve& varX = m_crossSection->getVarX();
+    const double varY = m_crossSection->getVarY();
+    for(int i = 0; i < m_value.size(); i++){
+        // Beta公式：beta = corr * std(ret) / std(rm)
+        if(std::isnan(correlation[i]) || std::isnan(varX[i]) || std::isnan(varY) || varY <= 0.0){
+            m_value[i] = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            m_value[i] = correlation[i] * std::sqrt(varX[i]) / std::sqrt(varY);
+        }
+    }
+}
+
+void barra_cne5_1_beta::buildWindow(OnlineGraphBuilder& builder, int i, const Ma& ret, const Ve& marketRet)
+{
+    // 构造该股票与市场的相关系数所需组件（容器层 -> 方法层）
+    // 容器层
+    auto cacheX = builder.createDataCache("ret#" + std::to_string(i), ret.col(i));
+    auto cacheY = builder.createDataCache("marketRet", marketRet);
+    
+    // 方法层：求和和乘积和
+    auto sumX  = builder.create<OnlineSum>(ret.col(i), OnlineSum::Window{cacheX});
+    auto sumY  = builder.create<OnlineSum>(marketRet, OnlineSum::Window{cacheY});
+    auto prodXX = builder.create<OnlineSumProduct>(ret.col(i), ret.col(i), OnlineSumProduct::Window{cacheX, cacheX});
+    auto prodYY = builder.create<OnlineSumProduct>(marketRet, marketRet, OnlineSumProduct::Window{cacheY, cacheY});
+    auto prodXY = builder.create<OnlineSumProduct>(ret.col(i), marketRet, OnlineSumProduct::Window{cacheX, cacheY});
+
+    // 方法层：均值
+    auto meanX = builder.create<OnlineMean>(ret.col(i), OnlineMean::Window{sumX});
+    auto meanY = builder.create<OnlineMean>(marketRet, OnlineMean::Window{sumY});
+
+    // 方法层：方差
+    auto varX = builder.create<OnlineVar>(ret.col(i), OnlineVar::Window{prodXX, meanX});
+    auto varY = builder.create<OnlineVar>(marketRet, OnlineVar::Window{prodYY, meanY});
+
+    // 方法层：协方差
+    auto covXY = builder.create<OnlineCov>(ret.col(i), marketRet, OnlineCov::Window{prodXY, meanX, meanY});
+    
+    // 方法层：相关系数
+    auto correlation = builder.create<OnlineCorrelation>(OnlineCorrelation::Window{varX, varY, covXY});
+
+    // 应用层：Beta - 为每只股票保存独立的窗口
+    m_windows[i].m_onlineDataCacheX = cacheX;
+    m_windows[i].m_onlineCorrelation = correlation;
+    m_windows[i].m_onlineVarX = varX;
+    m_windows[i].m_onlineVarY = varY;
+    computeBetaFromWindow(i);
+}
+
+void barra_cne5_1_beta::computeBetaFromWindow(int i)
+{
+    // Beta公式：beta = corr * std(ret) / std(rm) = corr * sqrt(var(ret)) / sqrt(var(rm))
+    const double corr = m_windows[i].m_onlineCorrelation->getValue();
+    const double varX = m_windows[i].m_onlineVarX->getValue();
+    const double varY = m_windows[i].m_onlineVarY->getValue();
+    // 检查除零和NaN情况
+    if(std::isnan(corr) || std::isnan(varX) || std::isnan(varY) || varY <= 0.0){
+        m_value[i] = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        m_value[i] = corr * std::sqrt(varX) / std::sqrt(varY);
+    }
+}
+
+int barra_cne5_1_beta::SaveCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Save);
+    // 头部：节点图形状（恢复时据此重建）
+    archive.tag("barra_cne5_1_beta");
+    int stocksNum = static_cast<int>(m_value.size());
+    archive(m_lagWindow, stocksNum, m_useCrossSection);
+    checkpointState(archive);
+    return archive.saveToFile(path) ? 0 : -1;
+}
+
+int barra_cne5_1_beta::RestoreCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Restore);
+    if(!archive.loadFromFile(path)){
+        return -1;
+    }
+    archive.tag("barra_cne5_1_beta");
+    int lagWindow = 0;
+    int stocksNum = 0;
+    bool useCrossSection = false;
+    archive(lagWindow, stocksNum, useCrossSection);
+    // 截面引擎与逐股票节点图的状态布局不同，按快照的模式重建
+    m_useCrossSection = useCrossSection;
+    // 占位数据只决定节点图形状，各节点状态随后由快照整体覆盖
+    Init(Ma::Zero(lagWindow, stocksNum), Ma::Ones(lagWindow, stocksNum), Ve::Ones(stocksNum));
+    checkpointState(archive);
+    if(!archive.atEnd()){
+        std::cout << "barra_cne5_1_beta: 快照内容与节点图不一致（存在未读取的数据）" << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+void barra_cne5_1_beta::checkpointState(OnlineCheckpoint& archive)
+{
+    if(m_useCrossSection){
+        m_crossSection->checkpoint(archive);
+    } else {
+        // 节点图按编译顺序逐节点读写（去重后的共享节点只出现一次）
+        m_schedule.checkpoint(archive);
+    }
+    archive(m_value, m_version);
+}
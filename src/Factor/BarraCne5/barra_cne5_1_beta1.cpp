@@ -1,6 +1,7 @@
 #include "barra_cne5_1_beta1.h"
 #include "../../Eigen_extra/RingVec.h"
 #include "../../Tool/profiler.h"
+#include "../../OnlineBaseFactor/OnlineCheckpoint.h"
 
 barra_cne5_1_beta1::barra_cne5_1_beta1(/* args */)
 {
@@ -23,6 +24,7 @@ int barra_cne5_1_beta1::Init(const Ma& initRet, const Ma& initCap, const Ve& ini
     //1.假设获取到了初始数据 假设三团数据是完全对齐的（暂时不做股票名字对齐）
     int lagWindow = initRet.rows();  // 从实际数据获取行数（时间窗口大小）
     int stocksNum = initRet.cols();  // 从实际数据获取列数（股票数量）
+    m_lagWindow = lagWindow;
     Ma ret = initRet / 100;
     Ma cap = initCap;
     Ve valid = initValid;
@@ -75,56 +77,51 @@ int barra_cne5_1_beta1::Init(const Ma& initRet, const Ma& initCap, const Ve& ini
     // std::cout << std::endl;
     // std::cout << "================================================" << std::endl;
 
-    auto weightCache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(ewmWeightsVec);
-    
-    //3.为每只股票构建beta值窗口
-    {
-        PROFILE_SCOPE("Init::构建beta值窗口");
-        for(int i = 0; i < stocksNum; i++){
-            // 构造该股票的EWM协方差和方差所需组件
-            // 容器层
-            auto cacheX = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(ret.col(i));
-            auto cacheY = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(marketRet);
-            
-            // 方法层：EWM求和
-            auto sumX = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheX});
-            auto sumY = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheY});
-            
-            // 方法层：EWM均值
-            auto meanX = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sumX});
-            auto meanY = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sumY});
-            
-            // 方法层：EWM乘积和（用于方差和协方差）
-            auto prodXX = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(
-                                                                                      OnlineEWMSumProduct::Window{weightCache, cacheX, cacheX});
-            auto prodXY = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(
-                                                                                      OnlineEWMSumProduct::Window{weightCache, cacheX, cacheY});
-            
-            // 方法层：EWM方差和协方差
-            auto varX = OnlineBaseFactor::createOnlineBaseF<OnlineEWMVar>(
-                                                                             OnlineEWMVar::Window{weightCache, meanX, prodXX});
-            auto covXY = OnlineBaseFactor::createOnlineBaseF<OnlineEWMCov>(
-                                                                             OnlineEWMCov::Window{weightCache, prodXY, meanX, meanY});
-            
-            // 应用层：Beta - 为每只股票保存独立的窗口
-            m_windows[i].m_onlineEWMVarX = varX;
-            m_windows[i].m_onlineEWMCovXY = covXY;
-            
-            // Beta公式：beta = cov / var
-            double cov = covXY->getValue();
-            double var = varX->getValue();
+    // 节点取自节点内存池，按构建顺序连续排布，随因子释放
+    m_arenas = OnlineArena::createChunks(m_threadPool ? m_threadPool->size() : 1);
+    if(m_useCrossSection){
+        //3.截面引擎：T×N窗口一次构建，带权和按两段GEMV求得
+        PROFILE_SCOPE("Init::构建截面beta窗口");
+        m_crossSection = m_arenas[0]->create<OnlineCrossSectionEWM>(ret, marketRet, ewmWeightsVec);
+        computeBetaFromCrossSection();
+    } else {
+        // 图构建器自动去重：市场序列的缓存/求和/均值全体股票共享
+        OnlineGraphBuilder builder(m_arenas[0]);
+        auto weightCache = builder.createWeightCache("ewm_halflife", ewmWeightsVec);
 
-            if(std::isnan(cov) || std::isnan(var) || var <= 0.0){
-                m_value[i] = std::numeric_limits<double>::quiet_NaN();
-            } else {
-                m_value[i] = cov / var;
+        //3.为每只股票构建beta值窗口
+        PROFILE_SCOPE("Init::构建beta值窗口");
+        // 先串行构建第0只股票（同时建好市场序列的共享节点），其余股票逐块构建，块内按首只股票的用量一次预留
+        if(stocksNum > 0){
+            buildWindow(builder, weightCache, 0, ret, marketRet);
+        }
+        if(m_threadPool && stocksNum > 1){
+            // 并行：各块使用各自的构建器分叉与内存池
+            std::vector<OnlineGraphBuilder> chunkBuilders;
+            for(const auto& arena : m_arenas){
+                chunkBuilders.push_back(builder.fork(arena));
             }
-            // debug
-            // std::cout << "cov = " << cov << std::endl;
-            // std::cout << "var = " << var << std::endl;
-            // std::cout << "beta = " << m_value[i] << std::endl;
-            // std::cout << "================================================" << std::endl;
+            m_threadPool->parallelFor(1, stocksNum, [&](size_t chunk, size_t begin, size_t end){
+                m_arenas[chunk]->buildUniform(begin, end, [&](size_t i){
+                    buildWindow(chunkBuilders[chunk], weightCache, static_cast<int>(i), ret, marketRet);
+                });
+            });
+            for(const auto& chunkBuilder : chunkBuilders){
+                builder.mergeStats(chunkBuilder);
+            }
+        } else {
+            m_arenas[0]->buildUniform(1, static_cast<size_t>(stocksNum), [&](size_t i){
+                buildWindow(builder, weightCache, static_cast<int>(i), ret, marketRet);
+            });
+        }
+        m_graphStats = builder.getStats();
+        m_onlineDataCacheY = builder.createDataCache("marketRet", marketRet);
+        //编译节点图：按股票分组的拓扑序执行序列
+        for(int i = 0; i < stocksNum; i++){
+            m_schedule.addRoot(m_windows[i].m_onlineEWMCovXY, i);
+            m_schedule.addRoot(m_windows[i].m_onlineEWMVarX, i);
         }
+        m_schedule.compile();
     }
     
     // 分位数缩尾
@@ -198,12 +195,35 @@ void barra_cne5_1_beta1::Update(const Ma& ret, const Ma& cap, const Ve& valid)
         }
     }
 
-    // debug
-    std::cout << "update now============================****************** " << newMarketRet << std::endl;
-
     //2.更新beta值窗口
     m_version++;
-    {
+    // 定期重锚：在本次增量更新前由缓存窗口精确重算
+    if(m_reformWindow > 0 && m_version % m_reformWindow == 0){
+        PROFILE_SCOPE("Update::重锚");
+        if(m_useCrossSection){
+            m_crossSection->reanchor();
+        } else {
+            m_schedule.reanchor();
+        }
+    }
+    if(m_useCrossSection){
+        //截面引擎：整行向量更新全体股票
+        PROFILE_SCOPE("Update::更新截面beta窗口");
+        m_crossSection->update(newRet, newMarketRet, m_version);
+        computeBetaFromCrossSection();
+    } else if(m_threadPool){
+        // 并行模式：共享节点（市场序列）串行更新，各股票独占节点按分块并行执行
+        PROFILE_SCOPE("Update::并行更新beta值窗口");
+        m_onlineDataCacheY->update(newMarketRet, m_version);
+        m_schedule.runShared(m_version);
+        m_threadPool->parallelFor(0, newRet.cols(), [&](size_t, size_t begin, size_t end){
+            for(size_t i = begin; i < end; i++){
+                m_windows[i].m_onlineDataCacheX->update(newRet.col(i), m_version);
+                m_schedule.runGroup(i, m_version);
+                computeBetaFromWindow(static_cast<int>(i));
+            }
+        });
+    } else {
         PROFILE_SCOPE("Update::更新beta值窗口");
         for(int i = 0; i < newRet.cols(); i++){
             // 先更新协方差（它会更新共享的meanX和meanY）
@@ -212,30 +232,10 @@ void barra_cne5_1_beta1::Update(const Ma& ret, const Ma& cap, const Ve& valid)
             m_windows[i].m_onlineEWMVarX->update(newRet.col(i), m_version);
             
             //3.计算beta值
-            double cov = m_windows[i].m_onlineEWMCovXY->getValue();
-            double var = m_windows[i].m_onlineEWMVarX->getValue();
-            
-            // 检查除零和NaN情况
-            if(std::isnan(cov) || std::isnan(var) || var <= 0.0){
-                m_value[i] = std::numeric_limits<double>::quiet_NaN();
-            } else {
-                double beta = cov / var;
-                m_value[i] = beta;
-            }
-            //debug
-            std::cout << "cov = " << std::fixed << std::setprecision(9) << cov << std::endl;
-            std::cout << "var = " << std::fixed << std::setprecision(9) << var << std::endl;
-            std::cout << "beta = " << std::fixed << std::setprecision(9) << m_value[i] << std::endl;
-            std::cout << "================================================" << std::endl;
+            computeBetaFromWindow(i);
         }
     }
-    
-    for(int i = 0; i < m_value.size(); i++){
-        std::cout << std::fixed << std::setprecision(9) << m_value[i] << " ";
-    }
-    std::cout << std::endl;
-    std::cout << "================================================" << std::endl;
-    
+
     // 分位数缩尾
     {
         PROFILE_SCOPE("Update::分位数缩尾");
@@ -271,3 +271,106 @@ void barra_cne5_1_beta1::Update(const Ma& ret, const Ma& cap, const Ve& valid)
         m_value = (m_value.array() - betaMean) / betaStd;
     }
 }
+
+void barra_cne5_1_beta1::computeBetaFromCrossSection()
+{
+    const Ve& covXY = m_crossSection->getCovXY();
+    const Ve& varX = m_crossSection->getVarX();
+    for(int i = 0; i < m_value.size(); i++){
+        // Beta公式：beta = cov / var
+        if(std::isnan(covXY[i]) || std::isnan(varX[i]) || varX[i] <= 0.0){
+            m_value[i] = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            m_value[i] = covXY[i] / varX[i];
+        }
+    }
+}
+
+void barra_cne5_1_beta1::buildWindow(OnlineGraphBuilder& builder, const std::shared_ptr<OnlineWeightCache>& weightCache,
+                                     int i, const Ma& ret, const Ve& marketRet)
+{
+    // 构造该股票的EWM协方差和方差所需组件
+    // 容器层
+    auto cacheX = builder.createDataCache("ret#" + std::to_string(i), ret.col(i));
+    auto cacheY = builder.createDataCache("marketRet", marketRet);
+    
+    // 方法层：EWM求和
+    auto sumX = builder.create<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheX});
+    auto sumY = builder.create<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheY});
+    
+    // 方法层：EWM均值
+    auto meanX = builder.create<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sumX});
+    auto meanY = builder.create<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sumY});
+    
+    // 方法层：EWM乘积和（用于方差和协方差）
+    auto prodXX = builder.create<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, cacheX, cacheX});
+    auto prodXY = builder.create<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, cacheX, cacheY});
+    
+    // 方法层：EWM方差和协方差
+    auto varX = builder.create<OnlineEWMVar>(OnlineEWMVar::Window{weightCache, meanX, prodXX});
+    auto covXY = builder.create<OnlineEWMCov>(OnlineEWMCov::Window{weightCache, prodXY, meanX, meanY});
+    
+    // 应用层：Beta - 为每只股票保存独立的窗口
+    m_windows[i].m_onlineDataCacheX = cacheX;
+    m_windows[i].m_onlineEWMVarX = varX;
+    m_windows[i].m_onlineEWMCovXY = covXY;
+    computeBetaFromWindow(i);
+}
+
+void barra_cne5_1_beta1::computeBetaFromWindow(int i)
+{
+    // Beta公式：beta = cov / var
+    const double cov = m_windows[i].m_onlineEWMCovXY->getValue();
+    const double var = m_windows[i].m_onlineEWMVarX->getValue();
+    // 检查除零和NaN情况
+    if(std::isnan(cov) || std::isnan(var) || var <= 0.0){
+        m_value[i] = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        m_value[i] = cov / var;
+    }
+}
+
+int barra_cne5_1_beta1::SaveCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Save);
+    // 头部：节点图形状（恢复时据此重建）
+    archive.tag("barra_cne5_1_beta1");
+    int stocksNum = static_cast<int>(m_value.size());
+    archive(m_lagWindow, stocksNum, m_useCrossSection);
+    checkpointState(archive);
+    return archive.saveToFile(path) ? 0 : -1;
+}
+
+int barra_cne5_1_beta1::RestoreCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Restore);
+    if(!archive.loadFromFile(path)){
+        return -1;
+    }
+    archive.tag("barra_cne5_1_beta1");
+    int lagWindow = 0;
+    int stocksNum = 0;
+    bool useCrossSection = false;
+    archive(lagWindow, stocksNum, useCrossSection);
+    // 截面引擎与逐股票节点图的状态布局不同，按快照的模式重建
+    m_useCrossSection = useCrossSection;
+    // 占位数据只决定节点图形状，各节点状态随后由快照整体覆盖
+    Init(Ma::Zero(lagWindow, stocksNum), Ma::Ones(lagWindow, stocksNum), Ve::Ones(stocksNum));
+    checkpointState(archive);
+    if(!archive.atEnd()){
+        std::cout << "barra_cne5_1_beta1: 快照内容与节点图不一致（存在未读取的数据）" << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+void barra_cne5_1_beta1::checkpointState(OnlineCheckpoint& archive)
+{
+    if(m_useCrossSection){
+        m_crossSection->checkpoint(archive);
+    } else {
+        // 节点图按编译顺序逐节点读写（权重缓存与市场序列等共享节点只出现一次）
+        m_schedule.checkpoint(archive);
+    }
+    archive(m_value, m_version);
+}
@@ -1,10 +1,17 @@
 //创建一个应用，继承Application
 #include "../../OnlineBaseFactor/OnlineDataCache.h"
 #include "../../OnlineBaseFactor/OnlineEWMMethod.h"
+#include "../../OnlineBaseFactor/OnlineCrossSection.h"
+#include "../../OnlineBaseFactor/OnlineGraphBuilder.h"
+#include "../../OnlineBaseFactor/OnlineArena.h"
+#include "../../OnlineBaseFactor/OnlineSchedule.h"
 #include "../../DataProcess/DataProcess.h"
 #include "../../include/TradeConstants.h"
 #include "../../Eigen_extra/RingVec.h"
 #include "../../OnlineBaseFactor/BaseFactor/BaseFactor.h"
+#include "../../Tool/thread_pool.h"
+#include <memory>
+#include <string>
 #include <vector>
 class barra_cne5_1_beta1
 {
@@ -20,10 +27,33 @@ public:
     //结束时执行的函数
     virtual void Finish() ;
 
+    //检查点：把全部在线状态（节点图各节点的缓存与累计量、因子值、版本号）写入二进制快照，成功返回0
+    int SaveCheckpoint(const std::string& path);
+    //由快照恢复，替代Init（需在未初始化的实例上调用，模式设置同Init）：
+    //按快照记录的窗口大小与股票数以占位数据重建节点图，再逐节点读回状态，之后可直接Update，成功返回0
+    int RestoreCheckpoint(const std::string& path);
+
     //获取beta值结果
     const Ve& getValue() const { return m_value; }
 
+    //截面引擎模式：全体股票共享一块 T×N 窗口，带权和按整行向量更新（需在Init前设置）
+    void setUseCrossSection(bool useCrossSection) { m_useCrossSection = useCrossSection; }
+
+    //定期重锚：每 reformWindow 次更新由缓存窗口精确重算一次带权和，消除增量累计漂移（0为关闭）
+    void setReformWindow(size_t reformWindow) { m_reformWindow = reformWindow; }
+    //获取历次重锚观测到的最大漂移（增量值与精确重算值之差）
+    double getMaxDrift() const { return m_useCrossSection ? m_crossSection->getMaxDrift() : m_schedule.getMaxDrift(); }
+
+    //获取节点图去重统计（逐股票节点图模式下有效）
+    const OnlineGraphBuilder::Stats& getGraphStats() const { return m_graphStats; }
+    //获取节点内存池用量（各并行块汇总）
+    OnlineArena::Stats getArenaStats() const { return OnlineArena::sumStats(m_arenas); }
+
+    //并行模式：股票区间静态分块到常驻线程池，截面步骤（缩尾、标准化）在汇合后串行执行（需在Init前设置，1为串行）
+    void setThreadsNum(size_t threadsNum) { m_threadPool = threadsNum > 1 ? std::make_unique<Tool::ThreadPool>(threadsNum) : nullptr; }
+
     struct Window{
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheX;
         std::shared_ptr<OnlineEWMVar> m_onlineEWMVarX;
         std::shared_ptr<OnlineEWMCov> m_onlineEWMCovXY;
     };
@@ -32,8 +62,27 @@ protected:
     void RecvSHStockData();
 
 private: 
+    //由截面引擎的协方差和方差计算beta值
+    void computeBetaFromCrossSection();
+    //构建第i只股票的beta值窗口
+    void buildWindow(OnlineGraphBuilder& builder, const std::shared_ptr<OnlineWeightCache>& weightCache,
+                     int i, const Ma& ret, const Ve& marketRet);
+    //由第i只股票窗口的协方差和方差计算beta值
+    void computeBetaFromWindow(int i);
+    //检查点：保存/恢复共用的状态列表（节点图形状之外的部分）
+    void checkpointState(OnlineCheckpoint& archive);
+
     Ve m_value;
     size_t m_version = 0;
+    int m_lagWindow = 0;  // 窗口大小（Init时确定，检查点据此重建节点图）
     std::vector<Window> m_windows;  // 为每只股票维护独立的窗口
+    bool m_useCrossSection = false;
+    std::shared_ptr<OnlineCrossSectionEWM> m_crossSection;  // 截面引擎模式下的共享状态
+    OnlineGraphBuilder::Stats m_graphStats;
+    std::vector<std::shared_ptr<OnlineArena>> m_arenas;  // 节点内存池：[0] 供串行部分与第0块，其余并行块各用一个（节点随因子释放）
+    std::shared_ptr<OnlineDataCache> m_onlineDataCacheY;  // 市场收益率缓存（全体股票共享）
+    OnlineSchedule m_schedule;  // 逐股票节点图的拓扑执行序列（按股票分组，并行模式和重锚使用）
+    std::unique_ptr<Tool::ThreadPool> m_threadPool;  // 并行模式下的常驻线程池
+    size_t m_reformWindow = 0;  // 重锚周期（更新次数），0为关闭
 };
 
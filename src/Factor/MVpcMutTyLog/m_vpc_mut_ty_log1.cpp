@@ -1,4 +1,5 @@
 #include "m_vpc_mut_ty_log1.h"
+#include "../../OnlineBaseFactor/OnlineCheckpoint.h"
 
 m_vpc_mut_ty_log1::m_vpc_mut_ty_log1() = default;
 
@@ -35,55 +36,25 @@ int m_vpc_mut_ty_log1::Init(const Ma& initAmt, const Ma& initClose)
     Ve ewmWeightsVec((windowSize - rollingtime)*2);
     ewmWeightsVec.setConstant(1.0);
 
-    auto weightCacheVar = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(ewmVarWeightsVec);
-    auto weightCache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(ewmWeightsVec);
-
-
-    // 4. 为每只股票创建在线计算组件
-    for (int i = 0; i < stocksNum; ++i)
-    {
-        auto& w = m_windows[i];
-
-        // 初始化数据缓存（成交额、收盘价）
-        w.m_onlineDataCacheAmt   = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initAmt.col(i));
-        w.m_onlineDataCacheClose = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initClose.col(i));
-
-        // 初始化加信号（add_signal）队列
-        w.m_addSignal.clear();
-        for (int k = 0; k < lagWindow; ++k)
-            w.m_addSignal.emplace_back(0.0);
-
-        // 初始化 UPDO 队列
-        w.m_UPDO.clear();
-        for (int k = 0; k < lagWindow; ++k)
-            w.m_UPDO.emplace_back(0.0);
-
-        // 差分序列
-        Ve diffAmt;
-        BusinessFactor::to_diff_sequence(initAmt.col(i), diffAmt);
-
-        // 初始化在线方差和偏度
-        // 初始化窗口方差
-        Ve initValuesAmt = initAmt.col(i).tail(std_period).eval();
-        auto cacheValues = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initValuesAmt);
-        auto sumValues = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCacheVar, cacheValues});
-        auto meanValues = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCacheVar, sumValues});
-        auto prodValues = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCacheVar, cacheValues, cacheValues});
-        w.m_onlineEWMVar = OnlineBaseFactor::createOnlineBaseF<OnlineEWMVar>(
-            OnlineEWMVar::Window{weightCacheVar, meanValues, prodValues}
-        );
-
-        // 初始化偏度计算器（Skew）
-        Ve initValuesClose(m_windowSize - rollingtime);
-        initValuesClose.setConstant(0);
-        auto cacheValuesClose = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initValuesClose);
-        auto sumValuesClose = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheValuesClose});
-        auto meanValuesClose = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sumValuesClose});
-        auto prodValuesClose = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, cacheValuesClose, cacheValuesClose});
-        auto prod3ValuesClose = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct3>(OnlineEWMSumProduct3::Window{weightCache, cacheValuesClose, cacheValuesClose, cacheValuesClose});
-        w.m_onlineEWMSkew = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSkew>(
-            OnlineEWMSkew::Window{weightCache, meanValuesClose, prodValuesClose, prod3ValuesClose}
-        );
+    // 节点取自节点内存池（[0] 供共享节点与第0块，其余并行块各用一个），按构建顺序连续排布，随因子释放
+    m_arenas = OnlineArena::createChunks(m_threadPool ? m_threadPool->size() : 1);
+    auto weightCacheVar = m_arenas[0]->create<OnlineWeightCache>(ewmVarWeightsVec);
+    auto weightCache = m_arenas[0]->create<OnlineWeightCache>(ewmWeightsVec);
+
+
+    // 4. 为每只股票创建在线计算组件（股票之间只共享只读的权重缓存），块内按首只股票的用量一次预留
+    if (m_threadPool) {
+        m_threadPool->parallelFor(0, stocksNum, [&](size_t chunk, size_t begin, size_t end) {
+            OnlineArena& arena = *m_arenas[chunk];
+            arena.buildUniform(begin, end, [&](size_t i) {
+                buildWindow(arena, static_cast<int>(i), initAmt, initClose, weightCacheVar, weightCache);
+            });
+        });
+    } else {
+        OnlineArena& arena = *m_arenas[0];
+        arena.buildUniform(0, static_cast<size_t>(stocksNum), [&](size_t i) {
+            buildWindow(arena, static_cast<int>(i), initAmt, initClose, weightCacheVar, weightCache);
+        });
     }
 
     // 5. 初始化 skew 值缓存
@@ -98,53 +69,68 @@ int m_vpc_mut_ty_log1::Init(const Ma& initAmt, const Ma& initClose)
     return 0;
 }
 
+void m_vpc_mut_ty_log1::buildWindow(OnlineArena& arena, int i, const Ma& initAmt, const Ma& initClose,
+                                    const std::shared_ptr<OnlineWeightCache>& weightCacheVar, const std::shared_ptr<OnlineWeightCache>& weightCache)
+{
+    auto& w = m_windows[i];
+
+    // 初始化数据缓存（成交额、收盘价）
+    w.m_onlineDataCacheAmt   = arena.create<OnlineDataCache>(initAmt.col(i));
+    w.m_onlineDataCacheClose = arena.create<OnlineDataCache>(initClose.col(i));
+
+    // 初始化加信号（add_signal）队列
+    w.m_addSignal.clear();
+    for (size_t k = 0; k < m_windowSize; ++k)
+        w.m_addSignal.emplace_back(0.0);
+
+    // 初始化 UPDO 队列
+    w.m_UPDO.clear();
+    for (size_t k = 0; k < m_windowSize; ++k)
+        w.m_UPDO.emplace_back(0.0);
+
+    // 差分序列
+    Ve diffAmt;
+    BusinessFactor::to_diff_sequence(initAmt.col(i), diffAmt);
+
+    // 初始化在线方差和偏度
+    // 初始化窗口方差
+    Ve initValuesAmt = initAmt.col(i).tail(std_period).eval();
+    auto cacheValues = arena.create<OnlineDataCache>(initValuesAmt);
+    auto sumValues = arena.create<OnlineEWMSum>(OnlineEWMSum::Window{weightCacheVar, cacheValues});
+    auto meanValues = arena.create<OnlineEWMMean>(OnlineEWMMean::Window{weightCacheVar, sumValues});
+    auto prodValues = arena.create<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCacheVar, cacheValues, cacheValues});
+    w.m_onlineEWMVar = arena.create<OnlineEWMVar>(
+        OnlineEWMVar::Window{weightCacheVar, meanValues, prodValues}
+    );
+
+    // 初始化偏度计算器（多阶矩节点：一、二、三阶幂和一遍更新）
+    Ve initValuesClose(m_windowSize - rollingtime);
+    initValuesClose.setConstant(0);
+    auto cacheValuesClose = arena.create<OnlineDataCache>(initValuesClose);
+    w.m_onlineEWMMoments = arena.create<OnlineEWMMoments>(
+        OnlineEWMMoments::Window{weightCache, cacheValuesClose}
+    );
+}
+
 void m_vpc_mut_ty_log1::Update(const Ma& newAmt, const Ma& newClose)
 {
     Ma amt = newAmt;
     Ma close = newClose;
 
-    for(int i = 0; i < amt.cols(); i++){
-        Ve inSkewValues = Ve::Constant(amt.rows(), 0.0);
-        for(int j = 0; j < amt.rows(); j++){
-            m_version ++;
-            //构造增量
-            Ve inValueAmt = amt.col(i).segment(j, 1);
-            //成交额差分
-            double minuteTurnoverDiff = inValueAmt[0] - m_windows[i].m_onlineDataCacheAmt->getValues()[m_windowSize-1];
-            //update容器
-            m_windows[i].m_onlineDataCacheAmt->update(inValueAmt, m_version);
-
-            //update方法层
-            m_windows[i].m_onlineEWMVar->update(inValueAmt, m_version);
-            //add_signal
-            double addSignal = minuteTurnoverDiff / std::sqrt(m_windows[i].m_onlineEWMVar->getValue());
-            if(addSignal > 2.0){
-                m_windows[i].m_addSignal.pop_front();
-                m_windows[i].m_addSignal.push_back(1.0);
-                inSkewValues[j] = m_windows[i].m_addSignal[m_windowSize - rollingtime - 1];
-            }else{
-                m_windows[i].m_addSignal.pop_front();
-                m_windows[i].m_addSignal.push_back(0.0);
-                inSkewValues[j] = m_windows[i].m_addSignal[m_windowSize - rollingtime - 1];
+    // 每只股票的版本号区间互不重叠：先逐行更新成交额，再逐行更新收盘价
+    const size_t versionsPerStock = static_cast<size_t>(amt.rows() + close.rows());
+    if (m_threadPool) {
+        m_threadPool->parallelFor(0, amt.cols(), [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                updateStock(static_cast<int>(i), amt, close, m_version + i * versionsPerStock);
             }
+        });
+    } else {
+        for(int i = 0; i < amt.cols(); i++){
+            updateStock(i, amt, close, m_version + i * versionsPerStock);
         }
-        //UPDO
-        //update容器
-        const auto& cacheValues = m_windows[i].m_onlineDataCacheClose->getValues();
-        for(size_t j = 0; j < close.rows(); j++){
-            int index = m_windowSize - rollingtime;
-            m_windows[i].m_UPDO[index] = abs(cacheValues[index] - close.col(i)[j]);
-            m_windows[i].m_onlineDataCacheClose->update(close.col(i).segment(j, 1), m_version);
-            inSkewValues[j] *= m_windows[i].m_UPDO[index];
-            
-            m_windows[i].m_UPDO.emplace_back(std::numeric_limits<double>::quiet_NaN());
-            m_windows[i].m_UPDO.pop_front();
-            m_version ++;
-        }
-        //更新skew
-        m_windows[i].m_onlineEWMSkew->update(inSkewValues, m_version);
-        m_valueSkew[i] = -1*m_windows[i].m_onlineEWMSkew->getValue();
     }
+    m_version += amt.cols() * versionsPerStock;
     // debug
     // static int update_num = 0;
     // update_num ++;
@@ -171,4 +157,100 @@ void m_vpc_mut_ty_log1::Update(const Ma& newAmt, const Ma& newClose)
     //     std::cout << std::endl;
     // }
 }
- 
\ No newline at end of file
+ 
+
+void m_vpc_mut_ty_log1::updateStock(int i, const Ma& amt, const Ma& close, size_t version)
+{
+    Ve inSkewValues = Ve::Constant(amt.rows(), 0.0);
+    for(int j = 0; j < amt.rows(); j++){
+        version ++;
+        //构造增量
+        Ve inValueAmt = amt.col(i).segment(j, 1);
+        //成交额差分
+        double minuteTurnoverDiff = inValueAmt[0] - m_windows[i].m_onlineDataCacheAmt->getValues()[m_windowSize-1];
+        //update容器
+        m_windows[i].m_onlineDataCacheAmt->update(inValueAmt, version);
+
+        //update方法层
+        m_windows[i].m_onlineEWMVar->update(inValueAmt, version);
+        //add_signal
+        double addSignal = minuteTurnoverDiff / std::sqrt(m_windows[i].m_onlineEWMVar->getValue());
+        if(addSignal > 2.0){
+            m_windows[i].m_addSignal.pop_front();
+            m_windows[i].m_addSignal.push_back(1.0);
+            inSkewValues[j] = m_windows[i].m_addSignal[m_windowSize - rollingtime - 1];
+        }else{
+            m_windows[i].m_addSignal.pop_front();
+            m_windows[i].m_addSignal.push_back(0.0);
+            inSkewValues[j] = m_windows[i].m_addSignal[m_windowSize - rollingtime - 1];
+        }
+    }
+    //UPDO
+    //update容器
+    const auto& cacheValues = m_windows[i].m_onlineDataCacheClose->getValues();
+    for(size_t j = 0; j < close.rows(); j++){
+        int index = m_windowSize - rollingtime;
+        m_windows[i].m_UPDO[index] = abs(cacheValues[index] - close.col(i)[j]);
+        m_windows[i].m_onlineDataCacheClose->update(close.col(i).segment(j, 1), version);
+        inSkewValues[j] *= m_windows[i].m_UPDO[index];
+        
+        m_windows[i].m_UPDO.emplace_back(std::numeric_limits<double>::quiet_NaN());
+        m_windows[i].m_UPDO.pop_front();
+        version ++;
+    }
+    //更新skew
+    m_windows[i].m_onlineEWMMoments->update(inSkewValues, version);
+    m_valueSkew[i] = -1*m_windows[i].m_onlineEWMMoments->getSkew();
+}
+
+int m_vpc_mut_ty_log1::SaveCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Save);
+    // 头部：节点图形状（恢复时据此重建）
+    archive.tag("m_vpc_mut_ty_log1");
+    int lagWindow = static_cast<int>(m_windowSize);
+    int stocksNum = static_cast<int>(m_windows.size());
+    archive(lagWindow, stocksNum);
+    checkpointState(archive);
+    return archive.saveToFile(path) ? 0 : -1;
+}
+
+int m_vpc_mut_ty_log1::RestoreCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Restore);
+    if(!archive.loadFromFile(path)){
+        return -1;
+    }
+    archive.tag("m_vpc_mut_ty_log1");
+    int lagWindow = 0;
+    int stocksNum = 0;
+    archive(lagWindow, stocksNum);
+    // 占位数据只决定节点图形状，各节点状态随后由快照整体覆盖
+    if(Init(Ma::Ones(lagWindow, stocksNum), Ma::Ones(lagWindow, stocksNum)) != 0){
+        return -1;
+    }
+    checkpointState(archive);
+    if(!archive.atEnd()){
+        std::cout << "m_vpc_mut_ty_log1: 快照内容与节点图不一致（存在未读取的数据）" << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+void m_vpc_mut_ty_log1::checkpointState(OnlineCheckpoint& archive)
+{
+    // 逐股票节点不经过编译执行，这里临时编译一次只用于确定读写顺序（共享的权重缓存只出现一次）
+    OnlineSchedule schedule;
+    for(size_t i = 0; i < m_windows.size(); ++i){
+        schedule.addRoot(m_windows[i].m_onlineDataCacheAmt, i);
+        schedule.addRoot(m_windows[i].m_onlineDataCacheClose, i);
+        schedule.addRoot(m_windows[i].m_onlineEWMVar, i);
+        schedule.addRoot(m_windows[i].m_onlineEWMMoments, i);
+    }
+    schedule.compile();
+    schedule.checkpoint(archive);
+    for(auto& window : m_windows){
+        archive(window.m_addSignal, window.m_UPDO);
+    }
+    archive(m_valueSkew, m_version);
+}
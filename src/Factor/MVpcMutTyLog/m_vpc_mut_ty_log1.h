@@ -6,9 +6,13 @@
 #include "../../Eigen_extra/RingVec.h"
 #include "../../OnlineBaseFactor/BaseFactor/BaseFactor.h"
 #include "OnlineBaseFactor/OnlineDataCache.h"
+#include "../../Tool/thread_pool.h"
+#include "../../OnlineBaseFactor/OnlineSchedule.h"
+#include "../../OnlineBaseFactor/OnlineArena.h"
 #include <cstddef>
 #include <deque>
 #include <memory>
+#include <string>
 class m_vpc_mut_ty_log1
 {
 public:
@@ -23,15 +27,27 @@ public:
     //结束时执行的函数
     virtual void Finish() ;
 
+    //检查点：把全部在线状态（节点图各节点的缓存与累计量、因子值、版本号）写入二进制快照，成功返回0
+    int SaveCheckpoint(const std::string& path);
+    //由快照恢复，替代Init（需在未初始化的实例上调用，模式设置同Init）：
+    //按快照记录的窗口大小与股票数以占位数据重建节点图，再逐节点读回状态，之后可直接Update，成功返回0
+    int RestoreCheckpoint(const std::string& path);
+
     //获取因子值结果
     const Ve& getValue() const { return m_valueSkew; }
 
+    //并行模式：股票区间静态分块到常驻线程池（需在Init前设置，1为串行）
+    void setThreadsNum(size_t threadsNum) { m_threadPool = threadsNum > 1 ? std::make_unique<Tool::ThreadPool>(threadsNum) : nullptr; }
+
+    //获取节点内存池用量（各并行块汇总）
+    OnlineArena::Stats getArenaStats() const { return OnlineArena::sumStats(m_arenas); }
+
     struct Window{
         std::shared_ptr<OnlineDataCache> m_onlineDataCacheAmt;
         std::shared_ptr<OnlineDataCache> m_onlineDataCacheClose;
 
         std::shared_ptr<OnlineEWMVar> m_onlineEWMVar;
-        std::shared_ptr<OnlineEWMSkew> m_onlineEWMSkew;
+        std::shared_ptr<OnlineEWMMoments> m_onlineEWMMoments;
         
         std::deque<double> m_addSignal;
         std::deque<double> m_UPDO;
@@ -40,10 +56,20 @@ protected:
     //接收数据的函数
 
 private: 
+    //构建第i只股票的窗口（节点取自 arena）
+    void buildWindow(OnlineArena& arena, int i, const Ma& initAmt, const Ma& initClose,
+                     const std::shared_ptr<OnlineWeightCache>& weightCacheVar, const std::shared_ptr<OnlineWeightCache>& weightCache);
+    //更新第i只股票，version 为该股票本次更新的起始版本号
+    void updateStock(int i, const Ma& amt, const Ma& close, size_t version);
+    //检查点：保存/恢复共用的状态列表（节点图形状之外的部分）
+    void checkpointState(OnlineCheckpoint& archive);
+
     Ve m_valueSkew;
     size_t m_version = 0;
     size_t m_windowSize = 0;
     std::vector<Window> m_windows;  // 为每只股票维护独立的窗口
+    std::unique_ptr<Tool::ThreadPool> m_threadPool;  // 并行模式下的常驻线程池
+    std::vector<std::shared_ptr<OnlineArena>> m_arenas;  // 节点内存池：[0] 供共享节点与第0块，其余并行块各用一个（节点随因子释放）
     //魔法配置
     int std_period = 5;
     int rollingtime = 2;
@@ -1,4 +1,5 @@
 #include "m_vpc_mut_ty_log2.h"
+#include "OnlineBaseFactor/OnlineCheckpoint.h"
 
 #include <algorithm>
 #include <cmath>
@@ -24,27 +25,38 @@ int m_vpc_mut_ty_log2::Init(const Ma& initAmt, const Ma& initClose)
     m_windowSize = lagWindow;
     m_windows.resize(stocksNum);
     m_valueCoef.resize(stocksNum);
-    for(int i = 0; i < stocksNum; ++i){
-        // 构建缓存序列
-        m_windows[i].cacheDataAmt = initAmt.col(i);
-        m_windows[i].cacheDataClose = initClose.col(i);
-
-        // 构建收益率排名
-        Ve retClose(m_windowSize);
-        BusinessFactor::to_diff_return_sequence(m_windows[i].cacheDataClose, retClose);
-        Ve rankClose(m_windowSize);
-        BaseFactor::rankpct(retClose, rankClose);
-
-        // 构建输入，类似flag操作
-        Ve flagClose = m_windows[i].cacheDataClose;
-        for(int j = 0;j < rankClose.size(); ++j){
-            if(rankClose(j) < 0.9 || std::isnan(rankClose(j))){
-                flagClose[j] = std::numeric_limits<double>::quiet_NaN();
+    // 节点取自节点内存池（每个并行块一个），按构建顺序连续排布，随因子释放
+    m_arenas = OnlineArena::createChunks(m_threadPool ? m_threadPool->size() : 1);
+    auto initStocks = [&](OnlineArena& arena, size_t begin, size_t end){
+        // 块内按首只股票的用量一次预留
+        arena.buildUniform(begin, end, [&](size_t i){
+            Window& window = m_windows[i];
+            // 构建缓存序列
+            Ve initAmtValues = initAmt.col(i);
+            Ve initCloseValues = initClose.col(i);
+            window.cacheAmt = arena.create<OnlineDataCache>(initAmtValues);
+            window.cacheClose = arena.create<OnlineDataCache>(initCloseValues);
+            // 构建收益率排名（只在初始化时整体计算一次）
+            Ve retClose(m_windowSize);
+            BusinessFactor::to_diff_return_sequence(initCloseValues, retClose);
+            Ve retWindow = retClose.tail(m_windowSize - 1);
+            window.cacheRet = arena.create<OnlineDataCache>(retWindow);
+            window.rankRet = arena.create<OnlineRank>(retWindow, OnlineRank::Window{window.cacheRet});
+            // 标记：收益率排名前 10% 的收盘价参与相关系数（首个收益率恒为 NaN，不标记）
+            window.cutoff = window.rankRet->getTopCutoff(0.9);
+            Ve flags = Ve::Zero(m_windowSize);
+            for(size_t j = 1; j < m_windowSize; ++j){
+                flags[j] = (retWindow[j - 1] >= window.cutoff) ? 1.0 : 0.0;
             }
-        }
-        double res;
-        BaseFactor::pearson_correlation(flagClose, m_windows[i].cacheDataAmt, res);
-        m_valueCoef[i] = res;
+            window.corr = arena.create<OnlineMaskedCorrelation>(
+                flags, OnlineMaskedCorrelation::Window{window.cacheClose, window.cacheAmt});
+            m_valueCoef[i] = window.corr->getValue();
+        });
+    };
+    if(m_threadPool){
+        m_threadPool->parallelFor(0, stocksNum, [&](size_t chunk, size_t begin, size_t end){ initStocks(*m_arenas[chunk], begin, end); });
+    } else {
+        initStocks(*m_arenas[0], 0, stocksNum);
     }
     return 0;
 }
@@ -52,35 +64,102 @@ int m_vpc_mut_ty_log2::Init(const Ma& initAmt, const Ma& initClose)
 void m_vpc_mut_ty_log2::Update(const Ma& newAmt, const Ma& newClose)
 {
     size_t stepSize = newAmt.rows();
-    for(int i = 0; i < newAmt.cols(); ++i){
-        // 构建缓存序列
-        m_windows[i].cacheDataAmt.head(m_windowSize - stepSize) = m_windows[i].cacheDataAmt.tail(m_windowSize - stepSize);
-        m_windows[i].cacheDataAmt.tail(stepSize) = newAmt.col(i);
-        m_windows[i].cacheDataClose.head(m_windowSize - stepSize) = m_windows[i].cacheDataClose.tail(m_windowSize - stepSize);
-        m_windows[i].cacheDataClose.tail(stepSize) = newClose.col(i);
-
-        // 构建收益率排名
-        Ve retClose(m_windowSize);
-        BusinessFactor::to_diff_return_sequence(m_windows[i].cacheDataClose, retClose);
-        Ve rankClose(m_windowSize);
-        BaseFactor::rankpct(retClose, rankClose);
-        // 构建输入，类似flag操作
-        Ve flagClose = m_windows[i].cacheDataClose;
-        for(int j = 0;j < rankClose.size(); ++j){
-            if(rankClose(j) < 0.9 || std::isnan(rankClose(j))){
-                flagClose[j] = std::numeric_limits<double>::quiet_NaN();
+    ++m_version;
+    auto updateStocks = [&](size_t begin, size_t end){
+        Ve newRet(stepSize);
+        Ve newFlags(stepSize);
+        for(size_t i = begin; i < end; ++i){
+            Window& window = m_windows[i];
+            // 新收益率：与 to_diff_return_sequence 相同的运算顺序 (x(t) - x(t-1)) / x(t-1)
+            double lastClose = window.cacheClose->getValues()[static_cast<int>(m_windowSize) - 1];
+            for(size_t k = 0; k < stepSize; ++k){
+                const double diff = newClose(k, i) - lastClose;
+                newRet[k] = diff / lastClose;
+                lastClose = newClose(k, i);
             }
+            window.rankRet->update(newRet, m_version);
+            updateCoef(window, newAmt.col(i), newClose.col(i), newRet, newFlags);
+            m_valueCoef[i] = window.corr->getValue();
         }
-        double res;
-        BaseFactor::pearson_correlation(flagClose, m_windows[i].cacheDataAmt, res);
-        m_valueCoef[i] = res;
+    };
+    if(m_threadPool){
+        m_threadPool->parallelFor(0, newAmt.cols(), [&](size_t, size_t begin, size_t end){ updateStocks(begin, end); });
+    } else {
+        updateStocks(0, newAmt.cols());
+    }
+}
 
-        // debug
-        static int updateNum = 0;
-        updateNum ++;
-        if(updateNum == 2){
-            int debug =1;
-        }
+void m_vpc_mut_ty_log2::updateCoef(Window& window, const Ve& newAmt, const Ve& newClose, const Ve& newRet, Ve& newFlags)
+{
+    // 收益率排名前 10%（rankpct >= 0.9）等价于收益率不低于排名下界，无需每次排序
+    const double oldCutoff = window.cutoff;
+    const double newCutoff = window.rankRet->getTopCutoff(0.9);
+    for(Eigen::Index k = 0; k < newRet.size(); ++k){
+        newFlags[k] = (newRet[k] >= newCutoff) ? 1.0 : 0.0;
+    }
+    window.corr->update(newClose, newAmt, newFlags, m_version);
+    // 滑到窗口首位的收盘价已无收益率（to_diff_return_sequence 首项为 NaN），取消标记
+    window.corr->setFlag(0, false);
+
+    // 下界移动时，只有收益率落在新旧下界之间的样本翻转标记（下界为 NaN 即无样本被标记，视为 +inf）
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double oldBound = std::isnan(oldCutoff) ? infinity : oldCutoff;
+    const double newBound = std::isnan(newCutoff) ? infinity : newCutoff;
+    if(oldBound != newBound){
+        const double lower = std::min(oldBound, newBound);
+        const double upper = std::max(oldBound, newBound);
+        // 收益率窗口第 j 个对应收盘价窗口第 j+1 个
+        window.rankRet->forEachInRange(lower, upper, [&](size_t j, double ret){
+            window.corr->setFlag(j + 1, ret >= newBound);
+        });
     }
+    window.cutoff = newCutoff;
 }
 
+int m_vpc_mut_ty_log2::SaveCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Save);
+    // 头部：节点图形状（恢复时据此重建）
+    archive.tag("m_vpc_mut_ty_log2");
+    int lagWindow = static_cast<int>(m_windowSize);
+    int stocksNum = static_cast<int>(m_windows.size());
+    archive(lagWindow, stocksNum);
+    checkpointState(archive);
+    return archive.saveToFile(path) ? 0 : -1;
+}
+
+int m_vpc_mut_ty_log2::RestoreCheckpoint(const std::string& path)
+{
+    OnlineCheckpoint archive(OnlineCheckpoint::Mode::Restore);
+    if(!archive.loadFromFile(path)){
+        return -1;
+    }
+    archive.tag("m_vpc_mut_ty_log2");
+    int lagWindow = 0;
+    int stocksNum = 0;
+    archive(lagWindow, stocksNum);
+    // 占位数据只决定节点图形状，各节点状态随后由快照整体覆盖
+    Init(Ma::Ones(lagWindow, stocksNum), Ma::Ones(lagWindow, stocksNum));
+    checkpointState(archive);
+    if(!archive.atEnd()){
+        std::cout << "m_vpc_mut_ty_log2: 快照内容与节点图不一致（存在未读取的数据）" << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+void m_vpc_mut_ty_log2::checkpointState(OnlineCheckpoint& archive)
+{
+    // 逐股票节点不经过编译执行，这里临时编译一次只用于确定读写顺序（缓存先于排名、相关系数恢复）
+    OnlineSchedule schedule;
+    for(size_t i = 0; i < m_windows.size(); ++i){
+        schedule.addRoot(m_windows[i].rankRet, i);
+        schedule.addRoot(m_windows[i].corr, i);
+    }
+    schedule.compile();
+    schedule.checkpoint(archive);
+    for(auto& window : m_windows){
+        archive(window.cutoff);
+    }
+    archive(m_valueCoef, m_version);
+}
@@ -2,11 +2,17 @@
 #include "../../Eigen_extra/Eigen_extra.h"
 #include "OnlineBaseFactor/OnlineDataCache.h"
 #include "OnlineBaseFactor/OnlineMethod.h"
+#include "OnlineBaseFactor/OnlineNanMethod.h"
 #include "OnlineBaseFactor/BusinessFactor/businessfactor.h"
 #include "OnlineBaseFactor/BaseFactor/BaseFactor.h"
+#include "../../Tool/thread_pool.h"
+#include "OnlineBaseFactor/OnlineSchedule.h"
+#include "OnlineBaseFactor/OnlineArena.h"
 #include <cstddef>
 #include <vector>
 #include <memory>
+#include <string>
+#include <limits>
 class m_vpc_mut_ty_log2
 {
 public:
@@ -21,21 +27,48 @@ public:
     //结束时执行的函数
     virtual void Finish() ;
 
+    //检查点：把全部在线状态（节点图各节点的缓存与累计量、因子值、版本号）写入二进制快照，成功返回0
+    int SaveCheckpoint(const std::string& path);
+    //由快照恢复，替代Init（需在未初始化的实例上调用，模式设置同Init）：
+    //按快照记录的窗口大小与股票数以占位数据重建节点图，再逐节点读回状态，之后可直接Update，成功返回0
+    int RestoreCheckpoint(const std::string& path);
+
     //获取因子值结果
     const Ve& getValue() const { return m_valueCoef; }
 
+    //并行模式：股票区间静态分块到常驻线程池（需在Init前设置，1为串行）
+    void setThreadsNum(size_t threadsNum) { m_threadPool = threadsNum > 1 ? std::make_unique<Tool::ThreadPool>(threadsNum) : nullptr; }
+
+    //获取节点内存池用量（各并行块汇总）
+    OnlineArena::Stats getArenaStats() const { return OnlineArena::sumStats(m_arenas); }
+
     struct Window{
-        Ve cacheDataAmt;
-        Ve cacheDataClose;
+        // 成交额、收盘价缓存（窗口为 lagWindow）
+        std::shared_ptr<OnlineDataCache> cacheAmt;
+        std::shared_ptr<OnlineDataCache> cacheClose;
+        // 收益率滑动排名（窗口为 lagWindow-1 个收益率，首个收益率恒为 NaN 不入窗口）
+        std::shared_ptr<OnlineDataCache> cacheRet;
+        std::shared_ptr<OnlineRank> rankRet;
+        // 被标记收盘价（收益率排名前 10%）与成交额的相关系数
+        std::shared_ptr<OnlineMaskedCorrelation> corr;
+        // 当前标记下界（收益率不低于下界即被标记，NaN 表示无样本被标记）
+        double cutoff = std::numeric_limits<double>::quiet_NaN();
     };
 protected:
     //接收数据的函数
 
 private: 
+    //由新样本更新标记与相关系数（收益率排名已更新）
+    void updateCoef(Window& window, const Ve& newAmt, const Ve& newClose, const Ve& newRet, Ve& newFlags);
+    //检查点：保存/恢复共用的状态列表（节点图形状之外的部分）
+    void checkpointState(OnlineCheckpoint& archive);
+
     Ve m_valueCoef;
     size_t m_stockCount = 0;
     size_t m_version = 0;
     size_t m_windowSize = 0;
     std::vector<Window> m_windows;  // 为每只股票维护独立的窗口
+    std::unique_ptr<Tool::ThreadPool> m_threadPool;  // 并行模式下的常驻线程池
+    std::vector<std::shared_ptr<OnlineArena>> m_arenas;  // 节点内存池：每个并行块一个（节点随因子释放）
 };
 
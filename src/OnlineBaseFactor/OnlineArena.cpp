@@ -0,0 +1,88 @@
+#include "OnlineArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+// 当前线程正在 create 的内存池（nullptr 表示不在 create 中）
+thread_local std::pmr::memory_resource* t_constructionResource = nullptr;
+}
+
+OnlineArena::Stats& OnlineArena::Stats::operator+=(const Stats& other) noexcept {
+    reservedBytes += other.reservedBytes;
+    usedBytes += other.usedBytes;
+    allocations += other.allocations;
+    nodes += other.nodes;
+    blocks += other.blocks;
+    return *this;
+}
+
+OnlineArena::~OnlineArena() {
+    for(const auto& block : m_blocks){
+        ::operator delete(block.first, std::align_val_t(BLOCK_ALIGNMENT));
+    }
+}
+
+void OnlineArena::reserve(size_t bytes) {
+    if(static_cast<size_t>(m_limit - m_cursor) < bytes){
+        addBlock(bytes);
+    }
+}
+
+std::pmr::memory_resource* OnlineArena::constructionResource() noexcept {
+    return t_constructionResource ? t_constructionResource : std::pmr::get_default_resource();
+}
+
+std::vector<std::shared_ptr<OnlineArena>> OnlineArena::createChunks(size_t chunksNum) {
+    std::vector<std::shared_ptr<OnlineArena>> arenas(std::max<size_t>(chunksNum, 1));
+    for(auto& arena : arenas){
+        arena = std::make_shared<OnlineArena>();
+    }
+    return arenas;
+}
+
+OnlineArena::Stats OnlineArena::sumStats(const std::vector<std::shared_ptr<OnlineArena>>& arenas) noexcept {
+    Stats total;
+    for(const auto& arena : arenas){
+        total += arena->getStats();
+    }
+    return total;
+}
+
+OnlineArena::ConstructionScope::ConstructionScope(OnlineArena* arena) noexcept
+    : m_previous(t_constructionResource) {
+    t_constructionResource = arena;
+}
+
+OnlineArena::ConstructionScope::~ConstructionScope() {
+    t_constructionResource = m_previous;
+}
+
+void* OnlineArena::do_allocate(size_t bytes, size_t alignment) {
+    // 对齐到 alignment 所需的填充字节数
+    const auto padding = [alignment](const std::byte* pointer) {
+        const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+        return static_cast<size_t>((alignment - address % alignment) % alignment);
+    };
+    size_t offset = padding(m_cursor);
+    if(m_cursor == nullptr || static_cast<size_t>(m_limit - m_cursor) < offset + bytes){
+        // 当前块不足：另起一块（至少容纳本次分配），旧块余量不再使用
+        addBlock(std::max(m_nextBlockBytes, bytes + alignment));
+        m_nextBlockBytes = std::min(2 * m_nextBlockBytes, MAX_BLOCK_BYTES);
+        offset = padding(m_cursor);
+    }
+    std::byte* start = m_cursor + offset;
+    m_stats.usedBytes += offset + bytes;
+    ++m_stats.allocations;
+    m_cursor = start + bytes;
+    return start;
+}
+
+void OnlineArena::addBlock(size_t bytes) {
+    auto* block = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(BLOCK_ALIGNMENT)));
+    m_blocks.emplace_back(block, bytes);
+    m_cursor = block;
+    m_limit = block + bytes;
+    m_stats.reservedBytes += bytes;
+    ++m_stats.blocks;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// 节点内存池：单调递增（bump）分配，节点对象、控制块与缓存层窗口缓冲按创建顺序（即图构建顺序）连续排布
+// 只分配不回收：节点析构时不归还内存，最后一个节点与持有者都释放后整体释放
+// 生命周期：create 出的节点经分配器持有内存池，内存池不会先于其中任何节点释放（由持有者——因子——统一管理）
+// 非线程安全：并行构建时每个线程块各用一个内存池
+class OnlineArena : public std::pmr::memory_resource, public std::enable_shared_from_this<OnlineArena> {
+    public:
+    // 用量统计
+    struct Stats {
+        size_t reservedBytes = 0;  // 已申请的块总字节数
+        size_t usedBytes = 0;      // 已分配字节数（含对齐填充）
+        size_t allocations = 0;    // 分配次数
+        size_t nodes = 0;          // create 创建的节点数
+        size_t blocks = 0;         // 块数
+        Stats& operator+=(const Stats& other) noexcept;
+    };
+
+    // 分配器：供 allocate_shared 把节点与控制块放进内存池，副本持有内存池
+    template<typename T>
+    class Allocator {
+        public:
+        using value_type = T;
+        explicit Allocator(std::shared_ptr<OnlineArena> arena) noexcept : m_arena(std::move(arena)) {}
+        template<typename U>
+        Allocator(const Allocator<U>& other) noexcept : m_arena(other.m_arena) {}
+        T* allocate(size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T* pointer, size_t count) noexcept { m_arena->deallocate(pointer, count * sizeof(T), alignof(T)); }
+        template<typename U>
+        bool operator==(const Allocator<U>& other) const noexcept { return m_arena == other.m_arena; }
+        template<typename U>
+        bool operator!=(const Allocator<U>& other) const noexcept { return m_arena != other.m_arena; }
+
+        private:
+        template<typename U> friend class Allocator;
+        std::shared_ptr<OnlineArena> m_arena;
+    };
+
+    // 须经 std::make_shared 创建（create 需要 shared_from_this）
+    explicit OnlineArena(size_t blockBytes = DEFAULT_BLOCK_BYTES) noexcept : m_nextBlockBytes(blockBytes) {}
+    ~OnlineArena() override;
+    OnlineArena(const OnlineArena&) = delete;
+    OnlineArena& operator=(const OnlineArena&) = delete;
+
+    // 在内存池中创建节点（等同 OnlineBaseFactor::createOnlineBaseF，构造期间缓存层的窗口缓冲也取自本内存池）
+    template<typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        const ConstructionScope scope(this);
+        ++m_stats.nodes;
+        return std::allocate_shared<T>(Allocator<T>(shared_from_this()), std::forward<Args>(args)...);
+    }
+
+    // 预留：保证后续至少 bytes 字节连续可用（已知规模时一次申请，避免逐块增长）
+    void reserve(size_t bytes);
+    // 依次构建 [begin, end) 的同构子图（如逐只股票）：首个建完后按其实际用量为其余一次预留，使各子图在同一块中连续排布
+    template<typename Build>
+    void buildUniform(size_t begin, size_t end, Build&& build) {
+        for (size_t i = begin; i < end; ++i) {
+            const size_t usedBefore = m_stats.usedBytes;
+            build(i);
+            if (i == begin && end - begin > 1) {
+                reserve((m_stats.usedBytes - usedBefore) * (end - begin - 1));
+            }
+        }
+    }
+
+    [[nodiscard]] const Stats& getStats() const noexcept { return m_stats; }
+
+    // 当前线程正在构造节点所用的内存资源（不在 create 中时为默认堆）
+    // 缓存层窗口缓冲在成员初始化时取用，使缓冲与节点同处一个内存池
+    [[nodiscard]] static std::pmr::memory_resource* constructionResource() noexcept;
+
+    // 按并行分块数创建内存池（[0] 供串行部分与第 0 块使用）及汇总统计
+    [[nodiscard]] static std::vector<std::shared_ptr<OnlineArena>> createChunks(size_t chunksNum);
+    [[nodiscard]] static Stats sumStats(const std::vector<std::shared_ptr<OnlineArena>>& arenas) noexcept;
+
+    private:
+    // 构造期间登记当前内存池（可嵌套，退出时恢复上一层）
+    class ConstructionScope {
+        public:
+        explicit ConstructionScope(OnlineArena* arena) noexcept;
+        ~ConstructionScope();
+        private:
+        std::pmr::memory_resource* m_previous;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    // 单调分配：不单独回收，随内存池整体释放
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    void addBlock(size_t bytes);
+
+    static constexpr size_t DEFAULT_BLOCK_BYTES = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_BYTES = 16 * 1024 * 1024;
+    // 块按缓存行对齐
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    std::vector<std::pair<std::byte*, size_t>> m_blocks;  // 各块起始地址与字节数
+    std::byte* m_cursor = nullptr;  // 当前块中下一个可用位置
+    std::byte* m_limit = nullptr;   // 当前块末尾
+    size_t m_nextBlockBytes;        // 下一块的字节数（逐块翻倍，不超过 MAX_BLOCK_BYTES）
+    Stats m_stats;
+};
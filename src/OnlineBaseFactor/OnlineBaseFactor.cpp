@@ -1,2 +1,10 @@
-// OnlineBaseFactor.cpp 已简化
-// 所有实现都在头文件中（模板方法）
+#include "OnlineBaseFactor.h"
+#include "OnlineCheckpoint.h"
+#include <typeinfo>
+
+void OnlineBaseFactor::checkpoint(OnlineCheckpoint& archive) {
+    // 以类型名标记节点，恢复时节点图结构与快照不一致即报错
+    archive.tag(typeid(*this).name());
+    archive(m_updateCalls, m_recomputeCalls, m_maxDrift);
+    checkpointState(archive);
+}
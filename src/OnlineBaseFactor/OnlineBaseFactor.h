@@ -1,18 +1,62 @@
 #pragma once
+#include <cmath>
 #include <memory>
+#include <vector>
 #include "OnlineUtils.h"
 
+class OnlineCheckpoint;
+
 // 在线因子基类：提供统一的创建接口和多态支持
 class OnlineBaseFactor {
     public:
         virtual ~OnlineBaseFactor() = default;
-        
+
         // 创建在线因子实例（应用层统一管理共享）
         template<typename T, typename... Args>
         static std::shared_ptr<T> createOnlineBaseF(Args&&... args){
             return std::make_shared<T>(std::forward<Args>(args)...);
         }
-    
+
+        // 编译模式：收集本节点的直接输入节点（用于拓扑排序，缓存层无输入）
+        virtual void collectInputs(std::vector<OnlineBaseFactor*>& /*inputs*/) const {}
+        // 编译模式：输入节点已更新的前提下只计算本节点（不递归、不做版本检查）
+        void compiledStep(size_t version) noexcept { ++m_updateCalls; step(version); }
+        // update 调用次数（含版本号命中后直接返回的调用）
+        [[nodiscard]] size_t getUpdateCalls() const noexcept { return m_updateCalls; }
+
+        // 重锚：输入节点已重锚的前提下，由缓存窗口精确重算本节点（不改变版本号），并记录漂移
+        virtual void reanchor() noexcept {}
+        // 历次重锚观测到的最大漂移（增量值与精确重算值之差的绝对值）
+        [[nodiscard]] double getMaxDrift() const noexcept { return m_maxDrift; }
+        // 按代价选择走整窗重算的 step 次数
+        [[nodiscard]] size_t getRecomputeCalls() const noexcept { return m_recomputeCalls; }
+
+        // 检查点：保存/恢复本节点的状态（不含输入节点，输入节点由节点图或调用方各自处理）
+        // 恢复前须已按相同配置构造本节点，恢复后版本号、累计和与缓冲均与保存时一致
+        void checkpoint(OnlineCheckpoint& archive);
+
     protected:
         OnlineBaseFactor() = default; // 防止直接实例化
+
+        // 本节点的单步计算（读取已更新的输入节点），由 update 和编译模式共用
+        virtual void step(size_t /*version*/) noexcept {}
+        // 本节点的状态成员（保存/恢复共用同一份成员列表，恢复后需要重建的派生结构在此重建）
+        virtual void checkpointState(OnlineCheckpoint& /*archive*/) {}
+        // 记录一次重锚的漂移
+        void recordDrift(double incrementalValue, double exactValue) noexcept {
+            const double drift = std::abs(incrementalValue - exactValue);
+            if (drift > m_maxDrift) {
+                m_maxDrift = drift;
+            }
+        }
+
+        // 代价选择：增量路径逐个处理本次 stepSize 个进出样本，整窗重算扫描 windowSize 个窗口样本
+        // 增量估计代价不低于重算时返回 true（断流补数、追赶回放等大批量更新按批量速度完成，结果同时回到精确值）
+        static bool preferRecompute(size_t stepSize, size_t windowSize, double incrementalCostPerSample, double recomputeCostPerSample) noexcept {
+            return static_cast<double>(stepSize) * incrementalCostPerSample >= static_cast<double>(windowSize) * recomputeCostPerSample;
+        }
+
+        size_t m_updateCalls = 0;
+        size_t m_recomputeCalls = 0;
+        double m_maxDrift = 0.0;
 };
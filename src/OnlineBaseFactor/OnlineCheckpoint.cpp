@@ -0,0 +1,222 @@
+#include "OnlineCheckpoint.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// 文件头：魔数、格式版本、状态字节数
+constexpr uint32_t kCheckpointMagic = 0x4B434C4F;  // "OLCK"
+constexpr uint32_t kCheckpointFormat = 1;
+struct CheckpointHeader {
+    uint32_t magic;
+    uint32_t format;
+    uint64_t payloadSize;
+};
+}
+
+bool OnlineCheckpoint::saveToFile(const std::string& path) const {
+    if(!isSaving()){
+        std::cout << "OnlineCheckpoint: 恢复模式不能保存\n";
+        return false;
+    }
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if(!file.is_open()){
+            std::cout << "OnlineCheckpoint: 无法写入快照文件: " << tempPath << "\n";
+            return false;
+        }
+        const CheckpointHeader header{kCheckpointMagic, kCheckpointFormat, static_cast<uint64_t>(m_buffer.size())};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        if(!file.good()){
+            std::cout << "OnlineCheckpoint: 写入快照文件失败: " << tempPath << "\n";
+            return false;
+        }
+    }
+    // 改名替换已有快照（Windows 下目标存在时改名失败，先删除）
+    if(std::rename(tempPath.c_str(), path.c_str()) != 0){
+        std::remove(path.c_str());
+        if(std::rename(tempPath.c_str(), path.c_str()) != 0){
+            std::cout << "OnlineCheckpoint: 无法替换快照文件: " << path << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OnlineCheckpoint::loadFromFile(const std::string& path) {
+    if(!isRestoring()){
+        std::cout << "OnlineCheckpoint: 保存模式不能读入\n";
+        return false;
+    }
+    unmap();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE){
+        std::cout << "OnlineCheckpoint: 无法打开快照文件: " << path << "\n";
+        return false;
+    }
+    m_fileHandle = file;
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(CheckpointHeader))){
+        std::cout << "OnlineCheckpoint: 快照文件不完整: " << path << "\n";
+        unmap();
+        return false;
+    }
+    m_mappingSize = static_cast<size_t>(fileSize.QuadPart);
+    m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_mapping = m_mappingHandle ? MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0){
+        std::cout << "OnlineCheckpoint: 无法打开快照文件: " << path << "\n";
+        return false;
+    }
+    struct stat fileStat;
+    if(::fstat(file, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(CheckpointHeader))){
+        std::cout << "OnlineCheckpoint: 快照文件不完整: " << path << "\n";
+        ::close(file);
+        return false;
+    }
+    m_mappingSize = static_cast<size_t>(fileStat.st_size);
+    void* mapping = ::mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+    // 映射建立后即可关闭文件描述符
+    ::close(file);
+    m_mapping = (mapping == MAP_FAILED) ? nullptr : mapping;
+    if(m_mapping){
+        // 恢复按顺序整体读取一遍
+        ::madvise(m_mapping, m_mappingSize, MADV_SEQUENTIAL);
+    }
+#endif
+    if(!m_mapping){
+        std::cout << "OnlineCheckpoint: 无法映射快照文件: " << path << "\n";
+        unmap();
+        return false;
+    }
+
+    CheckpointHeader header;
+    std::memcpy(&header, m_mapping, sizeof(header));
+    if(header.magic != kCheckpointMagic || header.format != kCheckpointFormat
+       || header.payloadSize != m_mappingSize - sizeof(header)){
+        std::cout << "OnlineCheckpoint: 快照文件头不匹配或文件不完整: " << path << "\n";
+        unmap();
+        return false;
+    }
+    m_data = static_cast<const char*>(m_mapping) + sizeof(header);
+    m_size = static_cast<size_t>(header.payloadSize);
+    m_offset = 0;
+    return true;
+}
+
+void OnlineCheckpoint::tag(const char* name) {
+    uint32_t length = static_cast<uint32_t>(std::strlen(name));
+    if(isSaving()){
+        field(length);
+        bytes(const_cast<char*>(name), length);
+        return;
+    }
+    uint32_t savedLength = 0;
+    field(savedLength);
+    if(savedLength != length || m_offset + length > m_size || std::memcmp(m_data + m_offset, name, length) != 0){
+        std::cout << "OnlineCheckpoint: 节点图与快照不一致（期望 " << name << "，位置 " << m_offset << "）\n";
+        exit(1);
+    }
+    m_offset += length;
+}
+
+void OnlineCheckpoint::field(RingVec<double>& ring) {
+    int capacity = ring.capacity();
+    int size = ring.size();
+    field(capacity);
+    field(size);
+    if(isSaving()){
+        const auto first = ring.firstSegment();
+        const auto second = ring.secondSegment();
+        bytes(const_cast<double*>(first.first), sizeof(double) * static_cast<size_t>(first.second));
+        bytes(const_cast<double*>(second.first), sizeof(double) * static_cast<size_t>(second.second));
+        return;
+    }
+    ring.resize(capacity);
+    double value = 0.0;
+    for(int i = 0; i < size; ++i){
+        field(value);
+        ring.pushPop(value);
+    }
+}
+
+void OnlineCheckpoint::field(RingMatrix& ring) {
+    int capacity = ring.capacity();
+    int cols = ring.cols();
+    int rows = ring.rows();
+    field(capacity);
+    field(cols);
+    field(rows);
+    if(isSaving()){
+        for(const auto& block : {ring.firstBlock(), ring.secondBlock()}){
+            bytes(const_cast<double*>(block.data()), sizeof(double) * static_cast<size_t>(block.size()));
+        }
+        return;
+    }
+    ring.resize(capacity, cols);
+    Eigen::RowVectorXd row(cols);
+    for(int t = 0; t < rows; ++t){
+        bytes(row.data(), sizeof(double) * static_cast<size_t>(cols));
+        ring.pushRow(row);
+    }
+}
+
+void OnlineCheckpoint::bytes(void* data, size_t size) {
+    if(size == 0){
+        return;
+    }
+    if(isSaving()){
+        const char* source = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), source, source + size);
+        return;
+    }
+    if(m_data == nullptr || m_offset + size > m_size){
+        std::cout << "OnlineCheckpoint: 快照数据不足（位置 " << m_offset << "，需要 " << size << " 字节）\n";
+        exit(1);
+    }
+    std::memcpy(data, m_data + m_offset, size);
+    m_offset += size;
+}
+
+void OnlineCheckpoint::unmap() noexcept {
+#ifdef _WIN32
+    if(m_mapping){
+        UnmapViewOfFile(m_mapping);
+    }
+    if(m_mappingHandle){
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if(m_fileHandle){
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+#else
+    if(m_mapping){
+        ::munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+    m_size = 0;
+    m_offset = 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "../Eigen_extra/Eigen_extra.h"
+#include "../Eigen_extra/RingVec.h"
+#include "../Eigen_extra/RingMatrix.h"
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace EigenExtra;
+
+// 检查点：在线节点状态的二进制快照（保存时整体写出，恢复时内存映射读入）
+// 同一接口双向使用：节点在 checkpointState 中依次列出状态成员，保存模式下写出、恢复模式下按同一顺序读回
+// 快照只含状态，不含节点之间的链接：恢复时先按相同配置重建节点图，再按相同顺序逐节点读入
+// 快照与编译产物绑定（类型名、字节序、size_t 宽度），不用于跨平台交换
+class OnlineCheckpoint {
+    public:
+    enum class Mode { Save, Restore };
+
+    explicit OnlineCheckpoint(Mode mode) : m_mode(mode) {}
+    ~OnlineCheckpoint() { unmap(); }
+    OnlineCheckpoint(const OnlineCheckpoint&) = delete;
+    OnlineCheckpoint& operator=(const OnlineCheckpoint&) = delete;
+
+    [[nodiscard]] bool isSaving() const noexcept { return m_mode == Mode::Save; }
+    [[nodiscard]] bool isRestoring() const noexcept { return m_mode == Mode::Restore; }
+
+    // 保存模式：写出文件头与全部状态（先写临时文件再改名，中途失败不破坏已有快照）
+    bool saveToFile(const std::string& path) const;
+    // 恢复模式：内存映射快照文件并校验文件头，失败返回 false
+    bool loadFromFile(const std::string& path);
+    // 恢复模式：是否已读完全部状态
+    [[nodiscard]] bool atEnd() const noexcept { return m_offset == m_size; }
+
+    // 节点标记：保存时写入名称，恢复时校验（节点图结构与快照不一致时报错退出）
+    void tag(const char* name);
+
+    // 依次处理多个状态成员
+    template<typename... Fields>
+    void operator()(Fields&... fields) { (field(fields), ...); }
+
+    // 算术类型
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    void field(T& value) { bytes(&value, sizeof(T)); }
+    // Eigen 稠密矩阵/向量（按存储顺序整体读写，恢复时按快照尺寸重新分配）
+    template<int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+    void field(Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols>& matrix) {
+        Eigen::Index rows = matrix.rows();
+        Eigen::Index cols = matrix.cols();
+        field(rows);
+        field(cols);
+        if(isRestoring()){
+            matrix.resize(rows, cols);
+        }
+        bytes(matrix.data(), sizeof(double) * static_cast<size_t>(rows * cols));
+    }
+    // 定长数组（长度由已读写的其他状态成员决定）
+    void array(double* values, size_t count) { bytes(values, sizeof(double) * count); }
+    // 环形缓冲（按逻辑顺序读写，恢复时容量、内容与逻辑顺序不变）
+    void field(RingVec<double>& ring);
+    // 滚动窗口矩阵（按逻辑顺序逐行读写，恢复时容量、列数、内容与逻辑顺序不变）
+    void field(RingMatrix& ring);
+    // 算术类型的顺序容器
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    void field(std::vector<T>& values) {
+        uint64_t count = values.size();
+        field(count);
+        if(isRestoring()){
+            values.resize(static_cast<size_t>(count));
+        }
+        bytes(values.data(), sizeof(T) * values.size());
+    }
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    void field(std::deque<T>& values) {
+        uint64_t count = values.size();
+        field(count);
+        if(isRestoring()){
+            values.resize(static_cast<size_t>(count));
+        }
+        for(auto& value : values){
+            field(value);
+        }
+    }
+
+    private:
+    // 保存模式追加到缓冲，恢复模式从映射区读出（越界即快照损坏，报错退出）
+    void bytes(void* data, size_t size);
+    void unmap() noexcept;
+
+    Mode m_mode;
+    std::vector<char> m_buffer;    // 保存模式：待写出的状态
+    const char* m_data = nullptr;  // 恢复模式：映射区中状态的起始位置
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    void* m_mapping = nullptr;     // 映射区（含文件头）
+    size_t m_mappingSize = 0;
+    void* m_fileHandle = nullptr;  // Windows 下的文件/映射句柄
+    void* m_mappingHandle = nullptr;
+};
@@ -0,0 +1,371 @@
+#include "OnlineCrossSection.h"
+#include "OnlineCheckpoint.h"
+#include "OnlineDataCache.h"
+#include "BaseFactor/BaseFactor.h"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// OnlineCrossSection 截面在线引擎
+void OnlineCrossSection::constructor(const Ma& initialValueX, const Ve& initialValueY) {
+    if (initialValueX.rows() <= 1) {
+        std::cout << "OnlineCrossSection: 初始窗口大小小于等于1，无法构造\n";
+        exit(1);
+    }
+    if (initialValueX.rows() != initialValueY.size()) {
+        std::cout << "OnlineCrossSection: X和Y的窗口大小不一致\n";
+        exit(1);
+    }
+    m_windowSize = static_cast<size_t>(initialValueX.rows());
+    m_stocksNum = static_cast<size_t>(initialValueX.cols());
+    const Eigen::Index stocksNum = initialValueX.cols();
+
+    // 缓存层：列主序输入转为行主序滚动窗口
+    m_winX.resize(initialValueX.rows(), stocksNum);
+    m_winX.assign(initialValueX);
+    m_winY.resize(static_cast<int>(initialValueY.size()));
+    m_winY.assignFromVe(initialValueY);
+
+    // 方法层：确定平移量并按时间顺序逐行累加
+    m_shiftX = Ve::Zero(stocksNum);
+    m_sumX = Ve::Zero(stocksNum);
+    m_sumXX = Ve::Zero(stocksNum);
+    m_sumXY = Ve::Zero(stocksNum);
+    m_deltaX.resize(stocksNum);
+    computeSums();
+
+    // 预分配派生统计量和增量缓冲
+    m_meanX.resize(stocksNum);
+    m_varX.resize(stocksNum);
+    m_covXY.resize(stocksNum);
+    m_correlation.resize(stocksNum);
+    m_deltaXX.resize(stocksNum);
+    m_deltaXY.resize(stocksNum);
+
+    computeStats();
+    m_version = 0;
+}
+
+void OnlineCrossSection::update(const Ma& inValuesX, const Ve& inValuesY, size_t version) {
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    const Eigen::Index stepSize = inValuesX.rows();
+    if (inValuesX.cols() != static_cast<Eigen::Index>(m_stocksNum) || inValuesY.size() != stepSize) {
+        std::cout << "OnlineCrossSection::update: 输入维度与窗口不一致\n";
+        exit(1);
+    }
+    // 代价选择：增量每行进、出各一遍累加，重算需平移量、滑动和两遍扫描；步长达到窗口时只保留最后 windowSize 行整窗重算
+    if (preferRecompute(static_cast<size_t>(stepSize), m_windowSize, 2.0, 2.0)) {
+        const Eigen::Index windowRows = static_cast<Eigen::Index>(m_windowSize);
+        m_winX.assign(inValuesX.bottomRows(windowRows));
+        for (Eigen::Index i = stepSize - windowRows; i < stepSize; ++i) {
+            m_winY.pushPop(inValuesY[i]);
+        }
+        computeSums();
+        computeStats();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+
+    // 增量更新：逐行先加新值、再减被覆盖的旧值（与 OnlineSum/OnlineSumProduct 的顺序一致）
+    m_deltaX.setZero();
+    m_deltaXX.setZero();
+    m_deltaXY.setZero();
+    double deltaY = 0.0;
+    double deltaYY = 0.0;
+    for (Eigen::Index i = 0; i < stepSize; ++i) {
+        // 写入新行，挤出最旧行（被挤出行的视图在下一次写入前有效）
+        const auto evictedX = m_winX.pushRow(inValuesX.row(i));
+        const auto newX = inValuesX.row(i).transpose() - m_shiftX;
+        const auto oldX = evictedX.transpose() - m_shiftX;
+        const double newY = inValuesY[i] - m_shiftY;
+        const double oldY = m_winY.pushPop(inValuesY[i]) - m_shiftY;
+
+        m_deltaX += newX;
+        m_deltaX -= oldX;
+        m_deltaXX.array() += newX.array().square();
+        m_deltaXX.array() -= oldX.array().square();
+        m_deltaXY += newX * newY;
+        m_deltaXY -= oldX * oldY;
+        deltaY += newY;
+        deltaY -= oldY;
+        deltaYY += newY * newY;
+        deltaYY -= oldY * oldY;
+    }
+    m_sumX += m_deltaX;
+    m_sumXX += m_deltaXX;
+    m_sumXY += m_deltaXY;
+    m_sumY += deltaY;
+    m_sumYY += deltaYY;
+
+    computeStats();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineCrossSection::reanchor() noexcept {
+    // 暂存重算前的方差、协方差（借用增量缓冲，reanchor 不在 update 中途调用）
+    m_deltaXX = m_varX;
+    m_deltaXY = m_covXY;
+    const double varY = m_varY;
+    computeSums();
+    computeStats();
+    for (Eigen::Index i = 0; i < m_varX.size(); ++i) {
+        recordDrift(m_deltaXX[i], m_varX[i]);
+        recordDrift(m_deltaXY[i], m_covXY[i]);
+    }
+    recordDrift(varY, m_varY);
+}
+
+void OnlineCrossSection::checkpointState(OnlineCheckpoint& archive) {
+    // 增量缓冲（m_delta*）每次 update 重新写入，不入快照
+    archive(m_winX, m_winY, m_shiftX, m_shiftY);
+    archive(m_sumX, m_sumXX, m_sumXY, m_sumY, m_sumYY);
+    archive(m_meanX, m_varX, m_covXY, m_correlation, m_meanY, m_varY);
+    archive(m_version, m_windowSize, m_stocksNum);
+}
+
+void OnlineCrossSection::computeSums() noexcept {
+    // 平移量：当前窗口有效值均值（与 OnlineDataCache::reanchor 一致）
+    m_shiftX.setZero();
+    m_deltaX.setZero();
+    for (int t = 0; t < m_winX.rows(); ++t) {
+        const auto row = m_winX.row(t);
+        for (Eigen::Index i = 0; i < row.size(); ++i) {
+            const double sample = row[i];
+            if (std::isnan(sample)) { continue; }
+            m_shiftX[i] += sample;
+            m_deltaX[i] += 1.0;
+        }
+    }
+    m_shiftX = (m_deltaX.array() > 0.0).select(m_shiftX.array() / m_deltaX.array(), 0.0);
+    double sumY = 0.0;
+    double validY = 0.0;
+    for (int t = 0; t < m_winY.size(); ++t) {
+        if (std::isnan(m_winY[t])) { continue; }
+        sumY += m_winY[t];
+        validY += 1.0;
+    }
+    m_shiftY = (validY > 0.0) ? (sumY / validY) : 0.0;
+
+    // 按时间顺序（最旧 -> 最新）逐行累加平移后的值
+    m_sumX.setZero();
+    m_sumXX.setZero();
+    m_sumXY.setZero();
+    m_sumY = 0.0;
+    m_sumYY = 0.0;
+    for (int t = 0; t < m_winX.rows(); ++t) {
+        const auto sampleX = m_winX.row(t).transpose() - m_shiftX;
+        const double sampleY = m_winY[t] - m_shiftY;
+        m_sumX += sampleX;
+        m_sumXX.array() += sampleX.array().square();
+        m_sumXY += sampleX * sampleY;
+        m_sumY += sampleY;
+        m_sumYY += sampleY * sampleY;
+    }
+}
+
+void OnlineCrossSection::computeStats() noexcept {
+    const double numSamples = static_cast<double>(m_windowSize);
+
+    // 平移后的均值（m_deltaX 作暂存），均值 = 平移量 + 平移后的均值
+    m_deltaX = m_sumX / numSamples;
+    const double shiftedMeanY = m_sumY / numSamples;
+    m_meanX = m_shiftX + m_deltaX;
+    m_meanY = m_shiftY + shiftedMeanY;
+
+    // 方差、协方差（样本无偏，平移不改变结果），方差下限截断为 0（NaN 同样置 0，与 OnlineVar 一致）
+    if (numSamples > 1.0) {
+        m_varX.array() = (m_sumXX.array() - numSamples * m_deltaX.array() * m_deltaX.array()) / (numSamples - 1.0);
+        m_varX = (m_varX.array() > 0.0).select(m_varX, 0.0);
+        m_varY = std::max(0.0, (m_sumYY - numSamples * shiftedMeanY * shiftedMeanY) / (numSamples - 1.0));
+        m_covXY.array() = (m_sumXY.array() - numSamples * m_deltaX.array() * shiftedMeanY) / (numSamples - 1.0);
+    } else {
+        m_varX.setZero();
+        m_varY = 0.0;
+        m_covXY.setConstant(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    // 相关系数
+    const double stdY = std::sqrt(m_varY);
+    for (Eigen::Index i = 0; i < m_correlation.size(); ++i) {
+        const double stdX = std::sqrt(m_varX[i]);
+        if (stdX == 0.0 || stdY == 0.0 || std::isnan(m_covXY[i])) {
+            m_correlation[i] = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            m_correlation[i] = std::clamp(m_covXY[i] / (stdX * stdY), -1.0, 1.0);
+        }
+    }
+}
+
+// OnlineCrossSectionEWM 截面 EWM 在线引擎
+void OnlineCrossSectionEWM::constructor(const Ma& initialValueX, const Ve& initialValueY, const Ve& weights) {
+    if (initialValueX.rows() <= 1) {
+        std::cout << "OnlineCrossSectionEWM: 初始窗口大小小于等于1，无法构造\n";
+        exit(1);
+    }
+    if (initialValueX.rows() != initialValueY.size()) {
+        std::cout << "OnlineCrossSectionEWM: X和Y的窗口大小不一致\n";
+        exit(1);
+    }
+    if (weights.size() != 2 * initialValueX.rows()) {
+        std::cout << "OnlineCrossSectionEWM: 权重序列长度须为窗口大小的2倍\n";
+        exit(1);
+    }
+    m_windowSize = static_cast<size_t>(initialValueX.rows());
+    m_stocksNum = static_cast<size_t>(initialValueX.cols());
+    const Eigen::Index stocksNum = initialValueX.cols();
+
+    // 权重：与逐股票共享的 OnlineWeightCache 相同的归一方式与无偏系数
+    const OnlineWeightCache weightCache(weights);
+    m_normedWeights = weightCache.getNormedValues();
+    m_unnormalizedWeights = weightCache.getUnnormalizedValues();
+    BaseFactor::weighted_variance_unbiased_coef(m_normedWeights.tail(static_cast<Eigen::Index>(m_windowSize)), m_varianceBesselCorrection);
+
+    // 缓存层：列主序输入逐行（NaN 置 0）写入行主序滚动窗口
+    m_winX.resize(initialValueX.rows(), stocksNum);
+    m_winY.resize(static_cast<int>(initialValueY.size()));
+    m_rowX.resize(stocksNum);
+    m_weightedY.resize(initialValueY.size());
+    for (Eigen::Index t = 0; t < initialValueX.rows(); ++t) {
+        pushRow(initialValueX.row(t), initialValueY[t]);
+    }
+
+    // 预分配带权和与派生统计量
+    m_sumX.resize(stocksNum);
+    m_sumXX.resize(stocksNum);
+    m_sumXY.resize(stocksNum);
+    m_varX.resize(stocksNum);
+    m_covXY.resize(stocksNum);
+
+    computeSums();
+    computeStats();
+    m_version = 0;
+}
+
+void OnlineCrossSectionEWM::update(const Ma& inValuesX, const Ve& inValuesY, size_t version) {
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    const Eigen::Index stepSize = inValuesX.rows();
+    if (inValuesX.cols() != static_cast<Eigen::Index>(m_stocksNum) || inValuesY.size() != stepSize) {
+        std::cout << "OnlineCrossSectionEWM::update: 输入维度与窗口不一致\n";
+        exit(1);
+    }
+    const Eigen::Index windowSize = static_cast<Eigen::Index>(m_windowSize);
+    // 代价选择：同 OnlineEWMSum（步长超过窗口一半时增量不划算，步长超过窗口时增量权重下标越界）
+    if (preferRecompute(static_cast<size_t>(stepSize), m_windowSize, 2.0, 1.0)) {
+        // 只有最后 windowSize 行会留在窗口中
+        const Eigen::Index first = std::max<Eigen::Index>(0, stepSize - windowSize);
+        for (Eigen::Index i = first; i < stepSize; ++i) {
+            pushRow(inValuesX.row(i), inValuesY[i]);
+        }
+        computeSums();
+        computeStats();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+
+    // 增量更新（顺序同 OnlineEWMSum/OnlineEWMSumProduct）：整体衰减，减去移出行，加上移入行
+    const double decay = m_unnormalizedWeights[2 * windowSize - stepSize - 1];
+    m_sumX *= decay;
+    m_sumXX *= decay;
+    m_sumXY *= decay;
+    m_sumY *= decay;
+    m_sumYY *= decay;
+    // 先按逻辑顺序读出将被挤出的最旧 stepSize 行，再整行写入
+    for (Eigen::Index i = 0; i < stepSize; ++i) {
+        const double weight = m_normedWeights[windowSize - stepSize + i];
+        const auto oldX = m_winX.row(static_cast<int>(i)).transpose().array();
+        const double oldY = m_winY[static_cast<int>(i)];
+        m_sumX.array() -= weight * oldX;
+        m_sumXX.array() -= (weight * oldX) * oldX;
+        m_sumXY.array() -= (weight * oldX) * oldY;
+        m_sumY -= weight * oldY;
+        m_sumYY -= weight * oldY * oldY;
+    }
+    for (Eigen::Index i = 0; i < stepSize; ++i) {
+        const double weight = m_normedWeights[2 * windowSize - stepSize + i];
+        const double newY = pushRow(inValuesX.row(i), inValuesY[i]);
+        const auto newX = m_rowX.array();
+        m_sumX.array() += weight * newX;
+        m_sumXX.array() += (weight * newX) * newX;
+        m_sumXY.array() += (weight * newX) * newY;
+        m_sumY += weight * newY;
+        m_sumYY += weight * newY * newY;
+    }
+
+    computeStats();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineCrossSectionEWM::reanchor() noexcept {
+    // 暂存重算前的方差、协方差（reanchor 不在逐步更新的热路径上，直接拷贝）
+    const Ve varX = m_varX;
+    const Ve covXY = m_covXY;
+    const double varY = m_varY;
+    computeSums();
+    computeStats();
+    for (Eigen::Index i = 0; i < m_varX.size(); ++i) {
+        recordDrift(varX[i], m_varX[i]);
+        recordDrift(covXY[i], m_covXY[i]);
+    }
+    recordDrift(varY, m_varY);
+}
+
+void OnlineCrossSectionEWM::checkpointState(OnlineCheckpoint& archive) {
+    // 权重与无偏系数由构造参数决定，行缓冲与带权 Y 缓冲每次使用前重新写入，均不入快照
+    archive(m_winX, m_winY);
+    archive(m_sumX, m_sumXX, m_sumXY, m_sumY, m_sumYY);
+    archive(m_varX, m_covXY, m_varY);
+    archive(m_version, m_windowSize, m_stocksNum);
+}
+
+void OnlineCrossSectionEWM::computeSums() noexcept {
+    // 窗口按逻辑顺序（最旧 -> 最新）分为两段连续行块，数据位置 k 对应权重位置 T + k
+    const Eigen::Index windowSize = m_winX.rows();
+    const auto olderX = m_winX.firstBlock();
+    const auto newerX = m_winX.secondBlock();
+    const Eigen::Index olderRows = olderX.rows();
+    const Eigen::Index newerRows = newerX.rows();
+    const auto olderWeights = m_normedWeights.segment(windowSize, olderRows);
+    const auto newerWeights = m_normedWeights.segment(windowSize + olderRows, newerRows);
+    for (int k = 0; k < m_winY.size(); ++k) {
+        m_weightedY[k] = m_normedWeights[windowSize + k] * m_winY[k];
+    }
+    const auto olderWeightsY = m_weightedY.head(olderRows);
+    const auto newerWeightsY = m_weightedY.tail(newerRows);
+
+    m_sumX.noalias() = olderX.transpose() * olderWeights;
+    m_sumX.noalias() += newerX.transpose() * newerWeights;
+    m_sumXX.noalias() = olderX.array().square().matrix().transpose() * olderWeights;
+    m_sumXX.noalias() += newerX.array().square().matrix().transpose() * newerWeights;
+    m_sumXY.noalias() = olderX.transpose() * olderWeightsY;
+    m_sumXY.noalias() += newerX.transpose() * newerWeightsY;
+    m_sumY = olderWeightsY.sum() + newerWeightsY.sum();
+    m_sumYY = 0.0;
+    for (int k = 0; k < m_winY.size(); ++k) {
+        m_sumYY += m_weightedY[k] * m_winY[k];
+    }
+}
+
+void OnlineCrossSectionEWM::computeStats() noexcept {
+    // 权重和为 1：均值即带权和，方差/协方差 = (带权乘积和 - 均值之积) * 无偏系数
+    m_varX.array() = (m_sumXX.array() - m_sumX.array().square()) * m_varianceBesselCorrection;
+    m_covXY.array() = (m_sumXY.array() - m_sumX.array() * m_sumY) * m_varianceBesselCorrection;
+    m_varY = (m_sumYY - m_sumY * m_sumY) * m_varianceBesselCorrection;
+}
+
+double OnlineCrossSectionEWM::pushRow(const RingMatrix::RowRef& rowX, double valueY) noexcept {
+    m_rowX = rowX.transpose().unaryExpr([](double value) { return std::isnan(value) ? 0.0 : value; });
+    m_winX.pushRow(m_rowX.transpose());
+    const double storedY = std::isnan(valueY) ? 0.0 : valueY;
+    m_winY.pushPop(storedY);
+    return storedY;
+}
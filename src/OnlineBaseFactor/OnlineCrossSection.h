@@ -0,0 +1,159 @@
+#pragma once
+#include "OnlineBaseFactor.h"
+#include "../Eigen_extra/Eigen_extra.h"
+#include "../Eigen_extra/RingMatrix.h"
+#include "../Eigen_extra/RingVec.h"
+#include <limits>
+
+using namespace EigenExtra;
+
+// 截面在线引擎（结构数组）：全体股票共享一块状态，替代逐股票的 shared_ptr 节点图
+// 缓存层：X 为 T×N 行主序滚动窗口矩阵（时间×股票，RingMatrix），Y 为所有股票共用的长度 T 序列（如市场收益率）
+// 方法层：滑动和/乘积和以长度 N 的连续向量维护，每次更新只做少量整行向量运算
+// 与逐股票节点相同，滑动和以窗口均值为平移量累加（x - 平移量），可通过 reanchor 精确重算
+// 数值与逐股票的 OnlineSum/OnlineSumProduct/OnlineMean/OnlineVar/OnlineCov/OnlineCorrelation 在舍入误差内一致
+class OnlineCrossSection : public OnlineBaseFactor {
+    public:
+    OnlineCrossSection(const Ma& initialValueX, const Ve& initialValueY) {
+        constructor(initialValueX, initialValueY);
+    }
+    // 构造：initialValueX 为 T×N，initialValueY 长度为 T
+    void constructor(const Ma& initialValueX, const Ve& initialValueY);
+    // 更新：inValuesX 为 step×N，inValuesY 长度为 step（step 达到窗口大小时整窗重算）
+    void update(const Ma& inValuesX, const Ve& inValuesY, size_t version);
+    // 重锚：平移量取当前窗口均值，由窗口精确重算滑动和，漂移按方差/协方差的变化记录
+    void reanchor() noexcept override;
+
+    // 获取每只股票的值（长度 N），滑动和均为平移后的值
+    [[nodiscard]] const Ve& getSumX() const noexcept { return m_sumX; }
+    [[nodiscard]] const Ve& getSumXX() const noexcept { return m_sumXX; }
+    [[nodiscard]] const Ve& getSumXY() const noexcept { return m_sumXY; }
+    [[nodiscard]] const Ve& getMeanX() const noexcept { return m_meanX; }
+    [[nodiscard]] const Ve& getVarX() const noexcept { return m_varX; }
+    [[nodiscard]] const Ve& getCovXY() const noexcept { return m_covXY; }
+    [[nodiscard]] const Ve& getCorrelation() const noexcept { return m_correlation; }
+    [[nodiscard]] const Ve& getShiftX() const noexcept { return m_shiftX; }
+    // 获取共用序列的值（标量），滑动和均为平移后的值
+    [[nodiscard]] double getSumY() const noexcept { return m_sumY; }
+    [[nodiscard]] double getSumYY() const noexcept { return m_sumYY; }
+    [[nodiscard]] double getMeanY() const noexcept { return m_meanY; }
+    [[nodiscard]] double getVarY() const noexcept { return m_varY; }
+    [[nodiscard]] double getShiftY() const noexcept { return m_shiftY; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 获取股票数量
+    [[nodiscard]] size_t getStocksNum() const noexcept { return m_stocksNum; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 按当前窗口确定平移量并精确计算滑动和
+    void computeSums() noexcept;
+    // 由滑动和刷新均值、方差、协方差、相关系数
+    void computeStats() noexcept;
+
+    // 缓存层：X 为 T×N 滚动窗口矩阵，Y 为同步滚动的长度 T 环形缓冲
+    RingMatrix m_winX;
+    RingVec<double> m_winY;
+
+    // 方法层：平移量（逐股票，NaN 不参与）
+    Ve m_shiftX;
+    double m_shiftY = 0.0;
+
+    // 方法层：平移后的滑动和
+    Ve m_sumX;
+    Ve m_sumXX;
+    Ve m_sumXY;
+    double m_sumY = 0.0;
+    double m_sumYY = 0.0;
+
+    // 方法层：派生统计量
+    Ve m_meanX;
+    Ve m_varX;
+    Ve m_covXY;
+    Ve m_correlation;
+    double m_meanY = 0.0;
+    double m_varY = 0.0;
+
+    // 增量缓冲（构造时预分配，update 不做内存分配）
+    Ve m_deltaX;
+    Ve m_deltaXX;
+    Ve m_deltaXY;
+
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+    size_t m_stocksNum = 0;
+};
+
+// 截面 EWM 在线引擎（结构数组）：全体股票共享同一条 EWM 权重序列与市场序列，替代逐股票的
+// OnlineEWMSum/OnlineEWMSumProduct/OnlineEWMMean/OnlineEWMVar/OnlineEWMCov 节点图
+// 缓存层：X 为 T×N 行主序滚动窗口矩阵（RingMatrix），Y 为长度 T 的共用序列；入窗时 NaN 置 0（NaN 样本不计入，与逐股票节点一致）
+// 方法层：带权和 sum(w x)、sum(w x^2)、sum(w x y) 以长度 N 的连续向量维护：
+// 每次更新先整体乘衰减因子，再逐行减去移出行、加上移入行（AXPY），初始化与整窗重算为 GEMV
+// 权重序列与 OnlineWeightCache 相同（长度为窗口大小x2，按最新半段归一），各统计量与逐股票节点在舍入误差内一致
+class OnlineCrossSectionEWM : public OnlineBaseFactor {
+    public:
+    OnlineCrossSectionEWM(const Ma& initialValueX, const Ve& initialValueY, const Ve& weights) {
+        constructor(initialValueX, initialValueY, weights);
+    }
+    // 构造：initialValueX 为 T×N，initialValueY 长度为 T，weights 长度为 2T（同 BaseFactor::ewm_weights）
+    void constructor(const Ma& initialValueX, const Ve& initialValueY, const Ve& weights);
+    // 更新：inValuesX 为 step×N，inValuesY 长度为 step（代价选择同 OnlineEWMSum）
+    void update(const Ma& inValuesX, const Ve& inValuesY, size_t version);
+    // 重锚：由窗口精确重算带权和，漂移按方差/协方差的变化记录
+    void reanchor() noexcept override;
+
+    // 获取每只股票的值（长度 N）
+    [[nodiscard]] const Ve& getSumX() const noexcept { return m_sumX; }
+    [[nodiscard]] const Ve& getSumXX() const noexcept { return m_sumXX; }
+    [[nodiscard]] const Ve& getSumXY() const noexcept { return m_sumXY; }
+    [[nodiscard]] const Ve& getMeanX() const noexcept { return m_sumX; }
+    [[nodiscard]] const Ve& getVarX() const noexcept { return m_varX; }
+    [[nodiscard]] const Ve& getCovXY() const noexcept { return m_covXY; }
+    // 获取共用序列的值（标量）
+    [[nodiscard]] double getMeanY() const noexcept { return m_sumY; }
+    [[nodiscard]] double getVarY() const noexcept { return m_varY; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 获取股票数量
+    [[nodiscard]] size_t getStocksNum() const noexcept { return m_stocksNum; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算带权和（按逻辑顺序分两段 GEMV）
+    void computeSums() noexcept;
+    // 由带权和刷新方差、协方差（权重和为 1，同 OnlineEWMVar/OnlineEWMCov）
+    void computeStats() noexcept;
+    // 追加一行（NaN 置 0）到滚动窗口，返回写入的 Y 值
+    double pushRow(const RingMatrix::RowRef& rowX, double valueY) noexcept;
+
+    // 权重：归一化序列与未归一化序列（衰减因子），长度 2T
+    Ve m_normedWeights;
+    Ve m_unnormalizedWeights;
+    double m_varianceBesselCorrection = 1.0;
+
+    // 缓存层：X 为 T×N 滚动窗口矩阵，Y 为同步滚动的长度 T 环形缓冲（NaN 均已置 0）
+    RingMatrix m_winX;
+    RingVec<double> m_winY;
+
+    // 方法层：带权和
+    Ve m_sumX;
+    Ve m_sumXX;
+    Ve m_sumXY;
+    double m_sumY = 0.0;
+    double m_sumYY = 0.0;
+
+    // 方法层：派生统计量
+    Ve m_varX;
+    Ve m_covXY;
+    double m_varY = 0.0;
+
+    // 行缓冲与整窗重算的带权 Y 缓冲（构造时预分配，update 不做内存分配）
+    Ve m_rowX;
+    Ve m_weightedY;
+
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+    size_t m_stocksNum = 0;
+};
@@ -1,7 +1,9 @@
 #include "OnlineDataCache.h"
+#include "OnlineCheckpoint.h"
 #include <iostream>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 
 void OnlineDataCache::constructor(const Ve& initialValue){
     if (initialValue.size() <= 1)
@@ -9,31 +11,167 @@ void OnlineDataCache::constructor(const Ve& initialValue){
         std::cout << "OnlineDataCache: 初始值大小小于等于1，无法构造\n";
         exit(1);
     }
-    m_winValues.clear();
-    for(auto val : initialValue){
-        m_winValues.push_back(val);
-    }
     m_windowSize = initialValue.size();
+    m_winValues.resize(static_cast<int>(m_windowSize));
+    m_winValues.assignFromVe(initialValue);
+    // 预分配被挤出值缓冲，update 时只写不分配
+    m_outValues = Ve::Zero(static_cast<Eigen::Index>(m_windowSize));
+    m_inValues = Ve::Zero(static_cast<Eigen::Index>(m_windowSize));
+    m_stepSize = 0;
+    m_outSize = 0;
+    reanchor();
 }
 
 void OnlineDataCache::update(const Ve& inValues, size_t version){
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+    if(isTimeWindow()){
+        std::cout << "OnlineDataCache: 时间窗口须传入时间戳，无法更新\n";
+        exit(1);
+    }
+    const Eigen::Index stepSize = inValues.size();
+    // 步长超过窗口（断流补数、追赶回放）时扩容进出缓冲，被挤出值依次包含本批较早写入的新值；常规步长不分配
+    if(stepSize > m_inValues.size()){
+        m_inValues.resize(stepSize);
+        m_outValues.resize(stepSize);
+    }
+    // 整段写入：被挤出的旧值在前、本批写入即被挤出的新值在后（定长窗口总是满的，挤出个数等于步长）
+    const auto evicted = m_winValues.pushPopN(inValues.data(), static_cast<int>(stepSize));
+    std::copy(evicted.first.first, evicted.first.first + evicted.first.second, m_outValues.data());
+    std::copy(evicted.second.first, evicted.second.first + evicted.second.second, m_outValues.data() + evicted.first.second);
+    m_inValues.head(stepSize) = inValues;
+    m_stepSize = static_cast<size_t>(stepSize);
+    m_outSize = m_stepSize;
+    m_version = version;  // 更新版本号
+}
+
+void OnlineDataCache::constructor(const Ve& initialValue, const Ve& initialTimes, double duration){
+    if (initialValue.size() == 0 || initialValue.size() != initialTimes.size() || !(duration > 0.0))
+    {
+        std::cout << "OnlineDataCache: 时间窗口初始值为空、时间戳长度不一致或时长不为正，无法构造\n";
+        exit(1);
+    }
+    m_duration = duration;
+    // 容量取初始样本数（至少为 2），窗口样本数超过容量时按倍数扩容
+    const int capacity = std::max(2, static_cast<int>(initialValue.size()));
+    m_winValues.resize(capacity);
+    m_winTimes.resize(capacity);
+    m_outValues = Ve::Zero(capacity);
+    m_outTimes = Ve::Zero(capacity);
+    m_inValues = Ve::Zero(capacity);
+    m_inTimes = Ve::Zero(capacity);
+    m_stepSize = 0;
+    m_outSize = 0;
+    for(Eigen::Index i = 0; i < initialValue.size(); ++i){
+        m_winValues.pushPop(initialValue[i]);
+        m_winTimes.pushPop(initialTimes[i]);
+    }
+    // 初始样本中早于窗口的部分直接丢弃
+    const double cutoff = initialTimes[initialTimes.size() - 1] - m_duration;
+    while(m_winTimes.size() > 0 && m_winTimes[0] <= cutoff){
+        m_winValues.popFront();
+        m_winTimes.popFront();
+    }
+    m_windowSize = getCount();
+    reanchor();
+}
+
+void OnlineDataCache::update(const Ve& inValues, const Ve& inTimes, size_t version){
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
     }
-    if(inValues.size() > m_windowSize){
-        std::cout << "OnlineDataCache: 新数据大小大于窗口大小，无法更新\n";
+    if(!isTimeWindow()){
+        std::cout << "OnlineDataCache: 定长窗口不接受时间戳，无法更新\n";
+        exit(1);
+    }
+    if(inValues.size() != inTimes.size()){
+        std::cout << "OnlineDataCache: 新数据与时间戳长度不一致，无法更新\n";
         exit(1);
     }
-    m_outValues.clear();
-    for(auto val : inValues){
-        m_winValues.push_back(val);
-        m_outValues.push_back(m_winValues.front());
-        m_winValues.pop_front();
+    const Eigen::Index stepSize = inValues.size();
+    if(stepSize > m_inValues.size()){
+        m_inValues.resize(stepSize);
+        m_inTimes.resize(stepSize);
+    }
+    for(Eigen::Index i = 0; i < stepSize; ++i){
+        // 窗口已满：按倍数扩容（只在窗口样本数创新高时发生）
+        if(m_winValues.full()){
+            const int capacity = 2 * m_winValues.capacity();
+            m_winValues.reserve(capacity);
+            m_winTimes.reserve(capacity);
+            m_outValues.resize(capacity);
+            m_outTimes.resize(capacity);
+        }
+        m_winValues.pushPop(inValues[i]);
+        m_winTimes.pushPop(inTimes[i]);
+        m_inValues[i] = inValues[i];
+        m_inTimes[i] = inTimes[i];
+    }
+    // 按最新时间戳淘汰：保留 (最新时间 - 时长, 最新时间]，最新样本总在窗口内
+    size_t outSize = 0;
+    if(stepSize > 0){
+        const double cutoff = inTimes[stepSize - 1] - m_duration;
+        while(m_winTimes[0] <= cutoff){
+            m_outTimes[static_cast<Eigen::Index>(outSize)] = m_winTimes.popFront();
+            m_outValues[static_cast<Eigen::Index>(outSize)] = m_winValues.popFront();
+            ++outSize;
+        }
     }
+    m_stepSize = static_cast<size_t>(stepSize);
+    m_outSize = outSize;
     m_version = version;  // 更新版本号
 }
 
+void OnlineDataCache::reanchor() noexcept {
+    double sum = 0.0;
+    size_t validCount = 0;
+    for (auto sample : m_winValues) {
+        if (std::isnan(sample)) { continue; }
+        sum += sample;
+        ++validCount;
+    }
+    m_shift = (validCount > 0) ? (sum / static_cast<double>(validCount)) : 0.0;
+}
+
+void OnlineDataCache::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_winValues, m_shift, m_stepSize, m_outSize, m_duration, m_winTimes, m_windowSize, m_version);
+    if(archive.isRestoring()){
+        // 进出缓冲只需满足容量约定（不小于窗口容量与本次步长），恢复时按需扩容
+        const Eigen::Index capacity = std::max({static_cast<Eigen::Index>(m_winValues.capacity()),
+                                                static_cast<Eigen::Index>(m_stepSize), static_cast<Eigen::Index>(m_outSize)});
+        if(m_inValues.size() < capacity){
+            m_inValues.resize(capacity);
+            m_outValues.resize(capacity);
+        }
+        if(isTimeWindow() && m_inTimes.size() < capacity){
+            m_inTimes.resize(capacity);
+            m_outTimes.resize(capacity);
+        }
+    }
+    // 本次 update 写入/挤出的值只写有效部分（下游节点在下次 update 前仍可读取）
+    archive.array(m_inValues.data(), m_stepSize);
+    archive.array(m_outValues.data(), m_outSize);
+    if(isTimeWindow()){
+        archive.array(m_inTimes.data(), m_stepSize);
+        archive.array(m_outTimes.data(), m_outSize);
+    }
+}
+
+VeView OnlineDataCache::getFirstSegment() const {
+    const auto segment = m_winValues.firstSegment();
+    return VeView(segment.first, segment.second);
+}
+
+VeView OnlineDataCache::getSecondSegment() const {
+    const auto segment = m_winValues.secondSegment();
+    return VeView(segment.first, segment.second);
+}
+
 // OnlineWeightCache 实现
 void OnlineWeightCache::constructor(const Ve& initialValue){
     if (initialValue.size() <= 1)
@@ -64,10 +202,40 @@ void OnlineWeightCache::constructor(const Ve& initialValue){
     m_version = 0;
 }
 
-void OnlineWeightCache::update(size_t version){
+void OnlineWeightCache::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_unnormalizedValues, m_normedValues, m_windowSize, m_version);
+}
+
+void OnlineWeightCache::update(size_t /*version*/){
     // 权重缓存通常不需要更新，因为权重是固定的
-    if (m_version == version){
-        return;
+    // 不写任何成员：同一权重缓存被多只股票的节点共享，需允许多线程并发调用
+}
+
+void OnlineWeightBankCache::constructor(const std::vector<Ve>& initialValues){
+    if (initialValues.empty())
+    {
+        std::cout << "OnlineWeightBankCache: 权重组数为0，无法构造\n";
+        exit(1);
+    }
+    const Eigen::Index length = initialValues.front().size();
+    m_bankSize = static_cast<Eigen::Index>(initialValues.size());
+    m_unnormalizedValues.resize(length, m_bankSize);
+    m_normedValues.resize(length, m_bankSize);
+    for (Eigen::Index k = 0; k < m_bankSize; ++k) {
+        const Ve& weights = initialValues[static_cast<size_t>(k)];
+        if (weights.size() != length) {
+            std::cout << "OnlineWeightBankCache: 各组权重序列长度不一致\n";
+            exit(1);
+        }
+        // 各组归一化方式与单组权重缓存完全相同（逐位一致）
+        const OnlineWeightCache single(weights);
+        m_unnormalizedValues.col(k) = single.getUnnormalizedValues().array();
+        m_normedValues.col(k) = single.getNormedValues().array();
     }
-    m_version = version;
+    m_windowSize = static_cast<size_t>(length);
+}
+
+void OnlineWeightBankCache::checkpointState(OnlineCheckpoint& archive) {
+    archive.array(m_unnormalizedValues.data(), static_cast<size_t>(m_unnormalizedValues.size()));
+    archive.array(m_normedValues.data(), static_cast<size_t>(m_normedValues.size()));
 }
\ No newline at end of file
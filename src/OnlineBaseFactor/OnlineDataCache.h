@@ -1,45 +1,126 @@
 #pragma once
 #include "OnlineBaseFactor.h"
 #include "../Eigen_extra/Eigen_extra.h"
-#include <deque>
+#include "../Eigen_extra/RingVec.h"
+#include "OnlineArena.h"
 #include <functional>
 
 using namespace EigenExtra;
 
-// 数据缓存层：维护滑动窗口历史数据缓存
+// 数据缓存层：维护滑动窗口历史数据缓存（连续环形存储，update 不做内存分配）
+// 两种窗口：
+// - 定长窗口：保留最近 W 个样本，每次写入多少个就挤出多少个
+// - 时间窗口：每个样本带时间戳，保留 (最新时间 - 时长, 最新时间] 内的样本，每次挤出个数可变（窗口样本数超过容量时扩容）
+// 方法层按 getInValues / getOutValues 分别加入、移出，按 getCount 取当前样本数，两种窗口共用同一套增量逻辑
 class OnlineDataCache : public OnlineBaseFactor{
     public:
     OnlineDataCache(const Ve& initialValue) { constructor(initialValue); }
+    // 时间窗口：initialTimes 为各样本时间戳（单调不减），duration 为窗口时长（与时间戳同单位）
+    OnlineDataCache(const Ve& initialValue, const Ve& initialTimes, double duration) { constructor(initialValue, initialTimes, duration); }
     void constructor(const Ve& initialValue);
+    void constructor(const Ve& initialValue, const Ve& initialTimes, double duration);
+    // 定长窗口更新
     void update(const Ve& inValues, size_t version);
-    [[nodiscard]] const std::deque<double>& getValues() const {return m_winValues;}
-    [[nodiscard]] const std::deque<double>& getOutValues() const {return m_outValues;}
-    [[nodiscard]] size_t getWindowSize() const {return m_windowSize;}
+    // 时间窗口更新：先写入新样本，再按最新时间戳淘汰过期样本
+    // 方法层的 update 只传数值，须先由调用方（或编译模式）以同一版本号调用本函数
+    void update(const Ve& inValues, const Ve& inTimes, size_t version);
+    // 窗口数据（逻辑顺序：最旧 -> 最新），可按下标或分段视图访问
+    [[nodiscard]] const RingVec<double>& getValues() const {return m_winValues;}
+    // 本次 update 被挤出的旧值（零拷贝视图，定长窗口长度等于本次步长，下次 update 前有效）
+    [[nodiscard]] VeView getOutValues() const {return VeView(m_outValues.data(), static_cast<Eigen::Index>(m_outSize));}
+    // 本次 update 写入的新值（零拷贝视图，长度等于本次步长，下次 update 前有效）
+    [[nodiscard]] VeView getInValues() const {return VeView(m_inValues.data(), static_cast<Eigen::Index>(m_stepSize));}
+    // 窗口数据的两段物理连续视图（拼接后即逻辑顺序）
+    [[nodiscard]] VeView getFirstSegment() const;
+    [[nodiscard]] VeView getSecondSegment() const;
+    // 窗口大小：定长窗口为 W，时间窗口为当前样本数
+    [[nodiscard]] size_t getWindowSize() const {return isTimeWindow() ? getCount() : m_windowSize;}
+    // 当前样本数（含 NaN）
+    [[nodiscard]] size_t getCount() const {return static_cast<size_t>(m_winValues.size());}
+    // 是否为时间窗口
+    [[nodiscard]] bool isTimeWindow() const {return m_duration > 0.0;}
+    // 时间窗口：窗口时长、各样本时间戳（与 getValues 逐一对应）、本次写入/淘汰样本的时间戳
+    [[nodiscard]] double getDuration() const {return m_duration;}
+    [[nodiscard]] const RingVec<double>& getTimes() const {return m_winTimes;}
+    [[nodiscard]] VeView getInTimes() const {return VeView(m_inTimes.data(), static_cast<Eigen::Index>(m_stepSize));}
+    [[nodiscard]] VeView getOutTimes() const {return VeView(m_outTimes.data(), static_cast<Eigen::Index>(m_outSize));}
+    // 平移量（锚点）：方法层以 x - 平移量 累加，避免价格量级数据在方差公式中相消
+    [[nodiscard]] double getShift() const {return m_shift;}
+    // 重锚：平移量取当前窗口（有效值）均值
+    void reanchor() noexcept override;
 
     private:
-    std::deque<double> m_winValues;
-    std::deque<double> m_outValues;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    // 窗口缓冲在成员初始化时取构造所用的内存资源（经 OnlineArena::create 创建时与节点同处一个内存池）
+    RingVec<double> m_winValues{OnlineArena::constructionResource()};
+    double m_shift = 0.0;
+    // 被挤出值的预分配缓冲（容量为窗口大小，步长更大时扩容），有效长度为 m_stepSize
+    Ve m_outValues;
+    // 新写入值的预分配缓冲（容量为窗口大小，步长更大时扩容），有效长度为 m_stepSize
+    Ve m_inValues;
+    size_t m_stepSize = 0;
+    size_t m_outSize = 0;
+    // 时间窗口：时长（0 为定长窗口）、样本时间戳及本次写入/淘汰样本的时间戳
+    double m_duration = 0.0;
+    RingVec<double> m_winTimes{OnlineArena::constructionResource()};
+    Ve m_inTimes;
+    Ve m_outTimes;
     size_t m_windowSize = 0;
     size_t m_version = 0;
 };
 
 class OnlineWeightCache : public OnlineBaseFactor{
-// 权重系数缓存层：维护窗口长度大小x2的权重系数序列(todo：目前实现的窗口固定模式，待续)
+// 权重系数缓存层：维护窗口长度大小x2的权重系数序列（定长窗口，按位置给权重；时间窗口的时间衰减权重见 OnlineTimeEWM）
     public:
     // 构造函数1：直接传入初始权重序列
     OnlineWeightCache(const Ve& initialValue) { constructor(initialValue); }
     void constructor(const Ve& initialValue);
 
-    void update(size_t version);//todo：未必需要实现
+    void update(size_t version);  // 权重固定，空操作（保留以统一节点接口）
     [[nodiscard]] const Ve& getUnnormalizedValues() const {return m_unnormalizedValues;}
     [[nodiscard]] const Ve& getNormedValues() const {return m_normedValues;}
     [[nodiscard]] size_t getWindowSize() const {return m_windowSize;}
 
     private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     // 未归一化的值
     Ve m_unnormalizedValues;
     // 归一化的值
     Ve m_normedValues;
     size_t m_windowSize = 0;
     size_t m_version = 0;
+};
+
+class OnlineWeightBankCache : public OnlineBaseFactor{
+// 多半衰期权重缓存层：K 组权重系数序列（各组同 OnlineWeightCache，长度为窗口大小x2）按位置行优先存放
+// 同一位置的 K 个权重在内存中连续，方法层可沿半衰期维度整行向量化
+    public:
+    // 行优先权重表：行为位置（长度x2），列为各组权重
+    using WeightTable = Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    // 构造：initialValues 为各组初始权重序列（长度须一致）
+    OnlineWeightBankCache(const std::vector<Ve>& initialValues) { constructor(initialValues); }
+    void constructor(const std::vector<Ve>& initialValues);
+
+    // 第 position 个位置的 K 个权重（连续内存）
+    [[nodiscard]] Eigen::Map<const Eigen::ArrayXd> getUnnormalizedRow(Eigen::Index position) const {
+        return Eigen::Map<const Eigen::ArrayXd>(m_unnormalizedValues.data() + position * m_bankSize, m_bankSize);
+    }
+    [[nodiscard]] Eigen::Map<const Eigen::ArrayXd> getNormedRow(Eigen::Index position) const {
+        return Eigen::Map<const Eigen::ArrayXd>(m_normedValues.data() + position * m_bankSize, m_bankSize);
+    }
+    [[nodiscard]] const WeightTable& getNormedValues() const {return m_normedValues;}
+    // 权重组数 K
+    [[nodiscard]] Eigen::Index getBankSize() const {return m_bankSize;}
+    [[nodiscard]] size_t getWindowSize() const {return m_windowSize;}
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    WeightTable m_unnormalizedValues;
+    WeightTable m_normedValues;
+    Eigen::Index m_bankSize = 0;
+    size_t m_windowSize = 0;
 };
\ No newline at end of file
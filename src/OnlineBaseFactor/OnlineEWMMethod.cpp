@@ -1,16 +1,24 @@
 #include "OnlineEWMMethod.h"
+#include "OnlineCheckpoint.h"
 #include "OnlineUtils.h"
+#include "OnlineSimdKernels.h"
 #include "BaseFactor/BaseFactor.h"
 #include <numeric>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <algorithm>
 
 // OnlineEWMSum 带权加和（EWM加权和）
 void OnlineEWMSum::constructor(const Window& window) {
     // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
     CHECK_NULLPTR("OnlineEWMSum", window.m_onlineDataCache);
     CHECK_NULLPTR("OnlineEWMSum", window.m_onlineWeightCache);
+    // 权重按窗口位置取值，只支持定长窗口（时间窗口使用 OnlineTimeEWM）
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineEWMSum: 不支持时间窗口缓存\n";
+        exit(1);
+    }
     
     m_window = window;
     
@@ -19,20 +27,13 @@ void OnlineEWMSum::constructor(const Window& window) {
     m_windowSize = dataWindowSize;
     
     // 使用compute函数计算初始带权加和
-    const auto& dataValues = m_window.m_onlineDataCache->getValues();
-    const auto& weightValues = m_window.m_onlineWeightCache->getNormedValues();
-    
-    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
-    // 数据索引0对应权重索引0+windowsize（最旧的数据）
-    for (size_t i = 0; i < dataValues.size(); ++i) {
-        if(std::isnan(dataValues[i])){continue;}
-        m_value += weightValues[i + m_windowSize] * dataValues[i];
-    }
+    m_value = computeExactValue();
     
     m_version = 0;
 }
 
 void OnlineEWMSum::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -41,9 +42,20 @@ void OnlineEWMSum::update(const Ve& inValues, size_t version) noexcept {
     // 更新下游组件（缓存层）
     m_window.m_onlineDataCache->update(inValues, version);
     m_window.m_onlineWeightCache->update(version);
-    
-    // 增量更新：加上新值的加权和，减去旧值的加权和
+    step(version);
+}
+
+void OnlineEWMSum::step(size_t version) noexcept {
     const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 代价选择：增量每个样本进、出各一次加权，重算每个窗口样本一次（步长超过窗口时增量权重下标越界，必走重算）
+    if(preferRecompute(inValues.size(), m_windowSize, 2.0, 1.0)){
+        m_value = computeExactValue();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：加上新值的加权和，减去旧值的加权和
     const auto& unnormalizedWeightValues = m_window.m_onlineWeightCache->getUnnormalizedValues();
     const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
     computeEWMSum(outValues, unnormalizedWeightValues, normedWeightValues, inValues, m_windowSize, m_value);
@@ -51,9 +63,52 @@ void OnlineEWMSum::update(const Ve& inValues, size_t version) noexcept {
     m_version = version;  // 更新版本号
 }
 
-inline void OnlineEWMSum::computeEWMSum(const std::deque<double>& outValues, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues, const Ve& inValues, size_t windowSize, double& Value) noexcept {
+void OnlineEWMSum::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineEWMSum::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+void OnlineEWMSum::reanchor() noexcept {
+    const double incrementalValue = m_value;
+    m_value = computeExactValue();
+    recordDrift(incrementalValue, m_value);
+}
+
+double OnlineEWMSum::computeExactValue() const noexcept {
+    const auto& dataValues = m_window.m_onlineDataCache->getValues();
+    const auto& weightValues = m_window.m_onlineWeightCache->getNormedValues();
+    
+    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
+    // 数据索引0对应权重索引0+windowsize（最旧的数据）
+    if (m_windowSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 环形缓冲按两段连续内存走向量内核
+        const VeView first = m_window.m_onlineDataCache->getFirstSegment();
+        const VeView second = m_window.m_onlineDataCache->getSecondSegment();
+        const double* weights = weightValues.data() + m_windowSize;
+        return OnlineSimd::weightedSum(weights, first.data(), static_cast<size_t>(first.size())) +
+               OnlineSimd::weightedSum(weights + first.size(), second.data(), static_cast<size_t>(second.size()));
+    }
+    double value = 0.0;
+    for (size_t i = 0; i < dataValues.size(); ++i) {
+        if(std::isnan(dataValues[i])){continue;}
+        value += weightValues[i + m_windowSize] * dataValues[i];
+    }
+    return value;
+}
+
+inline void OnlineEWMSum::computeEWMSum(const VeView& outValues, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues, const VeView& inValues, size_t windowSize, double& Value) noexcept {
     const size_t stepSize = inValues.size();
     Value *= unnormalizedWeightValues[(2*windowSize) - stepSize - 1];
+    if (stepSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 大步长：向量内核（NaN 无分支屏蔽）
+        Value -= OnlineSimd::weightedSum(normedWeightValues.data() + windowSize - stepSize, outValues.data(), static_cast<size_t>(outValues.size()));
+        Value += OnlineSimd::weightedSum(normedWeightValues.data() + (2*windowSize) - stepSize, inValues.data(), stepSize);
+        return;
+    }
     // 减去旧值的加权和
     for (size_t i = 0; i < outValues.size(); ++i) {
         if(std::isnan(outValues[i])){continue;}
@@ -72,6 +127,11 @@ void OnlineEWMSumProduct::constructor(const Window& window) {
     CHECK_NULLPTR("OnlineEWMSumProduct", window.m_onlineDataCacheX);
     CHECK_NULLPTR("OnlineEWMSumProduct", window.m_onlineDataCacheY);
     CHECK_NULLPTR("OnlineEWMSumProduct", window.m_onlineWeightCache);
+    // 权重按窗口位置取值，只支持定长窗口（时间窗口使用 OnlineTimeEWM）
+    if(window.m_onlineDataCacheX->isTimeWindow() || window.m_onlineDataCacheY->isTimeWindow()){
+        std::cout << "OnlineEWMSumProduct: 不支持时间窗口缓存\n";
+        exit(1);
+    }
     
     m_window = window;
     
@@ -85,21 +145,13 @@ void OnlineEWMSumProduct::constructor(const Window& window) {
     m_windowSize = windowSizeX;
     
     // 使用计算初始带权乘积和
-    const auto& dataValuesX = m_window.m_onlineDataCacheX->getValues();
-    const auto& dataValuesY = m_window.m_onlineDataCacheY->getValues();
-    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
-    
-    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
-    // 数据索引0对应权重索引0（最旧的数据）
-    for (size_t i = 0; i < dataValuesX.size(); ++i) {
-        if(std::isnan(dataValuesX[i]) || std::isnan(dataValuesY[i])){continue;}
-        m_value += normedWeightValues[i+m_windowSize] * dataValuesX[i] * dataValuesY[i];
-    }
+    m_value = computeExactValue();
     
     m_version = 0;
 }
 
 void OnlineEWMSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -113,10 +165,22 @@ void OnlineEWMSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_
     // 更新下游组件（缓存层）
     m_window.m_onlineDataCacheX->update(inValuesX, version);
     m_window.m_onlineDataCacheY->update(inValuesY, version);
-    
+    step(version);
+}
+
+void OnlineEWMSumProduct::step(size_t version) noexcept {
+    // 代价选择：同 OnlineEWMSum
+    if(preferRecompute(m_window.m_onlineDataCacheX->getInValues().size(), m_windowSize, 2.0, 1.0)){
+        m_value = computeExactValue();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
     // 增量更新：加上新值的加权乘积和，减去旧值的加权乘积和
     const auto& outValuesX = m_window.m_onlineDataCacheX->getOutValues();
     const auto& outValuesY = m_window.m_onlineDataCacheY->getOutValues();
+    const auto& inValuesX = m_window.m_onlineDataCacheX->getInValues();
+    const auto& inValuesY = m_window.m_onlineDataCacheY->getInValues();
     const auto& unnormalizedWeightValues = m_window.m_onlineWeightCache->getUnnormalizedValues();
     const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
 
@@ -125,11 +189,58 @@ void OnlineEWMSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_
     m_version = version;  // 更新版本号
 }
 
-inline void OnlineEWMSumProduct::computeEWMSumProduct(const std::deque<double>& outValuesX, const std::deque<double>& outValuesY, 
+void OnlineEWMSumProduct::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineDataCacheX.get());
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+}
+
+void OnlineEWMSumProduct::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+void OnlineEWMSumProduct::reanchor() noexcept {
+    const double incrementalValue = m_value;
+    m_value = computeExactValue();
+    recordDrift(incrementalValue, m_value);
+}
+
+double OnlineEWMSumProduct::computeExactValue() const noexcept {
+    const auto& dataValuesX = m_window.m_onlineDataCacheX->getValues();
+    const auto& dataValuesY = m_window.m_onlineDataCacheY->getValues();
+    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
+    
+    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
+    // 数据索引0对应权重索引0（最旧的数据）
+    const VeView firstX = m_window.m_onlineDataCacheX->getFirstSegment();
+    const VeView firstY = m_window.m_onlineDataCacheY->getFirstSegment();
+    if (m_windowSize >= OnlineSimd::MIN_VECTOR_STEP && firstX.size() == firstY.size()) {
+        // 两个缓存的环回位置一致时按两段连续内存走向量内核
+        const VeView secondX = m_window.m_onlineDataCacheX->getSecondSegment();
+        const VeView secondY = m_window.m_onlineDataCacheY->getSecondSegment();
+        const double* weights = normedWeightValues.data() + m_windowSize;
+        return OnlineSimd::weightedSum(weights, firstX.data(), firstY.data(), static_cast<size_t>(firstX.size())) +
+               OnlineSimd::weightedSum(weights + firstX.size(), secondX.data(), secondY.data(), static_cast<size_t>(secondX.size()));
+    }
+    double value = 0.0;
+    for (size_t i = 0; i < dataValuesX.size(); ++i) {
+        if(std::isnan(dataValuesX[i]) || std::isnan(dataValuesY[i])){continue;}
+        value += normedWeightValues[i+m_windowSize] * dataValuesX[i] * dataValuesY[i];
+    }
+    return value;
+}
+
+inline void OnlineEWMSumProduct::computeEWMSumProduct(const VeView& outValuesX, const VeView& outValuesY, 
                                                 const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
-                                                const Ve& inValuesX, const Ve& inValuesY, size_t windowSize, double& Value) noexcept {
+                                                const VeView& inValuesX, const VeView& inValuesY, size_t windowSize, double& Value) noexcept {
     const size_t stepSize = inValuesX.size();
     Value *= unnormalizedWeightValues[(2*windowSize) - stepSize - 1];
+    if (stepSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 大步长：向量内核（NaN 无分支屏蔽）
+        Value -= OnlineSimd::weightedSum(normedWeightValues.data() + windowSize - stepSize, outValuesX.data(), outValuesY.data(), static_cast<size_t>(outValuesX.size()));
+        Value += OnlineSimd::weightedSum(normedWeightValues.data() + (2*windowSize) - stepSize, inValuesX.data(), inValuesY.data(), stepSize);
+        return;
+    }
     for (size_t i = 0; i < outValuesX.size(); ++i) {
         if(std::isnan(outValuesX[i]) || std::isnan(outValuesY[i])){continue;}
         Value -= normedWeightValues[windowSize - stepSize + i] * outValuesX[i] * outValuesY[i];
@@ -148,6 +259,11 @@ void OnlineEWMSumProduct3::constructor(const Window& window) {
     CHECK_NULLPTR("OnlineEWMSumProduct3", window.m_onlineDataCacheY);
     CHECK_NULLPTR("OnlineEWMSumProduct3", window.m_onlineDataCacheZ);
     CHECK_NULLPTR("OnlineEWMSumProduct3 ", window.m_onlineWeightCache);
+    // 权重按窗口位置取值，只支持定长窗口（时间窗口使用 OnlineTimeEWM）
+    if(window.m_onlineDataCacheX->isTimeWindow() || window.m_onlineDataCacheY->isTimeWindow() || window.m_onlineDataCacheZ->isTimeWindow()){
+        std::cout << "OnlineEWMSumProduct3: 不支持时间窗口缓存\n";
+        exit(1);
+    }
     
     m_window = window;
     
@@ -162,22 +278,13 @@ void OnlineEWMSumProduct3::constructor(const Window& window) {
     m_windowSize = windowSizeX;
     
     // 使用计算初始带权乘积和
-    const auto& dataValuesX = m_window.m_onlineDataCacheX->getValues();
-    const auto& dataValuesY = m_window.m_onlineDataCacheY->getValues();
-    const auto& dataValuesZ = m_window.m_onlineDataCacheZ->getValues();
-    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
-    
-    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
-    // 数据索引0对应权重索引0（最旧的数据）
-    for (size_t i = 0; i < dataValuesX.size(); ++i) {
-        if(std::isnan(dataValuesX[i]) || std::isnan(dataValuesY[i]) || std::isnan(dataValuesZ[i])){continue;}
-        m_value += normedWeightValues[i+m_windowSize] * dataValuesX[i] * dataValuesY[i] * dataValuesZ[i];
-    }
+    m_value = computeExactValue();
     
     m_version = 0;
 }
 
 void OnlineEWMSumProduct3::update(const Ve& inValuesX, const Ve& inValuesY, const Ve& inValuesZ, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -192,10 +299,24 @@ void OnlineEWMSumProduct3::update(const Ve& inValuesX, const Ve& inValuesY, cons
     m_window.m_onlineDataCacheX->update(inValuesX, version);
     m_window.m_onlineDataCacheY->update(inValuesY, version);
     m_window.m_onlineDataCacheZ->update(inValuesZ, version);
+    step(version);
+}
+
+void OnlineEWMSumProduct3::step(size_t version) noexcept {
+    // 代价选择：同 OnlineEWMSum
+    if(preferRecompute(m_window.m_onlineDataCacheX->getInValues().size(), m_windowSize, 2.0, 1.0)){
+        m_value = computeExactValue();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
     // 增量更新：加上新值的加权乘积和，减去旧值的加权乘积和
     const auto& outValuesX = m_window.m_onlineDataCacheX->getOutValues();
     const auto& outValuesY = m_window.m_onlineDataCacheY->getOutValues();
     const auto& outValuesZ = m_window.m_onlineDataCacheZ->getOutValues();
+    const auto& inValuesX = m_window.m_onlineDataCacheX->getInValues();
+    const auto& inValuesY = m_window.m_onlineDataCacheY->getInValues();
+    const auto& inValuesZ = m_window.m_onlineDataCacheZ->getInValues();
     const auto& unnormalizedWeightValues = m_window.m_onlineWeightCache->getUnnormalizedValues();
     const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
 
@@ -204,11 +325,62 @@ void OnlineEWMSumProduct3::update(const Ve& inValuesX, const Ve& inValuesY, cons
     m_version = version;  // 更新版本号
 }
 
-inline void OnlineEWMSumProduct3::computeEWMSumProduct(const std::deque<double>& outValuesX, const std::deque<double>& outValuesY, 
-                                                const std::deque<double>& outValuesZ, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
-                                                const Ve& inValuesX, const Ve& inValuesY, const Ve& inValuesZ, size_t windowSize, double& Value) noexcept {
+void OnlineEWMSumProduct3::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineDataCacheX.get());
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+    inputs.push_back(m_window.m_onlineDataCacheZ.get());
+}
+
+void OnlineEWMSumProduct3::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+void OnlineEWMSumProduct3::reanchor() noexcept {
+    const double incrementalValue = m_value;
+    m_value = computeExactValue();
+    recordDrift(incrementalValue, m_value);
+}
+
+double OnlineEWMSumProduct3::computeExactValue() const noexcept {
+    const auto& dataValuesX = m_window.m_onlineDataCacheX->getValues();
+    const auto& dataValuesY = m_window.m_onlineDataCacheY->getValues();
+    const auto& dataValuesZ = m_window.m_onlineDataCacheZ->getValues();
+    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
+    
+    // 权重序列的前windowSize个对应当前窗口的数据（从旧到新）
+    // 数据索引0对应权重索引0（最旧的数据）
+    const VeView firstX = m_window.m_onlineDataCacheX->getFirstSegment();
+    const VeView firstY = m_window.m_onlineDataCacheY->getFirstSegment();
+    const VeView firstZ = m_window.m_onlineDataCacheZ->getFirstSegment();
+    if (m_windowSize >= OnlineSimd::MIN_VECTOR_STEP && firstX.size() == firstY.size() && firstX.size() == firstZ.size()) {
+        // 三个缓存的环回位置一致时按两段连续内存走向量内核
+        const VeView secondX = m_window.m_onlineDataCacheX->getSecondSegment();
+        const VeView secondY = m_window.m_onlineDataCacheY->getSecondSegment();
+        const VeView secondZ = m_window.m_onlineDataCacheZ->getSecondSegment();
+        const double* weights = normedWeightValues.data() + m_windowSize;
+        return OnlineSimd::weightedSum(weights, firstX.data(), firstY.data(), firstZ.data(), static_cast<size_t>(firstX.size())) +
+               OnlineSimd::weightedSum(weights + firstX.size(), secondX.data(), secondY.data(), secondZ.data(), static_cast<size_t>(secondX.size()));
+    }
+    double value = 0.0;
+    for (size_t i = 0; i < dataValuesX.size(); ++i) {
+        if(std::isnan(dataValuesX[i]) || std::isnan(dataValuesY[i]) || std::isnan(dataValuesZ[i])){continue;}
+        value += normedWeightValues[i+m_windowSize] * dataValuesX[i] * dataValuesY[i] * dataValuesZ[i];
+    }
+    return value;
+}
+
+inline void OnlineEWMSumProduct3::computeEWMSumProduct(const VeView& outValuesX, const VeView& outValuesY, 
+                                                const VeView& outValuesZ, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
+                                                const VeView& inValuesX, const VeView& inValuesY, const VeView& inValuesZ, size_t windowSize, double& Value) noexcept {
     const size_t stepSize = inValuesX.size();
     Value *= unnormalizedWeightValues[(2*windowSize) - stepSize - 1];
+    if (stepSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 大步长：向量内核（NaN 无分支屏蔽）
+        Value -= OnlineSimd::weightedSum(normedWeightValues.data() + windowSize - stepSize, outValuesX.data(), outValuesY.data(), outValuesZ.data(), static_cast<size_t>(outValuesX.size()));
+        Value += OnlineSimd::weightedSum(normedWeightValues.data() + (2*windowSize) - stepSize, inValuesX.data(), inValuesY.data(), inValuesZ.data(), stepSize);
+        return;
+    }
     for (size_t i = 0; i < outValuesX.size(); ++i) {
         if(std::isnan(outValuesX[i]) || std::isnan(outValuesY[i]) || std::isnan(outValuesZ[i])){continue;}
         Value -= normedWeightValues[windowSize - stepSize + i] * outValuesX[i] * outValuesY[i] * outValuesZ[i];
@@ -238,6 +410,7 @@ void OnlineEWMMean::constructor(const Window& window) {
 }
 
 void OnlineEWMMean::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -245,13 +418,25 @@ void OnlineEWMMean::update(const Ve& inValues, size_t version) noexcept {
 
     // 更新下游组件（方法层）
     m_window.m_onlineEWMSum->update(inValues, version);
+    step(version);
+}
 
+void OnlineEWMMean::step(size_t version) noexcept {
     // 使用compute函数更新自己的值（使用构造时确定的窗口大小）
     const double sum = m_window.m_onlineEWMSum->getValue();
     m_value = computeEWMMean(sum, m_weightSum);
     m_version = version;  // 更新版本号
 }
 
+void OnlineEWMMean::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineEWMSum.get());
+}
+
+void OnlineEWMMean::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize, m_weightSum);
+}
+
 inline double OnlineEWMMean::computeEWMMean(double sum, double weightSum) noexcept {
     if (weightSum <= 0.0 || std::isnan(sum)) {
         return std::numeric_limits<double>::quiet_NaN();
@@ -284,6 +469,7 @@ void OnlineEWMVar::constructor(const Window& window) {
 }
 
 void OnlineEWMVar::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -292,17 +478,24 @@ void OnlineEWMVar::update(const Ve& inValues, size_t version) noexcept {
     // 更新下游组件（方法层）
     m_window.m_onlineEWMMean->update(inValues, version);
     m_window.m_onlineEWMSumProduct->update(inValues, inValues, version);
+    step(version);
+}
+
+void OnlineEWMVar::step(size_t version) noexcept {
     const double weightedMean = m_window.m_onlineEWMMean->getValue();
     const double weightedSumSquares = m_window.m_onlineEWMSumProduct->getValue();
     m_value = computeEWMVar(weightedMean, weightedSumSquares, m_weightSum, m_varianceBesselCorrection);
-    //debug
-    // std::cout << "weightedMean = " << weightedMean << std::endl;
-    // std::cout << "weightedSumSquares = " << weightedSumSquares << std::endl;
-    // std::cout << "m_weightSum = " << m_weightSum << std::endl;
-    // std::cout << "m_varianceBesselCorrection = " << m_varianceBesselCorrection << std::endl;
-    // std::cout << "m_value = " << m_value << std::endl;
-    // std::cout << "================================================" << std::endl;
-    // m_version = version;  // 更新版本号
+    m_version = version;  // 更新版本号
+}
+
+void OnlineEWMVar::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineEWMMean.get());
+    inputs.push_back(m_window.m_onlineEWMSumProduct.get());
+}
+
+void OnlineEWMVar::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize, m_weightSum, m_varianceBesselCorrection);
 }
 
 inline double OnlineEWMVar::computeEWMVar(double mean, double sumSquares, double weightSum, double varianceBesselCorrection) noexcept {
@@ -353,6 +546,7 @@ void OnlineEWMCov::constructor(const Window& window) {
 }
 
 void OnlineEWMCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -362,7 +556,10 @@ void OnlineEWMCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t versi
     m_window.m_onlineEWMMeanX->update(inValuesX, version);
     m_window.m_onlineEWMMeanY->update(inValuesY, version);
     m_window.m_onlineEWMSumProductXY->update(inValuesX, inValuesY, version);
-    
+    step(version);
+}
+
+void OnlineEWMCov::step(size_t version) noexcept {
     const double weightedMeanX = m_window.m_onlineEWMMeanX->getValue();
     const double weightedMeanY = m_window.m_onlineEWMMeanY->getValue();
     const double weightedSumXY = m_window.m_onlineEWMSumProductXY->getValue();
@@ -371,6 +568,17 @@ void OnlineEWMCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t versi
     m_version = version;  // 更新版本号
 }
 
+void OnlineEWMCov::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineEWMMeanX.get());
+    inputs.push_back(m_window.m_onlineEWMMeanY.get());
+    inputs.push_back(m_window.m_onlineEWMSumProductXY.get());
+}
+
+void OnlineEWMCov::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize, m_weightSum, m_varianceBesselCorrection);
+}
+
 inline double OnlineEWMCov::computeEWMCov(double sumXY, double meanX, double meanY, double weightSum, double varianceBesselCorrection) noexcept {
     if (weightSum <= 0.0 || std::isnan(sumXY) || std::isnan(meanX) || std::isnan(meanY)) {
         return std::numeric_limits<double>::quiet_NaN();
@@ -406,6 +614,7 @@ void OnlineEWMSkew::constructor(const Window& window) {
 }
 
 void OnlineEWMSkew::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if (m_version == version) {
         return;
@@ -415,7 +624,10 @@ void OnlineEWMSkew::update(const Ve& inValues, size_t version) noexcept {
     m_window.m_onlineEWMMean->update(inValues, version);
     m_window.m_onlineEWMSumProduct->update(inValues, inValues, version);
     m_window.m_onlineEWMSumProduct3->update(inValues, inValues, inValues, version);
+    step(version);
+}
 
+void OnlineEWMSkew::step(size_t version) noexcept {
     const double weightedMean = m_window.m_onlineEWMMean->getValue();
     const double weightedSumProduct = m_window.m_onlineEWMSumProduct->getValue();
     const double weightedSumProduct3 = m_window.m_onlineEWMSumProduct3->getValue();
@@ -423,6 +635,17 @@ void OnlineEWMSkew::update(const Ve& inValues, size_t version) noexcept {
     m_version = version;  // 更新版本号
 }
 
+void OnlineEWMSkew::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineEWMMean.get());
+    inputs.push_back(m_window.m_onlineEWMSumProduct.get());
+    inputs.push_back(m_window.m_onlineEWMSumProduct3.get());
+}
+
+void OnlineEWMSkew::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize, m_weightSum, m_weightedSkewBesselCorrection);
+}
+
 inline double OnlineEWMSkew::computeEWMSkew(double mean, double sumProduct, double sumProduct3, double weightSum, double weightedSkewBesselCorrection) noexcept {
     if (std::isnan(mean) || std::isnan(sumProduct) || std::isnan(sumProduct3) || weightSum <= 0.0){
         return std::numeric_limits<double>::quiet_NaN();
@@ -436,4 +659,762 @@ inline double OnlineEWMSkew::computeEWMSkew(double mean, double sumProduct, doub
     }
 
     return (m3 / std::sqrt(m2 * m2 * m2)) * weightedSkewBesselCorrection;
-}
\ No newline at end of file
+}
+// OnlineEWMMoments 带权多阶矩（一至四阶幂和）
+void OnlineEWMMoments::constructor(const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineEWMMoments", window.m_onlineDataCache);
+    CHECK_NULLPTR("OnlineEWMMoments", window.m_onlineWeightCache);
+    // 权重按窗口位置取值，只支持定长窗口（时间窗口使用 OnlineTimeEWM）
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineEWMMoments: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+
+    // 无偏系数（同 OnlineEWMVar / OnlineEWMSkew）
+    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
+    BaseFactor::weighted_variance_unbiased_coef(normedWeightValues.tail(m_windowSize), m_varianceBesselCorrection);
+    m_weightedSkewBesselCorrection = BaseFactor::computeWeightedSkewBesselCorrection(normedWeightValues.tail(m_windowSize));
+
+    computeExactSums();
+    m_version = 0;
+}
+
+void OnlineEWMMoments::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    m_window.m_onlineWeightCache->update(version);
+    step(version);
+}
+
+void OnlineEWMMoments::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 代价选择：同 OnlineEWMSum
+    if(preferRecompute(inValues.size(), m_windowSize, 2.0, 1.0)){
+        computeExactSums();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：各阶整体衰减一次，进出样本各读一次
+    const auto& unnormalizedWeightValues = m_window.m_onlineWeightCache->getUnnormalizedValues();
+    const auto& normedWeightValues = m_window.m_onlineWeightCache->getNormedValues();
+    const size_t stepSize = inValues.size();
+    const double decay = unnormalizedWeightValues[(2*m_windowSize) - stepSize - 1];
+    for (double& sum : m_sums) {
+        sum *= decay;
+    }
+    if (stepSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 大步长：向量内核（各阶与 OnlineEWMSum / OnlineEWMSumProduct / OnlineEWMSumProduct3 的向量路径一致）
+        double outSums[ORDERS];
+        double inSums[ORDERS];
+        OnlineSimd::weightedPowerSums(normedWeightValues.data() + m_windowSize - stepSize, outValues.data(), static_cast<size_t>(outValues.size()), outSums);
+        OnlineSimd::weightedPowerSums(normedWeightValues.data() + (2*m_windowSize) - stepSize, inValues.data(), stepSize, inSums);
+        for (size_t k = 0; k < ORDERS; ++k) {
+            m_sums[k] -= outSums[k];
+            m_sums[k] += inSums[k];
+        }
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 减去旧值的加权幂和：k 阶为 fma(w x^(k-1), x, 和)，乘积逐阶累乘（同向量内核）
+    for (Eigen::Index i = 0; i < outValues.size(); ++i) {
+        const double value = outValues[i];
+        if(std::isnan(value)){continue;}
+        double product = normedWeightValues[m_windowSize - stepSize + i];
+        for (double& sum : m_sums) {
+            sum = std::fma(-product, value, sum);
+            product *= value;
+        }
+    }
+    // 加上新值的加权幂和（使用权重序列的后windowSize个，对应新窗口位置）
+    for (size_t i = 0; i < stepSize; ++i) {
+        const double value = inValues[i];
+        if(std::isnan(value)){continue;}
+        double product = normedWeightValues[(2*m_windowSize) - stepSize + i];
+        for (double& sum : m_sums) {
+            sum = std::fma(product, value, sum);
+            product *= value;
+        }
+    }
+    m_version = version;  // 更新版本号
+}
+
+double OnlineEWMMoments::getMean() const noexcept {
+    // 权重和为 1（同 OnlineEWMMean）
+    if(std::isnan(m_sums[0])){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return m_sums[0];
+}
+
+double OnlineEWMMoments::getVar() const noexcept {
+    // 同 OnlineEWMVar（权重和为 1）
+    const double mean = getMean();
+    if(std::isnan(mean) || std::isnan(m_sums[1])){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double var = m_sums[1] - mean * mean;
+    if(std::isnan(var)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return var * m_varianceBesselCorrection;
+}
+
+double OnlineEWMMoments::getSkew() const noexcept {
+    // 同 OnlineEWMSkew（权重和为 1）
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    centralMoments(m2, m3, m4);
+    if (std::isnan(m2) || std::isnan(m3) || std::abs(m2) < 1e-14){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (m3 / std::sqrt(m2 * m2 * m2)) * m_weightedSkewBesselCorrection;
+}
+
+double OnlineEWMMoments::getBiasedKurt() const noexcept {
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    centralMoments(m2, m3, m4);
+    if (std::isnan(m2) || std::isnan(m4) || std::abs(m2) < 1e-14){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return m4 / (m2 * m2) - 3.0;
+}
+
+void OnlineEWMMoments::centralMoments(double& m2, double& m3, double& m4) const noexcept {
+    const double mean = m_sums[0];
+    const double meanSquare = mean * mean;
+    // 一至三阶按 OnlineEWMSkew 的写法展开，四阶：m4 = S4 - 4 mean S3 + 6 mean^2 S2 - 3 mean^4
+    m2 = m_sums[1] - meanSquare;
+    m3 = m_sums[2] - (3 * mean * m_sums[1]) + (2 * mean * mean * mean);
+    m4 = m_sums[3] - (4 * mean * m_sums[2]) + (6 * meanSquare * m_sums[1]) - (3 * meanSquare * meanSquare);
+}
+
+void OnlineEWMMoments::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightCache.get());
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineEWMMoments::checkpointState(OnlineCheckpoint& archive) {
+    archive.array(m_sums, ORDERS);
+    archive(m_version, m_windowSize, m_varianceBesselCorrection, m_weightedSkewBesselCorrection);
+}
+
+void OnlineEWMMoments::reanchor() noexcept {
+    const double incrementalValue = m_sums[0];
+    computeExactSums();
+    recordDrift(incrementalValue, m_sums[0]);
+}
+
+void OnlineEWMMoments::computeExactSums() noexcept {
+    const auto& dataValues = m_window.m_onlineDataCache->getValues();
+    const auto& weightValues = m_window.m_onlineWeightCache->getNormedValues();
+    // 数据索引 i 对应权重位置 i + windowSize（同 OnlineEWMSum::computeExactValue）
+    if (m_windowSize >= OnlineSimd::MIN_VECTOR_STEP) {
+        // 环形缓冲按两段连续内存走向量内核
+        const VeView first = m_window.m_onlineDataCache->getFirstSegment();
+        const VeView second = m_window.m_onlineDataCache->getSecondSegment();
+        const double* weights = weightValues.data() + m_windowSize;
+        double secondSums[ORDERS];
+        OnlineSimd::weightedPowerSums(weights, first.data(), static_cast<size_t>(first.size()), m_sums);
+        OnlineSimd::weightedPowerSums(weights + first.size(), second.data(), static_cast<size_t>(second.size()), secondSums);
+        for (size_t k = 0; k < ORDERS; ++k) {
+            m_sums[k] += secondSums[k];
+        }
+        return;
+    }
+    std::fill(std::begin(m_sums), std::end(m_sums), 0.0);
+    for (size_t i = 0; i < static_cast<size_t>(dataValues.size()); ++i) {
+        const double value = dataValues[static_cast<int>(i)];
+        if(std::isnan(value)){continue;}
+        double product = weightValues[i + m_windowSize];
+        for (double& sum : m_sums) {
+            sum = std::fma(product, value, sum);
+            product *= value;
+        }
+    }
+}
+
+// OnlineEWMBank 多半衰期带权统计
+void OnlineEWMBank::constructor(const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineEWMBank", window.m_onlineDataCache);
+    CHECK_NULLPTR("OnlineEWMBank", window.m_onlineWeightBankCache);
+    // 权重按窗口位置取值，只支持定长窗口（时间窗口使用 OnlineTimeEWM）
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineEWMBank: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    if(m_window.m_onlineWeightBankCache->getWindowSize() != 2 * m_windowSize){
+        std::cout << "OnlineEWMBank: 权重序列长度须为窗口大小的2倍\n";
+        exit(1);
+    }
+    m_bankSize = m_window.m_onlineWeightBankCache->getBankSize();
+    m_sums = Eigen::ArrayXd::Zero(2 * m_bankSize);
+
+    // 各半衰期的无偏系数（同 OnlineEWMVar）
+    const auto& normedWeightValues = m_window.m_onlineWeightBankCache->getNormedValues();
+    m_varianceBesselCorrections.resize(m_bankSize);
+    for(Eigen::Index k = 0; k < m_bankSize; ++k){
+        const VectorXd weights = normedWeightValues.col(k).tail(static_cast<Eigen::Index>(m_windowSize)).matrix();
+        BaseFactor::weighted_variance_unbiased_coef(weights, m_varianceBesselCorrections[k]);
+    }
+
+    computeExactSums();
+    m_version = 0;
+}
+
+void OnlineEWMBank::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineEWMBank::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 代价选择：同 OnlineEWMSum
+    if(preferRecompute(inValues.size(), m_windowSize, 2.0, 1.0)){
+        computeExactSums();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新（逐项运算顺序同 OnlineEWMSum / OnlineEWMSumProduct）：整体衰减，减去旧值，加上新值
+    const auto& weightBank = *m_window.m_onlineWeightBankCache;
+    const Eigen::Index stepSize = inValues.size();
+    const Eigen::Index windowSize = static_cast<Eigen::Index>(m_windowSize);
+    auto sums = m_sums.head(m_bankSize);
+    auto sumSquares = m_sums.tail(m_bankSize);
+    const auto decay = weightBank.getUnnormalizedRow(2 * windowSize - stepSize - 1);
+    sums *= decay;
+    sumSquares *= decay;
+    for(Eigen::Index i = 0; i < outValues.size(); ++i){
+        const double value = outValues[i];
+        if(std::isnan(value)){continue;}
+        const auto weights = weightBank.getNormedRow(windowSize - stepSize + i);
+        sums -= weights * value;
+        sumSquares -= weights * value * value;
+    }
+    for(Eigen::Index i = 0; i < stepSize; ++i){
+        const double value = inValues[i];
+        if(std::isnan(value)){continue;}
+        const auto weights = weightBank.getNormedRow(2 * windowSize - stepSize + i);
+        sums += weights * value;
+        sumSquares += weights * value * value;
+    }
+    m_version = version;  // 更新版本号
+}
+
+double OnlineEWMBank::getMean(Eigen::Index k) const noexcept {
+    // 权重和为 1（同 OnlineEWMMean）
+    const double sum = getSum(k);
+    if(std::isnan(sum)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return sum;
+}
+
+double OnlineEWMBank::getVar(Eigen::Index k) const noexcept {
+    // 同 OnlineEWMVar（权重和为 1）
+    const double mean = getMean(k);
+    const double sumSquares = getSumSquares(k);
+    if(std::isnan(mean) || std::isnan(sumSquares)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double var = sumSquares - mean * mean;
+    if(std::isnan(var)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return var * m_varianceBesselCorrections[k];
+}
+
+std::shared_ptr<OnlineWeightBankCache> OnlineEWMBank::createWeightBank(size_t windowSize, const std::vector<double>& halflives,
+                                                                           const std::shared_ptr<OnlineArena>& arena) {
+    std::vector<Ve> weights(halflives.size());
+    for(size_t k = 0; k < halflives.size(); ++k){
+        VectorXd sequence;
+        BaseFactor::ewm_weights(2 * windowSize, halflives[k], sequence);
+        weights[k] = sequence;
+    }
+    return arena ? arena->create<OnlineWeightBankCache>(weights)
+                 : OnlineBaseFactor::createOnlineBaseF<OnlineWeightBankCache>(weights);
+}
+
+void OnlineEWMBank::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineWeightBankCache.get());
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineEWMBank::checkpointState(OnlineCheckpoint& archive) {
+    // 累计量个数由权重缓存决定（恢复前已按相同配置构造）
+    archive.array(m_sums.data(), static_cast<size_t>(m_sums.size()));
+    archive(m_version, m_windowSize);
+}
+
+void OnlineEWMBank::reanchor() noexcept {
+    const double incrementalValue = m_bankSize > 0 ? m_sums[0] : 0.0;
+    computeExactSums();
+    recordDrift(incrementalValue, m_bankSize > 0 ? m_sums[0] : 0.0);
+}
+
+void OnlineEWMBank::computeExactSums() noexcept {
+    const auto& dataValues = m_window.m_onlineDataCache->getValues();
+    const auto& weightBank = *m_window.m_onlineWeightBankCache;
+    const Eigen::Index windowSize = static_cast<Eigen::Index>(m_windowSize);
+    // 数据索引 i 对应权重位置 i + windowSize（同 OnlineEWMSum::computeExactValue）
+    m_sums.setZero();
+    auto sums = m_sums.head(m_bankSize);
+    auto sumSquares = m_sums.tail(m_bankSize);
+    for(Eigen::Index i = 0; i < static_cast<Eigen::Index>(dataValues.size()); ++i){
+        const double value = dataValues[static_cast<int>(i)];
+        if(std::isnan(value)){continue;}
+        const auto weights = weightBank.getNormedRow(i + windowSize);
+        sums += weights * value;
+        sumSquares += weights * value * value;
+    }
+}
+
+// OnlineTimeEWM 时间衰减带权统计
+void OnlineTimeEWM::constructor(const Window& window, double halflife) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineTimeEWM", window.m_onlineDataCache);
+    if (!window.m_onlineDataCache->isTimeWindow() || !(halflife > 0.0)) {
+        std::cout << "OnlineTimeEWM: 须使用时间窗口缓存且半衰期为正\n";
+        exit(1);
+    }
+
+    m_window = window;
+    m_decayRate = std::log(2.0) / halflife;
+    computeSums();
+    computeStats();
+    m_version = 0;
+}
+
+void OnlineTimeEWM::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineTimeEWM::step(size_t version) noexcept {
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    const auto& inTimes = m_window.m_onlineDataCache->getInTimes();
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& outTimes = m_window.m_onlineDataCache->getOutTimes();
+    if (inValues.size() == 0) {
+        m_version = version;  // 更新版本号
+        return;
+    }
+    const double latestTime = inTimes[inValues.size() - 1];
+    // 代价选择：增量每个进、出样本一次加权，重算每个窗口样本一次
+    if (preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_window.m_onlineDataCache->getCount(), 1.0, 1.0)) {
+        computeSums();
+        ++m_recomputeCalls;
+    } else {
+        // 增量更新：已有加权和整体衰减到新的最新时间，再加入新样本、移出过期样本
+        const double decay = std::exp(-m_decayRate * (latestTime - m_latestTime));
+        m_weightSum *= decay;
+        m_weightSquareSum *= decay * decay;
+        m_sum *= decay;
+        m_sumSquares *= decay;
+        m_latestTime = latestTime;
+        for (Eigen::Index i = 0; i < inValues.size(); ++i) {
+            accumulate(inValues[i], std::exp(-m_decayRate * (latestTime - inTimes[i])), 1.0);
+        }
+        for (Eigen::Index i = 0; i < outValues.size(); ++i) {
+            accumulate(outValues[i], std::exp(-m_decayRate * (latestTime - outTimes[i])), -1.0);
+        }
+    }
+    computeStats();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineTimeEWM::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineTimeEWM::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_decayRate, m_latestTime, m_shift, m_weightSum, m_weightSquareSum);
+    archive(m_sum, m_sumSquares, m_mean, m_var, m_count, m_version);
+}
+
+void OnlineTimeEWM::reanchor() noexcept {
+    const double incrementalValue = m_mean;
+    computeSums();
+    computeStats();
+    recordDrift(incrementalValue, m_mean);
+}
+
+void OnlineTimeEWM::computeSums() noexcept {
+    const auto& values = m_window.m_onlineDataCache->getValues();
+    const auto& times = m_window.m_onlineDataCache->getTimes();
+    m_shift = m_window.m_onlineDataCache->getShift();
+    m_weightSum = m_weightSquareSum = m_sum = m_sumSquares = 0.0;
+    m_count = 0;
+    if (values.size() == 0) {
+        return;
+    }
+    m_latestTime = times[times.size() - 1];
+    for (int i = 0; i < values.size(); ++i) {
+        accumulate(values[i], std::exp(-m_decayRate * (m_latestTime - times[i])), 1.0);
+    }
+}
+
+inline void OnlineTimeEWM::accumulate(double value, double weight, double sign) noexcept {
+    if (std::isnan(value)) {
+        return;
+    }
+    const double shifted = value - m_shift;
+    m_weightSum += sign * weight;
+    m_weightSquareSum += sign * weight * weight;
+    m_sum += sign * weight * shifted;
+    m_sumSquares += sign * weight * shifted * shifted;
+    if (sign > 0.0) {
+        ++m_count;
+    } else {
+        --m_count;
+    }
+}
+
+void OnlineTimeEWM::computeStats() noexcept {
+    if (m_count == 0 || m_weightSum <= 0.0) {
+        m_mean = std::numeric_limits<double>::quiet_NaN();
+        m_var = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    const double shiftedMean = m_sum / m_weightSum;
+    m_mean = m_shift + shiftedMean;
+    // 有偏加权方差，再乘 (sum w)^2 / ((sum w)^2 - sum w^2) 做无偏修正（单个有效样本时为 NaN）
+    const double biasedVar = std::max(0.0, m_sumSquares / m_weightSum - shiftedMean * shiftedMean);
+    const double weightSumSquared = m_weightSum * m_weightSum;
+    const double denominator = weightSumSquared - m_weightSquareSum;
+    m_var = (m_count > 1 && denominator > 0.0) ? biasedVar * weightSumSquared / denominator : std::numeric_limits<double>::quiet_NaN();
+}
+
+// 递归EWM（无限历史）
+namespace {
+// 检查递归EWM参数
+void checkRecursiveEWMParams(const char* name, const OnlineRecursiveEWMParams& params) {
+    if (!(params.alpha > 0.0 && params.alpha <= 1.0)) {
+        std::cout << name << ": 平滑系数须满足 0 < alpha <= 1\n";
+        exit(1);
+    }
+}
+}
+
+OnlineRecursiveEWMParams OnlineRecursiveEWMParams::fromHalflife(double halflife, bool adjust, bool ignoreNa) {
+    if (!(halflife > 0.0)) {
+        std::cout << "OnlineRecursiveEWMParams: 半衰期须为正\n";
+        exit(1);
+    }
+    return OnlineRecursiveEWMParams{1.0 - std::exp(-std::log(2.0) / halflife), adjust, ignoreNa};
+}
+
+void RecursiveEWMMoments::push(double x, double y, const OnlineRecursiveEWMParams& params, bool thirdMoment) noexcept {
+    const bool isObservation = !std::isnan(x) && !std::isnan(y);
+    const double oldWeightFactor = 1.0 - params.alpha;
+    const double newWeight = params.adjust ? 1.0 : params.alpha;
+    if (isObservation) {
+        ++count;
+    }
+    if (std::isnan(meanX)) {
+        // 首个有效样本：均值取样本值，权重状态保持初值
+        if (isObservation) {
+            meanX = x;
+            meanY = y;
+        }
+        return;
+    }
+    if (!isObservation && params.ignoreNa) {
+        return;
+    }
+    // 已有权重整体衰减
+    weightSum *= oldWeightFactor;
+    weightSquareSum *= oldWeightFactor * oldWeightFactor;
+    weightCubeSum *= oldWeightFactor * oldWeightFactor * oldWeightFactor;
+    oldWeight *= oldWeightFactor;
+    if (!isObservation) {
+        return;
+    }
+    const double oldMeanX = meanX;
+    const double oldMeanY = meanY;
+    const double totalWeight = oldWeight + newWeight;
+    // 常数序列不做除法，避免数值误差
+    if (meanX != x) {
+        meanX = (oldWeight * oldMeanX + newWeight * x) / totalWeight;
+    }
+    if (meanY != y) {
+        meanY = (oldWeight * oldMeanY + newWeight * y) / totalWeight;
+    }
+    const double deltaX = oldMeanX - meanX;
+    const double deltaY = oldMeanY - meanY;
+    if (thirdMoment) {
+        // 旧样本相对新均值的偏差为 (x - 旧均值) + deltaX，展开后一次项加权和为 0（须在 cov 更新前使用旧的二阶矩）
+        const double deviation = x - meanX;
+        moment3 = (oldWeight * (moment3 + 3.0 * deltaX * cov + deltaX * deltaX * deltaX)
+                   + newWeight * deviation * deviation * deviation) / totalWeight;
+    }
+    cov = (oldWeight * (cov + deltaX * deltaY) + newWeight * (x - meanX) * (y - meanY)) / totalWeight;
+    weightSum += newWeight;
+    weightSquareSum += newWeight * newWeight;
+    weightCubeSum += newWeight * newWeight * newWeight;
+    oldWeight += newWeight;
+    if (!params.adjust) {
+        weightSum /= oldWeight;
+        weightSquareSum /= oldWeight * oldWeight;
+        weightCubeSum /= oldWeight * oldWeight * oldWeight;
+        oldWeight = 1.0;
+    }
+}
+
+double RecursiveEWMMoments::getUnbiasedCov() const noexcept {
+    const double numerator = weightSum * weightSum;
+    const double denominator = numerator - weightSquareSum;
+    if (count == 0 || denominator <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (numerator / denominator) * cov;
+}
+
+double RecursiveEWMMoments::getSkew() const noexcept {
+    if (count < 3 || std::isnan(cov) || std::abs(cov) < 1e-14) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    // 归一化权重的平方和、三次方和
+    const double normedSquareSum = weightSquareSum / (weightSum * weightSum);
+    const double normedCubeSum = weightCubeSum / (weightSum * weightSum * weightSum);
+    const double denominator = 1.0 - 3.0 * normedSquareSum + 2.0 * normedCubeSum;
+    if (denominator <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double besselCorrection = std::pow(1.0 - normedSquareSum, 1.5) / denominator;
+    return (moment3 / std::sqrt(cov * cov * cov)) * besselCorrection;
+}
+
+void RecursiveEWMMoments::checkpoint(OnlineCheckpoint& archive) {
+    archive(meanX, meanY, cov, moment3, oldWeight);
+    archive(weightSum, weightSquareSum, weightCubeSum, count);
+}
+
+// OnlineRecursiveEWMSum 递归带权加和
+void OnlineRecursiveEWMSum::constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+    checkRecursiveEWMParams("OnlineRecursiveEWMSum", params);
+    m_params = params;
+    for (Eigen::Index i = 0; i < initialValue.size(); ++i) {
+        push(initialValue[i]);
+    }
+    m_version = 0;
+}
+
+void OnlineRecursiveEWMSum::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    for (Eigen::Index i = 0; i < inValues.size(); ++i) {
+        push(inValues[i]);
+    }
+    m_version = version;  // 更新版本号
+}
+
+inline void OnlineRecursiveEWMSum::push(double value) noexcept {
+    const bool isObservation = !std::isnan(value);
+    if (isObservation) {
+        ++m_count;
+    }
+    if (std::isnan(m_value)) {
+        m_value = value;
+        return;
+    }
+    if (!isObservation && m_params.ignoreNa) {
+        return;
+    }
+    // 同 pandas ewm().sum()：加和不归一，adjust 两种模式递推相同
+    m_value *= 1.0 - m_params.alpha;
+    if (isObservation) {
+        m_value += value;
+    }
+}
+
+void OnlineRecursiveEWMSum::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_count, m_version);
+}
+
+// OnlineRecursiveEWMMean 递归带权均值
+void OnlineRecursiveEWMMean::constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+    checkRecursiveEWMParams("OnlineRecursiveEWMMean", params);
+    m_params = params;
+    for (Eigen::Index i = 0; i < initialValue.size(); ++i) {
+        push(initialValue[i]);
+    }
+    m_version = 0;
+}
+
+void OnlineRecursiveEWMMean::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    for (Eigen::Index i = 0; i < inValues.size(); ++i) {
+        push(inValues[i]);
+    }
+    m_version = version;  // 更新版本号
+}
+
+inline void OnlineRecursiveEWMMean::push(double value) noexcept {
+    const bool isObservation = !std::isnan(value);
+    if (isObservation) {
+        ++m_count;
+    }
+    if (std::isnan(m_value)) {
+        m_value = value;
+        return;
+    }
+    if (!isObservation && m_params.ignoreNa) {
+        return;
+    }
+    m_oldWeight *= 1.0 - m_params.alpha;
+    if (!isObservation) {
+        return;
+    }
+    const double newWeight = m_params.adjust ? 1.0 : m_params.alpha;
+    // 常数序列不做除法，避免数值误差
+    if (m_value != value) {
+        m_value = (m_oldWeight * m_value + newWeight * value) / (m_oldWeight + newWeight);
+    }
+    m_oldWeight = m_params.adjust ? m_oldWeight + newWeight : 1.0;
+}
+
+void OnlineRecursiveEWMMean::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_oldWeight, m_count, m_version);
+}
+
+// OnlineRecursiveEWMVar 递归带权方差
+void OnlineRecursiveEWMVar::constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+    checkRecursiveEWMParams("OnlineRecursiveEWMVar", params);
+    m_params = params;
+    for (Eigen::Index i = 0; i < initialValue.size(); ++i) {
+        m_moments.push(initialValue[i], initialValue[i], m_params, false);
+    }
+    m_value = m_moments.getUnbiasedCov();
+    m_version = 0;
+}
+
+void OnlineRecursiveEWMVar::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    for (Eigen::Index i = 0; i < inValues.size(); ++i) {
+        m_moments.push(inValues[i], inValues[i], m_params, false);
+    }
+    m_value = m_moments.getUnbiasedCov();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineRecursiveEWMVar::checkpointState(OnlineCheckpoint& archive) {
+    m_moments.checkpoint(archive);
+    archive(m_value, m_version);
+}
+
+// OnlineRecursiveEWMCov 递归带权协方差
+void OnlineRecursiveEWMCov::constructor(const Ve& initialValueX, const Ve& initialValueY, const OnlineRecursiveEWMParams& params) {
+    checkRecursiveEWMParams("OnlineRecursiveEWMCov", params);
+    if (initialValueX.size() != initialValueY.size()) {
+        std::cout << "OnlineRecursiveEWMCov: X和Y的初始序列长度不一致\n";
+        exit(1);
+    }
+    m_params = params;
+    for (Eigen::Index i = 0; i < initialValueX.size(); ++i) {
+        m_moments.push(initialValueX[i], initialValueY[i], m_params, false);
+    }
+    m_value = m_moments.getUnbiasedCov();
+    m_version = 0;
+}
+
+void OnlineRecursiveEWMCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    if (inValuesX.size() != inValuesY.size()) {
+        std::cout << "OnlineRecursiveEWMCov::update: X和Y的向量大小不一致\n";
+        exit(1);
+    }
+    for (Eigen::Index i = 0; i < inValuesX.size(); ++i) {
+        m_moments.push(inValuesX[i], inValuesY[i], m_params, false);
+    }
+    m_value = m_moments.getUnbiasedCov();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineRecursiveEWMCov::checkpointState(OnlineCheckpoint& archive) {
+    m_moments.checkpoint(archive);
+    archive(m_value, m_version);
+}
+
+// OnlineRecursiveEWMSkew 递归带权偏度
+void OnlineRecursiveEWMSkew::constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+    checkRecursiveEWMParams("OnlineRecursiveEWMSkew", params);
+    m_params = params;
+    for (Eigen::Index i = 0; i < initialValue.size(); ++i) {
+        m_moments.push(initialValue[i], initialValue[i], m_params, true);
+    }
+    m_value = m_moments.getSkew();
+    m_version = 0;
+}
+
+void OnlineRecursiveEWMSkew::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+    for (Eigen::Index i = 0; i < inValues.size(); ++i) {
+        m_moments.push(inValues[i], inValues[i], m_params, true);
+    }
+    m_value = m_moments.getSkew();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineRecursiveEWMSkew::checkpointState(OnlineCheckpoint& archive) {
+    m_moments.checkpoint(archive);
+    archive(m_value, m_version);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "OnlineDataCache.h"
+#include <limits>
 #include <memory>
 
 // 方法层：通过读取数据缓存值进行统计计算
@@ -24,10 +25,20 @@ class OnlineEWMSum : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：由窗口精确重算带权和
+    void reanchor() noexcept override;
     
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算带权和（构造与重锚共用）
+    [[nodiscard]] double computeExactValue() const noexcept;
     // 计算带权加和
-    static inline void computeEWMSum(const std::deque<double>& outValues, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues, const Ve& inValues, size_t windowSize, double& Value) noexcept;
+    static inline void computeEWMSum(const VeView& outValues, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues, const VeView& inValues, size_t windowSize, double& Value) noexcept;
     
     Window m_window;
     double m_value = 0.0;
@@ -57,12 +68,22 @@ class OnlineEWMSumProduct : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：由窗口精确重算带权和
+    void reanchor() noexcept override;
     
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算带权和（构造与重锚共用）
+    [[nodiscard]] double computeExactValue() const noexcept;
     // 计算带权乘积和增量（不可静态）
-    static inline void computeEWMSumProduct(const std::deque<double>& outValuesX, const std::deque<double>& outValuesY, 
+    static inline void computeEWMSumProduct(const VeView& outValuesX, const VeView& outValuesY, 
                                             const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
-                                            const Ve& inValuesX, const Ve& inValuesY, size_t windowSize, double& Value) noexcept;
+                                            const VeView& inValuesX, const VeView& inValuesY, size_t windowSize, double& Value) noexcept;
     
     Window m_window;
     double m_value = 0.0;
@@ -94,12 +115,22 @@ class OnlineEWMSumProduct3 : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：由窗口精确重算带权和
+    void reanchor() noexcept override;
     
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算带权和（构造与重锚共用）
+    [[nodiscard]] double computeExactValue() const noexcept;
     // 计算带权乘积和增量（不可静态）
-    static inline void computeEWMSumProduct(const std::deque<double>& outValuesX, const std::deque<double>& outValuesY, 
-                                            const std::deque<double>& outValuesZ, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
-                                            const Ve& inValuesX, const Ve& inValuesY, const Ve& inValuesZ, size_t windowSize, double& Value) noexcept;
+    static inline void computeEWMSumProduct(const VeView& outValuesX, const VeView& outValuesY, 
+                                            const VeView& outValuesZ, const Ve& unnormalizedWeightValues, const Ve& normedWeightValues,
+                                            const VeView& inValuesX, const VeView& inValuesY, const VeView& inValuesZ, size_t windowSize, double& Value) noexcept;
     
     Window m_window;
     double m_value = 0.0;
@@ -127,8 +158,16 @@ class OnlineEWMMean : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
     
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     // 计算带权均值
     [[nodiscard]] static inline double computeEWMMean(double sum, double weightSum) noexcept;
     
@@ -161,8 +200,16 @@ class OnlineEWMVar : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
 
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     // 计算带权方差（使用权重和以及无偏系数修正）
     [[nodiscard]] static inline double computeEWMVar(double mean, double sumSquares, double weightSum, double varianceBesselCorrection) noexcept;
 
@@ -197,8 +244,16 @@ class OnlineEWMCov : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
 
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     // 计算带权协方差（使用权重和以及无偏系数修正）
     [[nodiscard]] static inline double computeEWMCov(double sumXY, double meanX, double meanY, double weightSum, double varianceBesselCorrection) noexcept;
 
@@ -233,8 +288,16 @@ class OnlineEWMSkew : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
 
     private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     // 计算带权偏度
     [[nodiscard]] static inline double computeEWMSkew(double mean, double sumProduct, double sumProduct3, double weightSum, double weightedSkewBesselCorrection) noexcept;
 
@@ -245,4 +308,342 @@ class OnlineEWMSkew : public OnlineBaseFactor {
     //
     double m_weightSum = 0.0;
     double m_weightedSkewBesselCorrection = 0.0;
-};
\ No newline at end of file
+};
+
+// 在线带权多阶矩类（方法层）：同一数据缓存上的带权幂和 sum(w x^k)，k = 1..4
+// 替代 OnlineEWMSum + OnlineEWMSumProduct(x,x) + OnlineEWMSumProduct3(x,x,x) 的扇出：
+// 每个进出样本只读一次、权重衰减只乘一次，四阶幂和一起更新（大步长走 OnlineSimd::weightedPowerSums）
+// 一至三阶幂和与对应的单独节点一致，均值/方差/偏度与 OnlineEWMMean / OnlineEWMVar / OnlineEWMSkew 的公式相同
+class OnlineEWMMoments : public OnlineBaseFactor {
+    public:
+    static constexpr size_t ORDERS = 4;
+    struct Window{
+        // 权重系数缓存层
+        std::shared_ptr<OnlineWeightCache> m_onlineWeightCache;
+        // 数据缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+    OnlineEWMMoments(const Window& window) {
+        constructor(window);
+    }
+    // 构造
+    void constructor(const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 带权幂和 sum(w x^order)，order = 1..4
+    [[nodiscard]] double getSum(size_t order) const noexcept { return m_sums[order - 1]; }
+    // 带权均值（权重和为 1）
+    [[nodiscard]] double getMean() const noexcept;
+    // 带权方差（无偏）
+    [[nodiscard]] double getVar() const noexcept;
+    // 带权偏度（无偏修正）
+    [[nodiscard]] double getSkew() const noexcept;
+    // 带权超额峰度（有偏：m4 / m2^2 - 3，未做无偏修正，与 getVar/getSkew 口径不同）
+    [[nodiscard]] double getBiasedKurt() const noexcept;
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：由窗口精确重算全部幂和
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算全部幂和（构造与重锚共用）
+    void computeExactSums() noexcept;
+    // 中心矩 m2、m3、m4（由幂和与均值换算）
+    void centralMoments(double& m2, double& m3, double& m4) const noexcept;
+
+    Window m_window;
+    double m_sums[ORDERS] = {0.0, 0.0, 0.0, 0.0};
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+    //
+    double m_varianceBesselCorrection = 0.0;
+    double m_weightedSkewBesselCorrection = 0.0;
+};
+
+// 在线多半衰期带权统计类（方法层）：同一数据缓存上 K 个半衰期的带权和、带权平方和
+// 2K 个累计量存放在一段连续数组中（前 K 个为带权和，后 K 个为带权平方和），
+// 每个进出样本只读一次，沿半衰期维度整行更新（行优先权重表，按 SIMD 宽度向量化）
+// 各半衰期的数值与单独的 OnlineEWMSum / OnlineEWMSumProduct / OnlineEWMMean / OnlineEWMVar 链一致
+class OnlineEWMBank : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 多半衰期权重缓存层
+        std::shared_ptr<OnlineWeightBankCache> m_onlineWeightBankCache;
+        // 数据缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+    OnlineEWMBank(const Window& window) {
+        constructor(window);
+    }
+    // 构造
+    void constructor(const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 按半衰期创建权重缓存（权重序列同 BaseFactor::ewm_weights，长度为窗口大小x2），各股票共享
+    // 给定内存池时取自内存池（同 OnlineGraphBuilder），否则在堆上创建
+    [[nodiscard]] static std::shared_ptr<OnlineWeightBankCache> createWeightBank(size_t windowSize, const std::vector<double>& halflives,
+                                                                                 const std::shared_ptr<OnlineArena>& arena = nullptr);
+    // 第 k 个半衰期的带权和
+    [[nodiscard]] double getSum(Eigen::Index k) const noexcept { return m_sums[k]; }
+    // 第 k 个半衰期的带权平方和
+    [[nodiscard]] double getSumSquares(Eigen::Index k) const noexcept { return m_sums[m_bankSize + k]; }
+    // 第 k 个半衰期的带权均值（权重和为 1）
+    [[nodiscard]] double getMean(Eigen::Index k) const noexcept;
+    // 第 k 个半衰期的带权方差（无偏）
+    [[nodiscard]] double getVar(Eigen::Index k) const noexcept;
+    // 全部累计量（连续数组，前 K 个为带权和，后 K 个为带权平方和）
+    [[nodiscard]] const Eigen::ArrayXd& getSums() const noexcept { return m_sums; }
+    // 半衰期个数 K
+    [[nodiscard]] Eigen::Index getBankSize() const noexcept { return m_bankSize; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：由窗口精确重算全部累计量
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算全部累计量（构造与重锚共用）
+    void computeExactSums() noexcept;
+
+    Window m_window;
+    Eigen::ArrayXd m_sums;                      // 2K 个累计量
+    Eigen::ArrayXd m_varianceBesselCorrections; // 各半衰期的无偏系数
+    Eigen::Index m_bankSize = 0;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线时间衰减带权统计类（方法层，配合时间窗口缓存）
+// 权重按时间指数衰减：w_i = 2^(-(最新时间 - t_i) / 半衰期)，最新样本权重为 1，NaN 样本不计入
+// 每步先将各加权和整体乘以衰减因子 2^(-Δt / 半衰期)，再加入新样本、移出按时间淘汰的样本（各按其当前权重）
+// 加权和以缓存平移量为锚（x - 平移量），可通过 reanchor 由窗口精确重算
+class OnlineTimeEWM : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 数据缓存层（时间窗口）
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+    OnlineTimeEWM(const Window& window, double halflife) {
+        constructor(window, halflife);
+    }
+    // 构造：halflife 为半衰期（与时间戳同单位）
+    void constructor(const Window& window, double halflife);
+    // 递归更新（时间窗口缓存须已由调用方以同一版本号写入时间戳）
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值：时间衰减加权均值
+    [[nodiscard]] double getValue() const noexcept { return m_mean; }
+    // 获取时间衰减加权方差（按权重平方和做无偏修正，与 pandas ewm var(bias=False) 一致）
+    [[nodiscard]] double getVar() const noexcept { return m_var; }
+    // 获取有效样本的权重和
+    [[nodiscard]] double getWeightSum() const noexcept { return m_weightSum; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算各加权和
+    void computeSums() noexcept;
+    // 由加权和计算均值、方差
+    void computeStats() noexcept;
+    // 按权重 weight 加入（sign 为 1）或移出（sign 为 -1）一个样本
+    inline void accumulate(double value, double weight, double sign) noexcept;
+
+    Window m_window;
+    double m_decayRate = 0.0;      // ln2 / 半衰期
+    double m_latestTime = 0.0;     // 当前权重对应的最新时间
+    double m_shift = 0.0;
+    double m_weightSum = 0.0;      // sum(w)
+    double m_weightSquareSum = 0.0; // sum(w^2)
+    double m_sum = 0.0;            // sum(w * (x - 平移量))
+    double m_sumSquares = 0.0;     // sum(w * (x - 平移量)^2)
+    double m_mean = std::numeric_limits<double>::quiet_NaN();
+    double m_var = std::numeric_limits<double>::quiet_NaN();
+    size_t m_count = 0;
+    size_t m_version = 0;
+};
+
+// 递归EWM（无限历史，方法层）：不经数据缓存层与权重缓存层，状态 O(1)，与半衰期无关
+// 语义同 pandas ewm(alpha, adjust, ignore_na)：
+// - adjust=true：第 i 个最近样本权重 (1 - alpha)^i，归一化
+// - adjust=false：均值等按 y_t = (1 - alpha) * y_{t-1} + alpha * x_t 递推（首个样本权重 1）；加和不归一，与 adjust 无关
+// 节点无输入节点（编译模式下作为叶子由调用方 update），输入逐个样本按时间顺序递推
+struct OnlineRecursiveEWMParams {
+    double alpha = 0.0;     // 平滑系数，0 < alpha <= 1
+    bool adjust = true;
+    bool ignoreNa = false;  // false：NaN 位置照常衰减（权重按绝对位置）；true：NaN 不参与衰减
+    // 由半衰期换算：alpha = 1 - exp(-ln2 / halflife)
+    [[nodiscard]] static OnlineRecursiveEWMParams fromHalflife(double halflife, bool adjust = true, bool ignoreNa = false);
+};
+
+// 递归EWM加权矩（pandas ewmcov 的递推）：加权均值、有偏加权协方差，可选三阶中心矩
+// 同时递推权重和、平方和、三次方和（无偏修正用）；adjust=false 时每步按最新权重归一
+struct RecursiveEWMMoments {
+    double meanX = std::numeric_limits<double>::quiet_NaN();
+    double meanY = std::numeric_limits<double>::quiet_NaN();
+    double cov = 0.0;          // 有偏加权协方差（X、Y 相同时为有偏方差）
+    double moment3 = 0.0;      // 有偏加权三阶中心矩（仅 X、Y 相同时有意义）
+    double oldWeight = 1.0;
+    double weightSum = 1.0;
+    double weightSquareSum = 1.0;
+    double weightCubeSum = 1.0;
+    size_t count = 0;          // 有效样本数（X、Y 均非 NaN）
+
+    // 递推一个样本对
+    void push(double x, double y, const OnlineRecursiveEWMParams& params, bool thirdMoment) noexcept;
+    // 无偏协方差（同 pandas bias=False，单个有效样本时为 NaN）
+    [[nodiscard]] double getUnbiasedCov() const noexcept;
+    // 无偏偏度（修正系数同 BaseFactor::computeWeightedSkewBesselCorrection，少于 3 个有效样本时为 NaN）
+    [[nodiscard]] double getSkew() const noexcept;
+    // 检查点：保存/恢复全部成员
+    void checkpoint(OnlineCheckpoint& archive);
+};
+
+// 在线递归带权加和类（同 pandas ewm().sum()：y_t = (1 - alpha) * y_{t-1} + x_t，与 adjust 无关）
+class OnlineRecursiveEWMSum : public OnlineBaseFactor {
+    public:
+    OnlineRecursiveEWMSum(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+        constructor(initialValue, params);
+    }
+    // 构造：初始序列按时间顺序递推
+    void constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 递推一个样本
+    inline void push(double value) noexcept;
+
+    OnlineRecursiveEWMParams m_params;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_count = 0;
+    size_t m_version = 0;
+};
+
+// 在线递归带权均值类（同 pandas ewm().mean()）
+class OnlineRecursiveEWMMean : public OnlineBaseFactor {
+    public:
+    OnlineRecursiveEWMMean(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+        constructor(initialValue, params);
+    }
+    // 构造：初始序列按时间顺序递推
+    void constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 递推一个样本
+    inline void push(double value) noexcept;
+
+    OnlineRecursiveEWMParams m_params;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    double m_oldWeight = 1.0;
+    size_t m_count = 0;
+    size_t m_version = 0;
+};
+
+// 在线递归带权方差类（同 pandas ewm().var()，无偏）
+class OnlineRecursiveEWMVar : public OnlineBaseFactor {
+    public:
+    OnlineRecursiveEWMVar(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+        constructor(initialValue, params);
+    }
+    // 构造：初始序列按时间顺序递推
+    void constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取加权均值
+    [[nodiscard]] double getMean() const noexcept { return m_moments.meanX; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_moments.count; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    OnlineRecursiveEWMParams m_params;
+    RecursiveEWMMoments m_moments;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+};
+
+// 在线递归带权协方差类（同 pandas ewm().cov()，无偏，X、Y 均非 NaN 的样本对参与）
+class OnlineRecursiveEWMCov : public OnlineBaseFactor {
+    public:
+    OnlineRecursiveEWMCov(const Ve& initialValueX, const Ve& initialValueY, const OnlineRecursiveEWMParams& params) {
+        constructor(initialValueX, initialValueY, params);
+    }
+    // 构造：初始序列按时间顺序递推
+    void constructor(const Ve& initialValueX, const Ve& initialValueY, const OnlineRecursiveEWMParams& params);
+    // 递归更新
+    void update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取有效样本对数
+    [[nodiscard]] size_t getCount() const noexcept { return m_moments.count; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    OnlineRecursiveEWMParams m_params;
+    RecursiveEWMMoments m_moments;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+};
+
+// 在线递归带权偏度类（加权二、三阶中心矩递推，无偏修正同 OnlineEWMSkew）
+class OnlineRecursiveEWMSkew : public OnlineBaseFactor {
+    public:
+    OnlineRecursiveEWMSkew(const Ve& initialValue, const OnlineRecursiveEWMParams& params) {
+        constructor(initialValue, params);
+    }
+    // 构造：初始序列按时间顺序递推
+    void constructor(const Ve& initialValue, const OnlineRecursiveEWMParams& params);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_moments.count; }
+
+    private:
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    OnlineRecursiveEWMParams m_params;
+    RecursiveEWMMoments m_moments;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include "OnlineBaseFactor.h"
+#include "OnlineDataCache.h"
+#include "OnlineArena.h"
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+
+// 在线节点图构建器：在 createOnlineBaseF 之上做哈希去重（hash-consing）
+// 缓存层：以调用方给定的序列标识为键（同一数据源只建一个缓存）
+// 方法层：以 节点类型 + 输入节点地址（Window） + 标量参数 为键，重复请求直接返回已有节点
+// 说明：方法层构造参数中的初始值（Ve/Eigen 表达式）由输入节点决定，不参与键计算
+// 给定内存池时新建节点取自内存池（按构建顺序连续排布），否则逐个在堆上创建
+class OnlineGraphBuilder {
+    public:
+    explicit OnlineGraphBuilder(std::shared_ptr<OnlineArena> arena = nullptr) : m_arena(std::move(arena)) {}
+
+    // 去重统计
+    struct Stats {
+        size_t createdNodes = 0;   // 实际创建的节点数
+        size_t dedupedNodes = 0;   // 命中已有节点（被去重）的次数
+        size_t savedBytes = 0;     // 去重节省的内存估算（字节）
+    };
+
+    // 数据缓存层：按序列标识去重
+    std::shared_ptr<OnlineDataCache> createDataCache(const std::string& seriesKey, const Ve& initialValue) {
+        return createCache<OnlineDataCache>(seriesKey, initialValue);
+    }
+    // 权重缓存层：按权重标识去重
+    std::shared_ptr<OnlineWeightCache> createWeightCache(const std::string& weightKey, const Ve& initialValue) {
+        return createCache<OnlineWeightCache>(weightKey, initialValue);
+    }
+
+    // 方法层：按 类型 + 输入节点 + 参数 去重
+    template<typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        std::string key = typeid(T).name();
+        (appendKey(key, args), ...);
+        return findOrCreate<T>(key, std::forward<Args>(args)...);
+    }
+
+    // 分叉：复制当前节点表（统计清零），供多线程各自构建互不相交的子图（共享节点须在分叉前建好）
+    // arena 为分叉后新建节点所用的内存池（内存池非线程安全，每个分叉各用一个；为空时沿用本构建器的内存池）
+    [[nodiscard]] OnlineGraphBuilder fork(std::shared_ptr<OnlineArena> arena = nullptr) const {
+        OnlineGraphBuilder forked = *this;
+        forked.m_stats = Stats{};
+        if (arena) {
+            forked.m_arena = std::move(arena);
+        }
+        return forked;
+    }
+    // 合并分叉构建器的统计（分叉中新建的节点不回写到本构建器）
+    void mergeStats(const OnlineGraphBuilder& forked) noexcept {
+        m_stats.createdNodes += forked.m_stats.createdNodes;
+        m_stats.dedupedNodes += forked.m_stats.dedupedNodes;
+        m_stats.savedBytes += forked.m_stats.savedBytes;
+    }
+
+    [[nodiscard]] const Stats& getStats() const noexcept { return m_stats; }
+    [[nodiscard]] size_t getNodeCount() const noexcept { return m_nodes.size(); }
+
+    private:
+    template<typename T>
+    std::shared_ptr<T> createCache(const std::string& sourceKey, const Ve& initialValue) {
+        const std::string key = std::string(typeid(T).name()) + '#' + sourceKey;
+        return findOrCreate<T>(key, initialValue);
+    }
+
+    template<typename T, typename... Args>
+    std::shared_ptr<T> findOrCreate(const std::string& key, Args&&... args) {
+        auto it = m_nodes.find(key);
+        if (it != m_nodes.end()) {
+            auto node = std::static_pointer_cast<T>(it->second);
+            m_stats.dedupedNodes++;
+            m_stats.savedBytes += estimateBytes(*node);
+            return node;
+        }
+        auto node = m_arena ? m_arena->create<T>(std::forward<Args>(args)...)
+                            : OnlineBaseFactor::createOnlineBaseF<T>(std::forward<Args>(args)...);
+        m_nodes.emplace(key, node);
+        m_stats.createdNodes++;
+        return node;
+    }
+
+    // 键拼接：标量按值，Window 按成员地址（对象表示），Eigen 初始值忽略
+    template<typename Arg>
+    static void appendKey(std::string& key, const Arg& arg) {
+        using ArgType = std::decay_t<Arg>;
+        if constexpr (std::is_arithmetic_v<ArgType>) {
+            key.append(reinterpret_cast<const char*>(&arg), sizeof(ArgType));
+        } else if constexpr (std::is_base_of_v<Eigen::EigenBase<ArgType>, ArgType>) {
+            // 初始值由输入节点决定，不参与键计算
+        } else {
+            static_assert(sizeof(ArgType) % sizeof(std::shared_ptr<OnlineBaseFactor>) == 0,
+                          "OnlineGraphBuilder: Window 只能由 shared_ptr 成员组成");
+            key.append(reinterpret_cast<const char*>(&arg), sizeof(ArgType));
+        }
+    }
+
+    // 节点内存估算：对象本身 + make_shared 控制块 + 缓冲区
+    static constexpr size_t CONTROL_BLOCK_BYTES = 2 * sizeof(void*);
+    template<typename T>
+    static size_t estimateBytes(const T&) { return sizeof(T) + CONTROL_BLOCK_BYTES; }
+    static size_t estimateBytes(const OnlineDataCache& cache) {
+        // 窗口环形缓冲 + 被挤出值缓冲
+        return sizeof(OnlineDataCache) + CONTROL_BLOCK_BYTES + 2 * cache.getWindowSize() * sizeof(double);
+    }
+    static size_t estimateBytes(const OnlineWeightCache& cache) {
+        // 未归一化权重 + 归一化权重
+        return sizeof(OnlineWeightCache) + CONTROL_BLOCK_BYTES + 2 * cache.getWindowSize() * sizeof(double);
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<OnlineBaseFactor>> m_nodes;
+    std::shared_ptr<OnlineArena> m_arena;
+    Stats m_stats;
+};
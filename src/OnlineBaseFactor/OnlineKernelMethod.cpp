@@ -0,0 +1,213 @@
+#include "OnlineKernelMethod.h"
+#include "OnlineCheckpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+// OnlineKernel 分段多项式核
+OnlineKernel OnlineKernel::uniform(size_t windowSize) {
+    return piecewise(windowSize, {Segment{0, 1.0, 0.0, 0.0}});
+}
+
+OnlineKernel OnlineKernel::linearDecay(size_t windowSize) {
+    return piecewise(windowSize, {Segment{0, 1.0, 1.0, 0.0}});
+}
+
+OnlineKernel OnlineKernel::triangular(size_t windowSize) {
+    // p + 1 <= W - p 当且仅当 p < (W + 1) / 2
+    const size_t peak = (windowSize + 1) / 2;
+    if (peak == 0 || peak >= windowSize) {
+        return linearDecay(windowSize);
+    }
+    return piecewise(windowSize, {Segment{0, 1.0, 1.0, 0.0},
+                                  Segment{peak, static_cast<double>(windowSize), -1.0, 0.0}});
+}
+
+OnlineKernel OnlineKernel::piecewise(size_t windowSize, std::vector<Segment> segments) {
+    if (windowSize <= 1 || segments.empty() || segments.front().begin != 0) {
+        std::cout << "OnlineKernel: 窗口大小须大于1，且首段须从位置0开始\n";
+        exit(1);
+    }
+    for (size_t k = 1; k < segments.size(); ++k) {
+        if (segments[k].begin <= segments[k - 1].begin || segments[k].begin >= windowSize) {
+            std::cout << "OnlineKernel: 各段起点须严格递增且小于窗口大小\n";
+            exit(1);
+        }
+    }
+    OnlineKernel kernel;
+    kernel.windowSize = windowSize;
+    kernel.segments = std::move(segments);
+    return kernel;
+}
+
+double OnlineKernel::weight(size_t position) const noexcept {
+    const Segment& segment = segments[segmentOf(position)];
+    const double p = static_cast<double>(position);
+    return segment.c0 + segment.c1 * p + segment.c2 * p * p;
+}
+
+size_t OnlineKernel::segmentOf(size_t position) const noexcept {
+    const auto it = std::upper_bound(segments.begin(), segments.end(), position,
+                                     [](size_t value, const Segment& segment) { return value < segment.begin; });
+    return static_cast<size_t>(it - segments.begin()) - 1;
+}
+
+size_t OnlineKernel::minSegmentWidth() const noexcept {
+    size_t width = windowSize;
+    for (size_t k = 0; k < segments.size(); ++k) {
+        const size_t end = k + 1 < segments.size() ? segments[k + 1].begin : windowSize;
+        width = std::min(width, end - segments[k].begin);
+    }
+    return width;
+}
+
+// OnlineKernelSum 核加权和
+void OnlineKernelSum::constructor(const Window& window, const OnlineKernel& kernel) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineKernelSum", window.m_onlineDataCache);
+    // 权重按窗口位置取值，只支持定长窗口
+    if (window.m_onlineDataCache->isTimeWindow()) {
+        std::cout << "OnlineKernelSum: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+    if (kernel.windowSize != window.m_onlineDataCache->getWindowSize() || kernel.segments.empty()) {
+        std::cout << "OnlineKernelSum: 核的窗口大小与缓存层不一致\n";
+        exit(1);
+    }
+
+    m_window = window;
+    m_kernel = kernel;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = kernel.windowSize;
+    m_minSegmentWidth = kernel.minSegmentWidth();
+    m_moments.assign(kernel.segments.size(), SegmentMoments{});
+    computeMoments();
+    computeValue();
+    m_version = 0;
+}
+
+void OnlineKernelSum::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if (m_version == version) {
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineKernelSum::step(size_t version) noexcept {
+    const OnlineDataCache& cache = *m_window.m_onlineDataCache;
+    const auto outValues = cache.getOutValues();
+    const auto inValues = cache.getInValues();
+    const size_t stepSize = static_cast<size_t>(inValues.size());
+    if (stepSize == 0) {
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 代价选择：增量每个进出样本、每个跨断点样本各一次累加，重算每个窗口样本一次
+    // 步长不小于最短段时样本可能跨过多个断点，走重算
+    const size_t incrementalSamples = stepSize * (m_moments.size() + 1);
+    if (stepSize >= m_minSegmentWidth || preferRecompute(incrementalSamples, m_windowSize, 2.0, 1.0)) {
+        computeMoments();
+        ++m_recomputeCalls;
+    } else {
+        // 1. 移出：旧位置 0 .. 步长-1
+        for (size_t i = 0; i < static_cast<size_t>(outValues.size()); ++i) {
+            accumulate(m_kernel.segmentOf(i), i, outValues[static_cast<Eigen::Index>(i)], -1.0);
+        }
+        // 2. 平移：各段位置整体减去步长，sum((p - s)^2 y) = T2 - 2s T1 + s^2 T0，sum((p - s) y) = T1 - s T0
+        const double shift = static_cast<double>(stepSize);
+        for (auto& moments : m_moments) {
+            for (double* sums : {moments.values, moments.counts}) {
+                sums[2] = sums[2] - 2.0 * shift * sums[1] + shift * shift * sums[0];
+                sums[1] = sums[1] - shift * sums[0];
+            }
+        }
+        // 3. 跨断点：新位置落在 [起点 - s, 起点) 的样本原属后一段，挪到前一段
+        const RingVec<double>& values = cache.getValues();
+        for (size_t k = 1; k < m_moments.size(); ++k) {
+            const size_t begin = m_kernel.segments[k].begin;
+            for (size_t position = begin - stepSize; position < begin; ++position) {
+                const double value = values[static_cast<int>(position)];
+                accumulate(k, position, value, -1.0);
+                accumulate(k - 1, position, value, 1.0);
+            }
+        }
+        // 4. 移入：新位置 W-s .. W-1
+        for (size_t i = 0; i < stepSize; ++i) {
+            const size_t position = m_windowSize - stepSize + i;
+            accumulate(m_kernel.segmentOf(position), position, inValues[static_cast<Eigen::Index>(i)], 1.0);
+        }
+    }
+    computeValue();
+    m_version = version;  // 更新版本号
+}
+
+double OnlineKernelSum::getMean() const noexcept {
+    if (m_weightSum == 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return m_value / m_weightSum;
+}
+
+void OnlineKernelSum::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineKernelSum::checkpointState(OnlineCheckpoint& archive) {
+    // 段数由核决定（恢复前已按相同配置构造）
+    for (auto& moments : m_moments) {
+        archive.array(moments.values, 3);
+        archive.array(moments.counts, 3);
+    }
+    archive(m_value, m_weightSum, m_shift, m_version);
+}
+
+void OnlineKernelSum::reanchor() noexcept {
+    const double incrementalValue = m_value;
+    computeMoments();
+    computeValue();
+    recordDrift(incrementalValue, m_value);
+}
+
+void OnlineKernelSum::computeMoments() noexcept {
+    const RingVec<double>& values = m_window.m_onlineDataCache->getValues();
+    m_shift = m_window.m_onlineDataCache->getShift();
+    std::fill(m_moments.begin(), m_moments.end(), SegmentMoments{});
+    for (size_t position = 0; position < static_cast<size_t>(values.size()); ++position) {
+        accumulate(m_kernel.segmentOf(position), position, values[static_cast<int>(position)], 1.0);
+    }
+}
+
+void OnlineKernelSum::computeValue() noexcept {
+    // sum(w x) = sum(w (x - 平移量)) + 平移量 * sum(w)
+    double shiftedValue = 0.0;
+    m_weightSum = 0.0;
+    for (size_t k = 0; k < m_moments.size(); ++k) {
+        const OnlineKernel::Segment& segment = m_kernel.segments[k];
+        const SegmentMoments& moments = m_moments[k];
+        shiftedValue += segment.c0 * moments.values[0] + segment.c1 * moments.values[1] + segment.c2 * moments.values[2];
+        m_weightSum += segment.c0 * moments.counts[0] + segment.c1 * moments.counts[1] + segment.c2 * moments.counts[2];
+    }
+    m_value = shiftedValue + m_shift * m_weightSum;
+}
+
+inline void OnlineKernelSum::accumulate(size_t segment, size_t position, double value, double sign) noexcept {
+    if (std::isnan(value)) {
+        return;
+    }
+    const double p = static_cast<double>(position);
+    const double shifted = sign * (value - m_shift);
+    SegmentMoments& moments = m_moments[segment];
+    moments.values[0] += shifted;
+    moments.values[1] += p * shifted;
+    moments.values[2] += p * p * shifted;
+    moments.counts[0] += sign;
+    moments.counts[1] += sign * p;
+    moments.counts[2] += sign * p * p;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "OnlineDataCache.h"
+#include <memory>
+#include <vector>
+
+// 方法层（核加权）：窗口内按位置加权求和，权重由核函数给出，增量更新 O(步长)
+// 核为分段二次多项式：窗口位置 p（0 为最旧，W-1 为最新）的权重 w(p) = c0 + c1 * p + c2 * p^2，按断点分段
+// 每段维护 sum(p^d * (x - 平移量)) 与 sum(p^d)（有效样本，d = 0, 1, 2）：
+// 窗口滑动 s 步时各段矩按二项式平移（p -> p - s），跨过断点的 s 个样本在相邻两段之间挪动
+// 线性衰减（decay_linear / WMA）只有一段，只需维护和与位置加权和
+
+// 分段多项式核
+struct OnlineKernel {
+    // 段：覆盖 [begin, 下一段的 begin)，段内 w(p) = c0 + c1 * p + c2 * p^2
+    struct Segment {
+        size_t begin = 0;
+        double c0 = 0.0;
+        double c1 = 0.0;
+        double c2 = 0.0;
+    };
+    size_t windowSize = 0;
+    std::vector<Segment> segments;
+
+    // 等权：w(p) = 1
+    [[nodiscard]] static OnlineKernel uniform(size_t windowSize);
+    // 线性衰减：w(p) = p + 1（最新样本权重为 W，同 decay_linear / WMA）
+    [[nodiscard]] static OnlineKernel linearDecay(size_t windowSize);
+    // 三角核：w(p) = min(p + 1, W - p)（中间最大，两端为 1）
+    [[nodiscard]] static OnlineKernel triangular(size_t windowSize);
+    // 自定义分段多项式（各段 begin 须从 0 开始严格递增）
+    [[nodiscard]] static OnlineKernel piecewise(size_t windowSize, std::vector<Segment> segments);
+
+    // 位置 p 的权重
+    [[nodiscard]] double weight(size_t position) const noexcept;
+    // 位置 p 所在的段
+    [[nodiscard]] size_t segmentOf(size_t position) const noexcept;
+    // 最短段的长度（步长小于它时每个样本至多跨过一个断点）
+    [[nodiscard]] size_t minSegmentWidth() const noexcept;
+};
+
+// 在线核加权和类（方法层，NaN 样本不计入）
+class OnlineKernelSum : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层（定长窗口）
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineKernelSum(const Window& window, const OnlineKernel& kernel) {
+        constructor(window, kernel);
+    }
+    // 构造：核的窗口大小须与缓存层一致
+    void constructor(const Window& window, const OnlineKernel& kernel);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值：sum(w(p) * x_p)
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取有效样本的权重和
+    [[nodiscard]] double getWeightSum() const noexcept { return m_weightSum; }
+    // 获取加权均值（无有效样本时为 NaN）
+    [[nodiscard]] double getMean() const noexcept;
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    [[nodiscard]] const OnlineKernel& getKernel() const noexcept { return m_kernel; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 每段的矩：sum(p^d * (x - 平移量)) 与 sum(p^d)，d = 0, 1, 2
+    struct SegmentMoments {
+        double values[3] = {0.0, 0.0, 0.0};
+        double counts[3] = {0.0, 0.0, 0.0};
+    };
+
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算各段的矩
+    void computeMoments() noexcept;
+    // 由各段的矩与核系数合成加权和、权重和
+    void computeValue() noexcept;
+    // 按位置 p 加入（sign 为 1）或移出（sign 为 -1）一个样本
+    inline void accumulate(size_t segment, size_t position, double value, double sign) noexcept;
+
+    Window m_window;
+    OnlineKernel m_kernel;
+    std::vector<SegmentMoments> m_moments;
+    double m_value = 0.0;
+    double m_weightSum = 0.0;
+    double m_shift = 0.0;
+    size_t m_minSegmentWidth = 0;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
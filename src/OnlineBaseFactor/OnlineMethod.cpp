@@ -1,4 +1,5 @@
 #include "OnlineMethod.h"
+#include "OnlineCheckpoint.h"
 #include <iostream>
 #include <cstdlib>
 #include <cmath>
@@ -11,17 +12,15 @@ void OnlineSum::constructor(const Ve& initialValue, const Window& window) {
     CHECK_NULLPTR("OnlineSum", window.m_onlineDataCache);
     
     m_window = window;
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     m_windowSize = m_window.m_onlineDataCache->getWindowSize();
     // 使用compute函数计算sum
-    const auto& samples = m_window.m_onlineDataCache->getValues();
-    for(auto sample : samples){
-        m_value += sample;
-    }
+    computeSum();
     m_version = 0;
 }
 
 void OnlineSum::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -29,20 +28,55 @@ void OnlineSum::update(const Ve& inValues, size_t version) noexcept {
     
     // 更新下游组件（缓存层）
     m_window.m_onlineDataCache->update(inValues, version);
-    
-    // 增量更新：加上新值的总和，减去旧值的总和
+    step(version);
+}
+
+void OnlineSum::step(size_t version) noexcept {
     const auto& outValues = m_window.m_onlineDataCache->getOutValues();
-    m_value += computeSum(outValues, inValues);
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 当前样本数（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineDataCache->getCount();
+    // 代价选择：增量每个进、出样本一次补偿累加，重算每个窗口样本一次
+    if(preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_windowSize, 1.0, 1.0)){
+        computeSum();
+        ++m_recomputeCalls;
+    } else {
+        // 增量更新：加上新值，减去旧值（均先减去平移量，补偿累加）；时间窗口进、出个数可以不同
+        const Eigen::Index count = std::max(inValues.size(), outValues.size());
+        for(Eigen::Index i = 0; i < count; ++i){
+            if(i < inValues.size()){
+                neumaierAdd(m_value, m_compensation, inValues[i] - m_shift);
+            }
+            if(i < outValues.size()){
+                neumaierAdd(m_value, m_compensation, m_shift - outValues[i]);
+            }
+        }
+    }
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineSum::computeSum(const std::deque<double>& outValues, const Ve& inValues) noexcept {
-    double delta = 0.0;
-    for(size_t i = 0; i < inValues.size(); ++i){
-        delta += inValues[i];
-        delta -= outValues[i];
+void OnlineSum::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineSum::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_shift, m_version, m_windowSize);
+}
+
+void OnlineSum::reanchor() noexcept {
+    const double incrementalValue = getValue();
+    computeSum();
+    recordDrift(incrementalValue, getValue());
+}
+
+void OnlineSum::computeSum() noexcept {
+    m_shift = m_window.m_onlineDataCache->getShift();
+    m_value = 0.0;
+    m_compensation = 0.0;
+    const auto& samples = m_window.m_onlineDataCache->getValues();
+    for(auto sample : samples){
+        neumaierAdd(m_value, m_compensation, sample - m_shift);
     }
-    return delta;
 }
 
 // OnlineSumProduct 乘积和
@@ -52,7 +86,7 @@ void OnlineSumProduct::constructor(const Ve& initialValueX, const Ve& initialVal
     CHECK_NULLPTR("OnlineSumProduct", window.m_onlineDataCacheY);
     
     m_window = window;
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     const size_t windowSizeX = m_window.m_onlineDataCacheX->getWindowSize();
     const size_t windowSizeY = m_window.m_onlineDataCacheY->getWindowSize();
     if (windowSizeX != windowSizeY) {
@@ -62,14 +96,11 @@ void OnlineSumProduct::constructor(const Ve& initialValueX, const Ve& initialVal
     m_windowSize = windowSizeX;
     
     // 使用compute函数计算乘积和
-    const auto& samplesX = m_window.m_onlineDataCacheX->getValues();
-    const auto& samplesY = m_window.m_onlineDataCacheY->getValues();
-    for(size_t i = 0; i < samplesX.size(); ++i){
-        m_value += samplesX[i] * samplesY[i];
-    }
+    computeSumProduct();
 }
 
 void OnlineSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -83,23 +114,74 @@ void OnlineSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_t v
     // 更新下游组件（缓存层）
     m_window.m_onlineDataCacheX->update(inValuesX, version);
     m_window.m_onlineDataCacheY->update(inValuesY, version);
-    
-    // 增量更新：加上新值的乘积和，减去旧值的乘积和
+    step(version);
+}
+
+void OnlineSumProduct::step(size_t version) noexcept {
     const auto& oldValuesX = m_window.m_onlineDataCacheX->getOutValues();
     const auto& oldValuesY = m_window.m_onlineDataCacheY->getOutValues();
-    m_value += computeSumProduct(oldValuesX, oldValuesY, inValuesX, inValuesY);
+    const auto& newValuesX = m_window.m_onlineDataCacheX->getInValues();
+    const auto& newValuesY = m_window.m_onlineDataCacheY->getInValues();
+    // 当前样本数（时间窗口每步可变，X、Y 须共用同一组时间戳）
+    m_windowSize = m_window.m_onlineDataCacheX->getCount();
+    // 代价选择：增量每个进、出样本一组补偿累加，重算每个窗口样本一组
+    if(preferRecompute(static_cast<size_t>(newValuesX.size() + oldValuesX.size()), m_windowSize, 1.0, 1.0)){
+        computeSumProduct();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：加上新值的乘积，减去旧值的乘积（均先减去平移量，补偿累加）；时间窗口进、出个数可以不同
+    const Eigen::Index count = std::max(newValuesX.size(), oldValuesX.size());
+    for(Eigen::Index i = 0; i < count; ++i){
+        if(i < newValuesX.size()){
+            const double newX = newValuesX[i] - m_shiftX;
+            const double newY = newValuesY[i] - m_shiftY;
+            neumaierAdd(m_value, m_compensation, newX * newY);
+            neumaierAdd(m_sumX, m_compensationX, newX);
+            neumaierAdd(m_sumY, m_compensationY, newY);
+        }
+        if(i < oldValuesX.size()){
+            const double oldX = oldValuesX[i] - m_shiftX;
+            const double oldY = oldValuesY[i] - m_shiftY;
+            neumaierAdd(m_value, m_compensation, -oldX * oldY);
+            neumaierAdd(m_sumX, m_compensationX, -oldX);
+            neumaierAdd(m_sumY, m_compensationY, -oldY);
+        }
+    }
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineSumProduct::computeSumProduct(const std::deque<double>& oldValuesX, const std::deque<double>& oldValuesY, 
-                                                   const Ve& newValuesX, const Ve& newValuesY) noexcept {
-    // 计算增量：新值乘积和 - 旧值乘积和
-    double delta = 0.0;
-    for(size_t i = 0; i < newValuesX.size(); ++i){
-        delta += newValuesX[i] * newValuesY[i];  // 加上新值的乘积
-        delta -= oldValuesX[i] * oldValuesY[i];  // 减去旧值的乘积
+void OnlineSumProduct::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCacheX.get());
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+}
+
+void OnlineSumProduct::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_sumX, m_compensationX, m_sumY, m_compensationY, m_shiftX, m_shiftY, m_version, m_windowSize);
+}
+
+void OnlineSumProduct::reanchor() noexcept {
+    const double incrementalValue = getValue();
+    computeSumProduct();
+    recordDrift(incrementalValue, getValue());
+}
+
+void OnlineSumProduct::computeSumProduct() noexcept {
+    m_shiftX = m_window.m_onlineDataCacheX->getShift();
+    m_shiftY = m_window.m_onlineDataCacheY->getShift();
+    m_value = m_compensation = 0.0;
+    m_sumX = m_compensationX = 0.0;
+    m_sumY = m_compensationY = 0.0;
+    const auto& samplesX = m_window.m_onlineDataCacheX->getValues();
+    const auto& samplesY = m_window.m_onlineDataCacheY->getValues();
+    for(int i = 0; i < samplesX.size(); ++i){
+        const double sampleX = samplesX[i] - m_shiftX;
+        const double sampleY = samplesY[i] - m_shiftY;
+        neumaierAdd(m_value, m_compensation, sampleX * sampleY);
+        neumaierAdd(m_sumX, m_compensationX, sampleX);
+        neumaierAdd(m_sumY, m_compensationY, sampleY);
     }
-    return delta;
 }
 
 // OnlineMean 均值
@@ -108,14 +190,16 @@ void OnlineMean::constructor(const Ve& initialValue, const Window& window){
     CHECK_NULLPTR("OnlineMean", window.m_onlineSum);
     
     m_window = window;
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     m_windowSize = m_window.m_onlineSum->getWindowSize();
     // 使用compute函数计算均值
     const double sum = m_window.m_onlineSum->getValue();
     m_value = computeMean(sum, m_windowSize);
+    m_shiftedValue = computeMean(m_window.m_onlineSum->getShiftedValue(), m_windowSize);
 }
 
 void OnlineMean::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -123,15 +207,24 @@ void OnlineMean::update(const Ve& inValues, size_t version) noexcept {
     
     // 更新下游组件（方法层）
     m_window.m_onlineSum->update(inValues, version);
-    
-    // 使用compute函数更新自己的值（使用构造时确定的窗口大小）
+    step(version);
+}
+
+void OnlineMean::step(size_t version) noexcept {
+    // 使用compute函数更新自己的值（窗口大小随输入更新，时间窗口每步可变）
+    m_windowSize = m_window.m_onlineSum->getWindowSize();
     const double sum = m_window.m_onlineSum->getValue();
     m_value = computeMean(sum, m_windowSize);
+    m_shiftedValue = computeMean(m_window.m_onlineSum->getShiftedValue(), m_windowSize);
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineMean::computeMean(double sum, size_t windowSize) noexcept {
-    return (windowSize > 0) ? (sum / static_cast<double>(windowSize)) : 0.0;
+void OnlineMean::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineSum.get());
+}
+
+void OnlineMean::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_shiftedValue, m_version, m_windowSize);
 }
 
 // OnlineVar 方差
@@ -141,15 +234,22 @@ void OnlineVar::constructor(const Ve& initialValue, const Window& window){
     CHECK_NULLPTR("OnlineVar", window.m_onlineSumProduct);
     
     m_window = window;
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    // 平移后的均值与平方和须基于同一缓存（平移量相同）
+    if(m_window.m_onlineMean->getShift() != m_window.m_onlineSumProduct->getShiftX()
+        || m_window.m_onlineMean->getShift() != m_window.m_onlineSumProduct->getShiftY()){
+        std::cout << "OnlineVar: 均值与平方和的平移量不一致\n";
+        exit(1);
+    }
 
-    const double mean = m_window.m_onlineMean->getValue();
-    const double sumSquares = m_window.m_onlineSumProduct->getValue();
-    m_value = computeVariance(sumSquares, mean, m_windowSize);
+    const double shiftedMean = m_window.m_onlineMean->getShiftedValue();
+    const double shiftedSumSquares = m_window.m_onlineSumProduct->getShiftedValue();
+    m_value = computeVariance(shiftedSumSquares, shiftedMean, m_windowSize);
 }
 
 void OnlineVar::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -158,19 +258,25 @@ void OnlineVar::update(const Ve& inValues, size_t version) noexcept {
     // 更新窗口中所有下游组件
     m_window.m_onlineMean->update(inValues, version);
     m_window.m_onlineSumProduct->update(inValues, inValues, version);
-    
-    // 使用构造时确定的窗口大小
-    const double mean = m_window.m_onlineMean->getValue();
-    const double sumSquares = m_window.m_onlineSumProduct->getValue();
-    m_value = computeVariance(sumSquares, mean, m_windowSize);
+    step(version);
+}
+
+void OnlineVar::step(size_t version) noexcept {
+    // 窗口大小随输入更新（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    const double shiftedMean = m_window.m_onlineMean->getShiftedValue();
+    const double shiftedSumSquares = m_window.m_onlineSumProduct->getShiftedValue();
+    m_value = computeVariance(shiftedSumSquares, shiftedMean, m_windowSize);
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineVar::computeVariance(double sumSquares, double mean, size_t windowSize) noexcept {
-    const double numSamples = static_cast<double>(windowSize);
-    return (numSamples > 1.0) 
-        ? std::max(0.0, (sumSquares - numSamples * mean * mean) / (numSamples - 1.0))
-        : 0.0;
+void OnlineVar::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMean.get());
+    inputs.push_back(m_window.m_onlineSumProduct.get());
+}
+
+void OnlineVar::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
 }
 
 // OnlineCov 协方差
@@ -182,16 +288,23 @@ void OnlineCov::constructor(const Ve& initialValueX, const Ve& initialValueY, co
     CHECK_NULLPTR("OnlineCov", window.m_onlineMeanY);
     CHECK_NULLPTR("OnlineCov", window.m_onlineSumProductXY);
 
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     m_windowSize = m_window.m_onlineSumProductXY->getWindowSize();
+    // 平移后的均值与乘积和须基于同一缓存（平移量相同）
+    if(m_window.m_onlineMeanX->getShift() != m_window.m_onlineSumProductXY->getShiftX()
+        || m_window.m_onlineMeanY->getShift() != m_window.m_onlineSumProductXY->getShiftY()){
+        std::cout << "OnlineCov: 均值与乘积和的平移量不一致\n";
+        exit(1);
+    }
 
-    const double meanX = m_window.m_onlineMeanX->getValue();
-    const double meanY = m_window.m_onlineMeanY->getValue();
-    const double sumXY = m_window.m_onlineSumProductXY->getValue();
-    m_value = computeCovariance(sumXY, meanX, meanY, m_windowSize);
+    const double shiftedMeanX = m_window.m_onlineMeanX->getShiftedValue();
+    const double shiftedMeanY = m_window.m_onlineMeanY->getShiftedValue();
+    const double shiftedSumXY = m_window.m_onlineSumProductXY->getShiftedValue();
+    m_value = computeCovariance(shiftedSumXY, shiftedMeanX, shiftedMeanY, m_windowSize);
 }
 
 void OnlineCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -201,20 +314,27 @@ void OnlineCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t version)
     m_window.m_onlineMeanX->update(inValuesX, version);
     m_window.m_onlineMeanY->update(inValuesY, version);
     m_window.m_onlineSumProductXY->update(inValuesX, inValuesY, version);
-    
-    // 使用构造时确定的窗口大小
-    const double meanX = m_window.m_onlineMeanX->getValue();
-    const double meanY = m_window.m_onlineMeanY->getValue();
-    const double sumXY = m_window.m_onlineSumProductXY->getValue();
-    m_value = computeCovariance(sumXY, meanX, meanY, m_windowSize);
+    step(version);
+}
+
+void OnlineCov::step(size_t version) noexcept {
+    // 窗口大小随输入更新（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineSumProductXY->getWindowSize();
+    const double shiftedMeanX = m_window.m_onlineMeanX->getShiftedValue();
+    const double shiftedMeanY = m_window.m_onlineMeanY->getShiftedValue();
+    const double shiftedSumXY = m_window.m_onlineSumProductXY->getShiftedValue();
+    m_value = computeCovariance(shiftedSumXY, shiftedMeanX, shiftedMeanY, m_windowSize);
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineCov::computeCovariance(double sumXY, double meanX, double meanY, size_t windowSize) noexcept {
-    const double numSamples = static_cast<double>(windowSize);
-    return (numSamples > 1.0)
-        ? ((sumXY - numSamples * meanX * meanY) / (numSamples - 1.0))
-        : std::numeric_limits<double>::quiet_NaN();
+void OnlineCov::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMeanX.get());
+    inputs.push_back(m_window.m_onlineMeanY.get());
+    inputs.push_back(m_window.m_onlineSumProductXY.get());
+}
+
+void OnlineCov::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
 }
 
 // OnlineCorrelation 相关系数
@@ -226,7 +346,7 @@ void OnlineCorrelation::constructor(const Window& window){
     CHECK_NULLPTR("OnlineCorrelation", m_window.m_onlineVarY);
     CHECK_NULLPTR("OnlineCorrelation", m_window.m_onlineCovXY);
 
-    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
     // 假设X和Y的窗口大小相同，从OnlineVarX获取
     m_windowSize = m_window.m_onlineVarX->getWindowSize();
 
@@ -238,6 +358,7 @@ void OnlineCorrelation::constructor(const Window& window){
 }
 
 void OnlineCorrelation::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
     // 版本号检查：如果版本号相等，则已更新过，直接返回
     if(m_version == version){
         return;
@@ -252,8 +373,12 @@ void OnlineCorrelation::update(const Ve& inValuesX, const Ve& inValuesY, size_t
     m_window.m_onlineVarX->update(inValuesX, version);
     m_window.m_onlineVarY->update(inValuesY, version);
     m_window.m_onlineCovXY->update(inValuesX, inValuesY, version);
-    
-    // 使用构造时确定的窗口大小，更新自己的值
+    step(version);
+}
+
+void OnlineCorrelation::step(size_t version) noexcept {
+    // 窗口大小随输入更新（时间窗口每步可变），更新自己的值
+    m_windowSize = m_window.m_onlineVarX->getWindowSize();
     const double varX = m_window.m_onlineVarX->getValue();
     const double varY = m_window.m_onlineVarY->getValue();
     const double covXY = m_window.m_onlineCovXY->getValue();
@@ -262,11 +387,688 @@ void OnlineCorrelation::update(const Ve& inValuesX, const Ve& inValuesY, size_t
     m_version = version;  // 更新版本号
 }
 
-inline double OnlineCorrelation::computeCorrelation(double covXY, double varX, double varY) noexcept {
-    const double stdX = std::sqrt(varX);
-    const double stdY = std::sqrt(varY);
-    if(stdX == 0.0 || stdY == 0.0 || std::isnan(covXY)){
+void OnlineCorrelation::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineVarX.get());
+    inputs.push_back(m_window.m_onlineVarY.get());
+    inputs.push_back(m_window.m_onlineCovXY.get());
+}
+
+void OnlineCorrelation::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+// OnlineSumPower3 三次方和
+void OnlineSumPower3::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineSumPower3", window.m_onlineDataCache);
+
+    m_window = window;
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    m_shift = m_window.m_onlineDataCache->getShift();
+    computeSumPower();
+    m_version = 0;
+}
+
+void OnlineSumPower3::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineSumPower3::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 当前样本数（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineDataCache->getCount();
+    // 代价选择：增量每个进、出样本一次方次累加，重算每个窗口样本一次（平移量不变）
+    if(preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_windowSize, 1.0, 1.0)){
+        computeSumPower();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：加上新值的三次方，减去旧值的三次方（均先减去平移量，补偿累加）；时间窗口进、出个数可以不同
+    const Eigen::Index count = std::max(inValues.size(), outValues.size());
+    for(Eigen::Index i = 0; i < count; ++i){
+        if(i < inValues.size()){
+            const double newValue = inValues[i] - m_shift;
+            neumaierAdd(m_value, m_compensation, newValue * newValue * newValue);
+        }
+        if(i < outValues.size()){
+            const double oldValue = outValues[i] - m_shift;
+            neumaierAdd(m_value, m_compensation, -(oldValue * oldValue * oldValue));
+        }
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineSumPower3::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineSumPower3::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_shift, m_version, m_windowSize);
+}
+
+void OnlineSumPower3::reanchor() noexcept {
+    // 平移后的方次和随平移量改变，先按旧平移量精确重算以记录漂移，再换用新平移量
+    const double incrementalValue = getShiftedValue();
+    computeSumPower();
+    recordDrift(incrementalValue, getShiftedValue());
+    m_shift = m_window.m_onlineDataCache->getShift();
+    computeSumPower();
+}
+
+void OnlineSumPower3::computeSumPower() noexcept {
+    m_value = 0.0;
+    m_compensation = 0.0;
+    const auto& samples = m_window.m_onlineDataCache->getValues();
+    for(auto sample : samples){
+        const double shifted = sample - m_shift;
+        neumaierAdd(m_value, m_compensation, shifted * shifted * shifted);
+    }
+}
+
+// OnlineSumPower4 四次方和
+void OnlineSumPower4::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineSumPower4", window.m_onlineDataCache);
+
+    m_window = window;
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    m_shift = m_window.m_onlineDataCache->getShift();
+    computeSumPower();
+    m_version = 0;
+}
+
+void OnlineSumPower4::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineSumPower4::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 当前样本数（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineDataCache->getCount();
+    // 代价选择：增量每个进、出样本一次方次累加，重算每个窗口样本一次（平移量不变）
+    if(preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_windowSize, 1.0, 1.0)){
+        computeSumPower();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：加上新值的四次方，减去旧值的四次方（均先减去平移量，补偿累加）；时间窗口进、出个数可以不同
+    const Eigen::Index count = std::max(inValues.size(), outValues.size());
+    for(Eigen::Index i = 0; i < count; ++i){
+        if(i < inValues.size()){
+            const double newValue = inValues[i] - m_shift;
+            const double newSquare = newValue * newValue;
+            neumaierAdd(m_value, m_compensation, newSquare * newSquare);
+        }
+        if(i < outValues.size()){
+            const double oldValue = outValues[i] - m_shift;
+            const double oldSquare = oldValue * oldValue;
+            neumaierAdd(m_value, m_compensation, -(oldSquare * oldSquare));
+        }
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineSumPower4::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineSumPower4::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_shift, m_version, m_windowSize);
+}
+
+void OnlineSumPower4::reanchor() noexcept {
+    // 平移后的方次和随平移量改变，先按旧平移量精确重算以记录漂移，再换用新平移量
+    const double incrementalValue = getShiftedValue();
+    computeSumPower();
+    recordDrift(incrementalValue, getShiftedValue());
+    m_shift = m_window.m_onlineDataCache->getShift();
+    computeSumPower();
+}
+
+void OnlineSumPower4::computeSumPower() noexcept {
+    m_value = 0.0;
+    m_compensation = 0.0;
+    const auto& samples = m_window.m_onlineDataCache->getValues();
+    for(auto sample : samples){
+        const double shifted = sample - m_shift;
+        const double square = shifted * shifted;
+        neumaierAdd(m_value, m_compensation, square * square);
+    }
+}
+
+// OnlineSkew 偏度
+void OnlineSkew::constructor(const Ve& initialValue, const Window& window, bool unbiased){
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineSkew", window.m_onlineMean);
+    CHECK_NULLPTR("OnlineSkew", window.m_onlineSumProduct);
+    CHECK_NULLPTR("OnlineSkew", window.m_onlineSumPower3);
+
+    m_window = window;
+    m_unbiased = unbiased;
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
+    m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    // 各阶平移后的和须基于同一缓存（平移量相同）
+    const double shift = m_window.m_onlineMean->getShift();
+    if(shift != m_window.m_onlineSumProduct->getShiftX() || shift != m_window.m_onlineSumProduct->getShiftY()
+        || shift != m_window.m_onlineSumPower3->getShift()){
+        std::cout << "OnlineSkew: 均值与各阶方次和的平移量不一致\n";
+        exit(1);
+    }
+    step(0);
+}
+
+void OnlineSkew::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新窗口中所有下游组件
+    m_window.m_onlineMean->update(inValues, version);
+    m_window.m_onlineSumProduct->update(inValues, inValues, version);
+    m_window.m_onlineSumPower3->update(inValues, version);
+    step(version);
+}
+
+void OnlineSkew::step(size_t version) noexcept {
+    // 窗口大小随输入更新（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    m_value = computeSkew(m_window.m_onlineMean->getShiftedValue(), m_window.m_onlineSumProduct->getShiftedValue(),
+                          m_window.m_onlineSumPower3->getShiftedValue(), m_windowSize, m_unbiased);
+    m_version = version;  // 更新版本号
+}
+
+void OnlineSkew::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMean.get());
+    inputs.push_back(m_window.m_onlineSumProduct.get());
+    inputs.push_back(m_window.m_onlineSumPower3.get());
+}
+
+void OnlineSkew::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_unbiased, m_version, m_windowSize);
+}
+
+inline double OnlineSkew::computeSkew(double shiftedMean, double shiftedSum2, double shiftedSum3, size_t windowSize, bool unbiased) noexcept {
+    const double numSamples = static_cast<double>(windowSize);
+    if(windowSize < 3){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    // 中心矩：M2 = S2 - n*m^2，M3 = S3 - 3*m*S2 + 2*n*m^3（m 为平移后的均值）
+    const double meanSquare = shiftedMean * shiftedMean;
+    const double centralSum2 = shiftedSum2 - numSamples * meanSquare;
+    const double centralSum3 = shiftedSum3 - 3.0 * shiftedMean * shiftedSum2 + 2.0 * numSamples * meanSquare * shiftedMean;
+    // 两遍算法下恒定序列的标准差恰为 0；增量相消只剩舍入残差，按相对量级判为 0
+    if(centralSum2 <= 1e-12 * shiftedSum2){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double variance = centralSum2 / (unbiased ? numSamples - 1.0 : numSamples);
+    const double skew = centralSum3 / (variance * std::sqrt(variance));
+    return unbiased ? skew * numSamples / ((numSamples - 1.0) * (numSamples - 2.0)) : skew;
+}
+
+// OnlineKurt 峰度
+void OnlineKurt::constructor(const Ve& initialValue, const Window& window, bool unbiased){
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineKurt", window.m_onlineMean);
+    CHECK_NULLPTR("OnlineKurt", window.m_onlineSumProduct);
+    CHECK_NULLPTR("OnlineKurt", window.m_onlineSumPower3);
+    CHECK_NULLPTR("OnlineKurt", window.m_onlineSumPower4);
+
+    m_window = window;
+    m_unbiased = unbiased;
+    // 在构造时确定窗口大小（时间窗口在每步随输入更新）
+    m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    // 各阶平移后的和须基于同一缓存（平移量相同）
+    const double shift = m_window.m_onlineMean->getShift();
+    if(shift != m_window.m_onlineSumProduct->getShiftX() || shift != m_window.m_onlineSumProduct->getShiftY()
+        || shift != m_window.m_onlineSumPower3->getShift() || shift != m_window.m_onlineSumPower4->getShift()){
+        std::cout << "OnlineKurt: 均值与各阶方次和的平移量不一致\n";
+        exit(1);
+    }
+    step(0);
+}
+
+void OnlineKurt::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新窗口中所有下游组件
+    m_window.m_onlineMean->update(inValues, version);
+    m_window.m_onlineSumProduct->update(inValues, inValues, version);
+    m_window.m_onlineSumPower3->update(inValues, version);
+    m_window.m_onlineSumPower4->update(inValues, version);
+    step(version);
+}
+
+void OnlineKurt::step(size_t version) noexcept {
+    // 窗口大小随输入更新（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineSumProduct->getWindowSize();
+    m_value = computeKurt(m_window.m_onlineMean->getShiftedValue(), m_window.m_onlineSumProduct->getShiftedValue(),
+                          m_window.m_onlineSumPower3->getShiftedValue(), m_window.m_onlineSumPower4->getShiftedValue(),
+                          m_windowSize, m_unbiased);
+    m_version = version;  // 更新版本号
+}
+
+void OnlineKurt::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMean.get());
+    inputs.push_back(m_window.m_onlineSumProduct.get());
+    inputs.push_back(m_window.m_onlineSumPower3.get());
+    inputs.push_back(m_window.m_onlineSumPower4.get());
+}
+
+void OnlineKurt::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_unbiased, m_version, m_windowSize);
+}
+
+inline double OnlineKurt::computeKurt(double shiftedMean, double shiftedSum2, double shiftedSum3, double shiftedSum4, size_t windowSize, bool unbiased) noexcept {
+    const double numSamples = static_cast<double>(windowSize);
+    if(windowSize < 4){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    // 中心矩：M2 = S2 - n*m^2，M4 = S4 - 4*m*S3 + 6*m^2*S2 - 3*n*m^4（m 为平移后的均值）
+    const double meanSquare = shiftedMean * shiftedMean;
+    const double centralSum2 = shiftedSum2 - numSamples * meanSquare;
+    const double centralSum4 = shiftedSum4 - 4.0 * shiftedMean * shiftedSum3 + 6.0 * meanSquare * shiftedSum2
+        - 3.0 * numSamples * meanSquare * meanSquare;
+    // 两遍算法下恒定序列的标准差恰为 0；增量相消只剩舍入残差，按相对量级判为 0
+    if(centralSum2 <= 1e-12 * shiftedSum2){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double variance = centralSum2 / (unbiased ? numSamples - 1.0 : numSamples);
+    const double kurt = centralSum4 / (variance * variance);
+    if(!unbiased){
+        return kurt - 3.0;
+    }
+    const double unbiasedFactor = (numSamples * (numSamples + 1.0)) / ((numSamples - 1.0) * (numSamples - 2.0) * (numSamples - 3.0));
+    const double biasCorrection = 3.0 * (numSamples - 1.0) * (numSamples - 1.0) / ((numSamples - 2.0) * (numSamples - 3.0));
+    return unbiasedFactor * kurt - biasCorrection;
+}
+
+// OnlineMax 滑动最大值
+void OnlineMax::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineMax", window.m_onlineDataCache);
+    // 单调队列按样本序号淘汰，只支持定长窗口
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineMax: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    // 按时间顺序（最旧 -> 最新）写入单调队列
+    m_deque.resize(m_windowSize);
+    for(auto sample : m_window.m_onlineDataCache->getValues()){
+        m_deque.push(sample);
+    }
+    m_version = 0;
+}
+
+void OnlineMax::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineMax::step(size_t version) noexcept {
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 代价选择：步长达到窗口时较早的新值写入即过期，清空后只写入当前窗口
+    if(preferRecompute(inValues.size(), m_windowSize, 1.0, 1.0)){
+        m_deque.clear();
+        for(auto sample : m_window.m_onlineDataCache->getValues()){
+            m_deque.push(sample);
+        }
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 逐个写入本次新值，单调队列按样本序号淘汰滑出窗口的旧值（无需读取被挤出值）
+    for(Eigen::Index i = 0; i < inValues.size(); ++i){
+        m_deque.push(inValues[i]);
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineMax::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineMax::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_version, m_windowSize);
+    // 单调队列不写入快照：恢复时由（已恢复的）缓存窗口重建，队首与位置均与保存时一致
+    if(archive.isRestoring()){
+        m_deque.resize(m_windowSize);
+        for(auto sample : m_window.m_onlineDataCache->getValues()){
+            m_deque.push(sample);
+        }
+    }
+}
+
+// OnlineMin 滑动最小值
+void OnlineMin::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineMin", window.m_onlineDataCache);
+    // 单调队列按样本序号淘汰，只支持定长窗口
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineMin: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    // 按时间顺序（最旧 -> 最新）写入单调队列
+    m_deque.resize(m_windowSize);
+    for(auto sample : m_window.m_onlineDataCache->getValues()){
+        m_deque.push(sample);
+    }
+    m_version = 0;
+}
+
+void OnlineMin::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineMin::step(size_t version) noexcept {
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 代价选择：步长达到窗口时较早的新值写入即过期，清空后只写入当前窗口
+    if(preferRecompute(inValues.size(), m_windowSize, 1.0, 1.0)){
+        m_deque.clear();
+        for(auto sample : m_window.m_onlineDataCache->getValues()){
+            m_deque.push(sample);
+        }
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 逐个写入本次新值，单调队列按样本序号淘汰滑出窗口的旧值（无需读取被挤出值）
+    for(Eigen::Index i = 0; i < inValues.size(); ++i){
+        m_deque.push(inValues[i]);
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineMin::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineMin::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_version, m_windowSize);
+    // 单调队列不写入快照：恢复时由（已恢复的）缓存窗口重建
+    if(archive.isRestoring()){
+        m_deque.resize(m_windowSize);
+        for(auto sample : m_window.m_onlineDataCache->getValues()){
+            m_deque.push(sample);
+        }
+    }
+}
+
+// OnlineArgMax 滑动最大值位置
+void OnlineArgMax::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineArgMax", window.m_onlineMax);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineMax->getWindowSize();
+    step(0);
+}
+
+void OnlineArgMax::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（方法层）
+    m_window.m_onlineMax->update(inValues, version);
+    step(version);
+}
+
+void OnlineArgMax::step(size_t version) noexcept {
+    const long position = m_window.m_onlineMax->getArgMax();
+    m_value = (position >= 0) ? static_cast<double>(position) : std::numeric_limits<double>::quiet_NaN();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineArgMax::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMax.get());
+}
+
+void OnlineArgMax::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+// OnlineRange 滑动极差
+void OnlineRange::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineRange", window.m_onlineMax);
+    CHECK_NULLPTR("OnlineRange", window.m_onlineMin);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineMax->getWindowSize();
+    step(0);
+}
+
+void OnlineRange::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（方法层）
+    m_window.m_onlineMax->update(inValues, version);
+    m_window.m_onlineMin->update(inValues, version);
+    step(version);
+}
+
+void OnlineRange::step(size_t version) noexcept {
+    // 窗口内全为 NaN 时最大值、最小值均为 NaN，差值亦为 NaN
+    m_value = m_window.m_onlineMax->getValue() - m_window.m_onlineMin->getValue();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineRange::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineMax.get());
+    inputs.push_back(m_window.m_onlineMin.get());
+}
+
+void OnlineRange::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+// OnlineRank 滑动排名
+void OnlineRank::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineRank", window.m_onlineDataCache);
+    // 样本序号按定长窗口推算，只支持定长窗口
+    if(window.m_onlineDataCache->isTimeWindow()){
+        std::cout << "OnlineRank: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    // 节点池按窗口大小预分配，之后写入/淘汰不再分配内存
+    m_tree.reserve(m_windowSize);
+    m_nextIndex = 0;
+    for(auto sample : m_window.m_onlineDataCache->getValues()){
+        m_tree.insert(Key{sample, m_nextIndex++});
+    }
+    const auto& values = m_window.m_onlineDataCache->getValues();
+    m_value = values.empty() ? std::numeric_limits<double>::quiet_NaN() : getRankPct(values[values.size() - 1]);
+    m_version = 0;
+}
+
+void OnlineRank::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineRank::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    const auto& values = m_window.m_onlineDataCache->getValues();
+    // 代价选择：增量每个样本一次删除、一次插入，重算每个窗口样本一次插入（步长超过窗口时增量路径不可用）
+    if(preferRecompute(inValues.size(), m_windowSize, 2.0, 1.0)){
+        m_tree.clear();
+        m_nextIndex += static_cast<size_t>(inValues.size());
+        size_t index = m_nextIndex - m_windowSize;
+        for(auto sample : values){
+            m_tree.insert(Key{sample, index++});
+        }
+        ++m_recomputeCalls;
+    } else {
+        // 先淘汰被挤出值，再写入新值（NaN 在树内被忽略）
+        const size_t oldestIndex = m_nextIndex - m_windowSize;
+        for(Eigen::Index i = 0; i < outValues.size(); ++i){
+            m_tree.erase(Key{outValues[i], oldestIndex + static_cast<size_t>(i)});
+        }
+        for(Eigen::Index i = 0; i < inValues.size(); ++i){
+            m_tree.insert(Key{inValues[i], m_nextIndex++});
+        }
+    }
+    m_value = getRankPct(values[values.size() - 1]);
+    m_version = version;  // 更新版本号
+}
+
+void OnlineRank::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineRank::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_nextIndex, m_value, m_version, m_windowSize);
+    // 顺序统计树不写入快照：恢复时由（已恢复的）缓存窗口按原样本序号重建
+    if(archive.isRestoring()){
+        m_tree.reserve(m_windowSize);
+        size_t index = m_nextIndex - m_windowSize;
+        for(auto sample : m_window.m_onlineDataCache->getValues()){
+            m_tree.insert(Key{sample, index++});
+        }
+    }
+}
+
+inline double OnlineRank::computeRankPct(size_t lessCount, size_t equalCount) const noexcept {
+    // rankpct：稳定排序后第 idx 个的排名为 (idx+1)/n，并列组内按顺序累加后取平均
+    const int numValues = static_cast<int>(m_tree.size());
+    const int first = static_cast<int>(lessCount) + 1;
+    if(equalCount == 1){
+        return double(first) / numValues;
+    }
+    double sum = double(first) / numValues + double(first + 1) / numValues;
+    for(int rank = first + 2; rank < first + static_cast<int>(equalCount); ++rank){
+        sum += double(rank) / numValues;
+    }
+    return sum / static_cast<int>(equalCount);
+}
+
+double OnlineRank::getRankPct(double value) const noexcept {
+    if(std::isnan(value)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const size_t equalCount = countEqual(value);
+    if(equalCount == 0){
         return std::numeric_limits<double>::quiet_NaN();
     }
-    return std::clamp(covXY / (stdX * stdY), -1.0, 1.0);
-}
\ No newline at end of file
+    return computeRankPct(countLess(value), equalCount);
+}
+
+double OnlineRank::getQuantile(double q) const noexcept {
+    const size_t count = m_tree.size();
+    if(count == 0 || std::isnan(q)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double position = std::clamp(q, 0.0, 1.0) * static_cast<double>(count - 1);
+    const size_t lower = static_cast<size_t>(std::floor(position));
+    const double lowerValue = m_tree.kth(lower).first;
+    if(lower + 1 >= count){
+        return lowerValue;
+    }
+    const double fraction = position - static_cast<double>(lower);
+    return lowerValue + (m_tree.kth(lower + 1).first - lowerValue) * fraction;
+}
+
+double OnlineRank::getTopCutoff(double threshold) const noexcept {
+    const size_t count = m_tree.size();
+    if(count == 0){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    // 无并列时排名 (p+1)/n >= threshold 的最小位置作为起点，再按并列组前后调整
+    const double start = std::ceil(threshold * static_cast<double>(count)) - 1.0;
+    const size_t position = start <= 0.0 ? 0 : std::min(static_cast<size_t>(start), count - 1);
+    double candidate = m_tree.kth(position).first;
+    while(true){
+        const size_t lessCount = countLess(candidate);
+        const size_t equalCount = countEqual(candidate);
+        if(computeRankPct(lessCount, equalCount) >= threshold){
+            // 满足条件：检查前一个不同值是否也满足
+            if(lessCount == 0){
+                return candidate;
+            }
+            const double previous = m_tree.kth(lessCount - 1).first;
+            if(computeRankPct(countLess(previous), countEqual(previous)) < threshold){
+                return candidate;
+            }
+            candidate = previous;
+        } else {
+            // 不满足：移到后一个不同值
+            const size_t next = lessCount + equalCount;
+            if(next >= count){
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            candidate = m_tree.kth(next).first;
+        }
+    }
+}
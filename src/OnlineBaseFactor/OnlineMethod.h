@@ -1,11 +1,17 @@
 #pragma once
 #include "OnlineDataCache.h"
+#include "../Eigen_extra/MonotonicDeque.h"
+#include "../Eigen_extra/OrderStatisticTree.h"
 #include <memory>
 #include <limits>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 // 方法层：通过读取数据缓存值进行统计计算
 
 // 在线求和类（方法层）
+// 内部以缓存平移量为锚累加 x - 平移量，并做 Neumaier 补偿，避免长期 +新值-旧值 的误差累积
 class OnlineSum : public OnlineBaseFactor {
     public:
     struct Window{
@@ -21,21 +27,36 @@ class OnlineSum : public OnlineBaseFactor {
     // 递归更新
     void update(const Ve& inValues, size_t version) noexcept;
     // 获取值
-    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    [[nodiscard]] double getValue() const noexcept { return getShiftedValue() + static_cast<double>(m_windowSize) * m_shift; }
+    // 获取平移后的和：sum(x - 平移量)
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShift() const noexcept { return m_shift; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
     
     private:
-    // 计算队列的 sum
-    [[nodiscard]] static inline double computeSum(const std::deque<double>& outValues, const Ve& inValues) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算平移后的和
+    void computeSum() noexcept;
     
     Window m_window;
-    double m_value = 0.0;
+    double m_value = 0.0;         // 平移后的和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_shift = 0.0;
     size_t m_version = 0;
     size_t m_windowSize = 0;
 };
 
 // 在线乘积和类（方法层，两个输入向量相同时为平方和）
+// 内部维护平移后的乘积和 sum((x - 平移量X) * (y - 平移量Y)) 及平移后的和，均做 Neumaier 补偿
 class OnlineSumProduct : public OnlineBaseFactor {
     public:
     struct Window{
@@ -52,18 +73,40 @@ class OnlineSumProduct : public OnlineBaseFactor {
     void constructor(const Ve& initialValueX, const Ve& initialValueY, const Window& window);
     // 递归更新
     void update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept;
-    // 获取值
-    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取值：sum(x * y) 由平移后的量还原
+    [[nodiscard]] double getValue() const noexcept {
+        return getShiftedValue() + m_shiftY * (m_sumX + m_compensationX) + m_shiftX * (m_sumY + m_compensationY)
+            + static_cast<double>(m_windowSize) * m_shiftX * m_shiftY;
+    }
+    // 获取平移后的乘积和：sum((x - 平移量X) * (y - 平移量Y))
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShiftX() const noexcept { return m_shiftX; }
+    [[nodiscard]] double getShiftY() const noexcept { return m_shiftY; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
     
     private:
-    // 计算增量：新值乘积和 - 旧值乘积和（用于增量更新）
-    [[nodiscard]] static inline double computeSumProduct(const std::deque<double>& oldValuesX, const std::deque<double>& oldValuesY, 
-                                                         const Ve& newValuesX, const Ve& newValuesY) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算平移后的乘积和及平移后的和
+    void computeSumProduct() noexcept;
     
     Window m_window;
-    double m_value = 0.0;
+    double m_value = 0.0;         // 平移后的乘积和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_sumX = 0.0;          // 平移后的 X 之和（补偿前），用于还原 getValue
+    double m_compensationX = 0.0;
+    double m_sumY = 0.0;          // 平移后的 Y 之和（补偿前），用于还原 getValue
+    double m_compensationY = 0.0;
+    double m_shiftX = 0.0;
+    double m_shiftY = 0.0;
     size_t m_version = 0;
     size_t m_windowSize = 0;
 };
@@ -85,17 +128,32 @@ class OnlineMean : public OnlineBaseFactor {
     void update(const Ve& inValues, size_t version) noexcept;
     // 获取值
     [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取平移后的均值：mean - 平移量
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_shiftedValue; }
+    // 获取平移量（与输入的 OnlineSum 一致）
+    [[nodiscard]] double getShift() const noexcept { return m_window.m_onlineSum->getShift(); }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 计算均值（静态组合算子共用）
+    [[nodiscard]] static double computeMean(double sum, size_t windowSize) noexcept {
+        return (windowSize > 0) ? (sum / static_cast<double>(windowSize)) : 0.0;
+    }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
     
     private:
-    // 计算均值
-    [[nodiscard]] static inline double computeMean(double sum, size_t windowSize) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     
     Window m_window;
     double m_value = 0.0;
+    double m_shiftedValue = 0.0;
     size_t m_version = 0;
-    size_t m_windowSize = 0;  // 当前窗口大小，支持未来可变窗口大小
+    size_t m_windowSize = 0;  // 当前窗口大小（时间窗口每步随输入更新）
 };
 
 // 在线方差类
@@ -119,15 +177,29 @@ class OnlineVar : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 计算方差：输入为平移后的平方和与平移后的均值（两者平移量相同，静态组合算子共用）
+    [[nodiscard]] static double computeVariance(double shiftedSumSquares, double shiftedMean, size_t windowSize) noexcept {
+        // 平移不改变方差：平移量接近均值时两项量级接近方差本身，相消误差很小
+        const double numSamples = static_cast<double>(windowSize);
+        return (numSamples > 1.0) 
+            ? std::max(0.0, (shiftedSumSquares - numSamples * shiftedMean * shiftedMean) / (numSamples - 1.0))
+            : 0.0;
+    }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
 
     private:
-    // 计算方差
-    [[nodiscard]] static inline double computeVariance(double sumSquares, double mean, size_t windowSize) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
     
     Window m_window;
     double m_value = 0.0;
     size_t m_version = 0;
-    size_t m_windowSize = 0;  // 当前窗口大小，支持未来可变窗口大小
+    size_t m_windowSize = 0;  // 当前窗口大小（时间窗口每步随输入更新）
 };
 
 // 在线样本协方差类
@@ -152,15 +224,28 @@ class OnlineCov : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 计算协方差：输入为平移后的乘积和与平移后的均值（平移量分别相同，静态组合算子共用）
+    [[nodiscard]] static double computeCovariance(double shiftedSumXY, double shiftedMeanX, double shiftedMeanY, size_t windowSize) noexcept {
+        const double numSamples = static_cast<double>(windowSize);
+        return (numSamples > 1.0)
+            ? ((shiftedSumXY - numSamples * shiftedMeanX * shiftedMeanY) / (numSamples - 1.0))
+            : std::numeric_limits<double>::quiet_NaN();
+    }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
 
     private:
-    // 计算协方差
-    [[nodiscard]] static inline double computeCovariance(double sumXY, double meanX, double meanY, size_t windowSize) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
 
     Window m_window;
     double m_value = std::numeric_limits<double>::quiet_NaN();
     size_t m_version = 0;
-    size_t m_windowSize = 0;  // 当前窗口大小，支持未来可变窗口大小
+    size_t m_windowSize = 0;  // 当前窗口大小（时间窗口每步随输入更新）
 };
 
 // 在线相关系数类
@@ -184,13 +269,403 @@ class OnlineCorrelation : public OnlineBaseFactor {
     [[nodiscard]] double getValue() const noexcept { return m_value; }
     // 获取窗口大小
     [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 计算相关系数（静态组合算子共用）
+    [[nodiscard]] static double computeCorrelation(double covXY, double varX, double varY) noexcept {
+        const double stdX = std::sqrt(varX);
+        const double stdY = std::sqrt(varY);
+        if(stdX == 0.0 || stdY == 0.0 || std::isnan(covXY)){
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return std::clamp(covXY / (stdX * stdY), -1.0, 1.0);
+    }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
     
     private:
-    // 计算相关系数
-    [[nodiscard]] static inline double computeCorrelation(double covXY, double varX, double varY) noexcept;
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
 
     Window m_window;
     double m_value = std::numeric_limits<double>::quiet_NaN();
     size_t m_version = 0;
-    size_t m_windowSize = 0;  // 当前窗口大小，支持未来可变窗口大小（从依赖的OnlineVar中获取）
+    size_t m_windowSize = 0;  // 当前窗口大小（从依赖的OnlineVar中获取，时间窗口每步更新）
+};
+
+// 在线三次方和类（方法层，高阶矩的输入）
+// 内部维护平移后的 sum((x - 平移量)^3)，平移量取自缓存层，Neumaier 补偿
+class OnlineSumPower3 : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineSumPower3(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取平移后的三次方和：sum((x - 平移量)^3)
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShift() const noexcept { return m_shift; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 按当前平移量由窗口精确计算平移后的三次方和
+    void computeSumPower() noexcept;
+
+    Window m_window;
+    double m_value = 0.0;         // 平移后的三次方和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_shift = 0.0;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线四次方和类（方法层，高阶矩的输入）
+// 内部维护平移后的 sum((x - 平移量)^4)，平移量取自缓存层，Neumaier 补偿
+class OnlineSumPower4 : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineSumPower4(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取平移后的四次方和：sum((x - 平移量)^4)
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShift() const noexcept { return m_shift; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 按当前平移量由窗口精确计算平移后的四次方和
+    void computeSumPower() noexcept;
+
+    Window m_window;
+    double m_value = 0.0;         // 平移后的四次方和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_shift = 0.0;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线偏度类（与 BaseFactor::nanskew 一致：无偏时乘 n/((n-1)(n-2))，有偏时为 sum(((x-均值)/标准差)^3)）
+// 中心矩由平移后的 1~3 次方和展开，平移量接近均值时相消误差很小
+class OnlineSkew : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineMean> m_onlineMean;
+        std::shared_ptr<OnlineSumProduct> m_onlineSumProduct;
+        std::shared_ptr<OnlineSumPower3> m_onlineSumPower3;
+    };
+
+    OnlineSkew(const Ve& initialValue, const Window& window, bool unbiased = true) {
+        constructor(initialValue, window, unbiased);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window, bool unbiased);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值（样本数少于 3 或标准差为 0 时为 NaN）
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算偏度：输入为平移后的均值与 2、3 次方和（平移量相同）
+    [[nodiscard]] static inline double computeSkew(double shiftedMean, double shiftedSum2, double shiftedSum3, size_t windowSize, bool unbiased) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    bool m_unbiased = true;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线峰度类（Fisher 峰度，与 BaseFactor::nankurt 一致的无偏/有偏修正）
+class OnlineKurt : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineMean> m_onlineMean;
+        std::shared_ptr<OnlineSumProduct> m_onlineSumProduct;
+        std::shared_ptr<OnlineSumPower3> m_onlineSumPower3;
+        std::shared_ptr<OnlineSumPower4> m_onlineSumPower4;
+    };
+
+    OnlineKurt(const Ve& initialValue, const Window& window, bool unbiased = true) {
+        constructor(initialValue, window, unbiased);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window, bool unbiased);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值（样本数少于 4 或标准差为 0 时为 NaN）
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算峰度：输入为平移后的均值与 2、3、4 次方和（平移量相同）
+    [[nodiscard]] static inline double computeKurt(double shiftedMean, double shiftedSum2, double shiftedSum3, double shiftedSum4, size_t windowSize, bool unbiased) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    bool m_unbiased = true;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线滑动最大值类（方法层，单调队列，均摊 O(1)；NaN 跳过，窗口内全为 NaN 时为 NaN）
+class OnlineMax : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineMax(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_deque.front(); }
+    // 获取最大值在窗口中的位置（0 为最旧样本，并列取最早出现者，全为 NaN 时为 -1）
+    [[nodiscard]] long getArgMax() const noexcept { return m_deque.frontPosition(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    Window m_window;
+    MonotonicDeque<std::greater<double>> m_deque;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线滑动最小值类（方法层，单调队列，均摊 O(1)；NaN 跳过，窗口内全为 NaN 时为 NaN）
+class OnlineMin : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineMin(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_deque.front(); }
+    // 获取最小值在窗口中的位置（0 为最旧样本，并列取最早出现者，全为 NaN 时为 -1）
+    [[nodiscard]] long getArgMin() const noexcept { return m_deque.frontPosition(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    Window m_window;
+    MonotonicDeque<std::less<double>> m_deque;
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线滑动最大值位置类（窗口内逻辑位置，0 为最旧样本；全为 NaN 时为 NaN）
+class OnlineArgMax : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineMax> m_onlineMax;
+    };
+
+    OnlineArgMax(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线滑动极差类（最大值 - 最小值）
+class OnlineRange : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineMax> m_onlineMax;
+        std::shared_ptr<OnlineMin> m_onlineMin;
+    };
+
+    OnlineRange(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线滑动排名类（方法层，顺序统计树，每次写入/淘汰 O(log W)；NaN 跳过）
+// 百分位排名与 BaseFactor::rankpct 一致：排名 (位置+1)/有效个数，并列取平均
+class OnlineRank : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineRank(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值：窗口最新样本的百分位排名（最新样本为 NaN 时为 NaN）
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口内有效样本个数
+    [[nodiscard]] size_t getCount() const noexcept { return m_tree.size(); }
+    // 按值升序访问窗口内值域 [lower, upper) 的样本：visitor(窗口逻辑位置, 值)，O(log W + 命中个数)
+    template<typename Visitor>
+    void forEachInRange(double lower, double upper, Visitor&& visitor) const {
+        const size_t oldestIndex = m_nextIndex - m_windowSize;
+        m_tree.forEachInRange(Key{lower, 0}, Key{upper, 0}, [&](const Key& key, uint32_t){
+            visitor(key.second - oldestIndex, key.first);
+        });
+    }
+    // 窗口内某个值的百分位排名（值须在窗口内，否则为 NaN）
+    [[nodiscard]] double getRankPct(double value) const noexcept;
+    // 滑动分位数（线性插值，与 pandas quantile 默认一致；q 取 [0, 1]）
+    [[nodiscard]] double getQuantile(double q) const noexcept;
+    // 百分位排名不低于 threshold 的最小窗口值（如 0.9 即前 10% 的下界；不存在时为 NaN）
+    // 排名随值单调，故 value >= 该下界 即等价于 rankpct(value) >= threshold
+    [[nodiscard]] double getTopCutoff(double threshold) const noexcept;
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由严格小于个数、相等个数计算百分位排名（与 rankpct 的浮点运算顺序一致）
+    double computeRankPct(size_t lessCount, size_t equalCount) const noexcept;
+    // 严格小于 value 的个数、等于 value 的个数
+    size_t countLess(double value) const noexcept { return m_tree.countLess(Key{value, 0}); }
+    size_t countEqual(double value) const noexcept {
+        return m_tree.countLess(Key{value, std::numeric_limits<size_t>::max()}) - countLess(value);
+    }
+
+    // 键为 (值, 样本序号)：相等值按进入窗口先后区分，可由值域反查窗口位置
+    using Key = std::pair<double, size_t>;
+
+    Window m_window;
+    OrderStatisticTree<Key> m_tree;
+    size_t m_nextIndex = 0;  // 下一个样本的序号（窗口最旧样本序号为 m_nextIndex - 窗口大小）
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
 };
@@ -0,0 +1,572 @@
+#include "OnlineNanMethod.h"
+#include "OnlineCheckpoint.h"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// OnlineNanSum 求和（NaN 跳过）
+void OnlineNanSum::constructor(const Ve& initialValue, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineNanSum", window.m_onlineDataCache);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCache->getWindowSize();
+    computeSum();
+    m_version = 0;
+}
+
+void OnlineNanSum::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCache->update(inValues, version);
+    step(version);
+}
+
+void OnlineNanSum::step(size_t version) noexcept {
+    const auto& outValues = m_window.m_onlineDataCache->getOutValues();
+    const auto& inValues = m_window.m_onlineDataCache->getInValues();
+    // 当前样本数（时间窗口每步可变）
+    m_windowSize = m_window.m_onlineDataCache->getCount();
+    // 代价选择：增量每个进、出样本一次补偿累加，重算每个窗口样本一次
+    if(preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_windowSize, 1.0, 1.0)){
+        computeSum();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：有效新值加入、有效旧值移出，同步维护有效样本数；时间窗口进、出个数可以不同
+    const Eigen::Index count = std::max(inValues.size(), outValues.size());
+    for(Eigen::Index i = 0; i < count; ++i){
+        if(i < inValues.size() && !std::isnan(inValues[i])){
+            neumaierAdd(m_value, m_compensation, inValues[i] - m_shift);
+            ++m_count;
+        }
+        if(i < outValues.size() && !std::isnan(outValues[i])){
+            neumaierAdd(m_value, m_compensation, m_shift - outValues[i]);
+            --m_count;
+        }
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanSum::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCache.get());
+}
+
+void OnlineNanSum::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_shift, m_count, m_version, m_windowSize);
+}
+
+void OnlineNanSum::reanchor() noexcept {
+    const double incrementalValue = getValue();
+    computeSum();
+    recordDrift(incrementalValue, getValue());
+}
+
+void OnlineNanSum::computeSum() noexcept {
+    m_shift = m_window.m_onlineDataCache->getShift();
+    m_value = 0.0;
+    m_compensation = 0.0;
+    m_count = 0;
+    const auto& samples = m_window.m_onlineDataCache->getValues();
+    for(auto sample : samples){
+        if(std::isnan(sample)){continue;}
+        neumaierAdd(m_value, m_compensation, sample - m_shift);
+        ++m_count;
+    }
+}
+
+// OnlineNanSumProduct 乘积和（NaN 跳过，成对有效）
+void OnlineNanSumProduct::constructor(const Ve& initialValueX, const Ve& initialValueY, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建），掩码缓存可为空
+    CHECK_NULLPTR("OnlineNanSumProduct", window.m_onlineDataCacheX);
+    CHECK_NULLPTR("OnlineNanSumProduct", window.m_onlineDataCacheY);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    const size_t windowSizeX = m_window.m_onlineDataCacheX->getWindowSize();
+    const size_t windowSizeY = m_window.m_onlineDataCacheY->getWindowSize();
+    const size_t windowSizeMask = m_window.m_onlineDataCacheMask ? m_window.m_onlineDataCacheMask->getWindowSize() : windowSizeX;
+    if (windowSizeX != windowSizeY || windowSizeX != windowSizeMask) {
+        std::cout << "OnlineNanSumProduct: X、Y和掩码的窗口大小不一致\n";
+        exit(1);
+    }
+    m_windowSize = windowSizeX;
+    computeSumProduct();
+    m_version = 0;
+}
+
+void OnlineNanSumProduct::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    if(inValuesX.size() != inValuesY.size()){
+        std::cout << "OnlineNanSumProduct::update: X和Y的向量大小不一致\n";
+        exit(1);
+    }
+
+    // 更新下游组件（缓存层，掩码缓存由其他节点或调用方更新）
+    m_window.m_onlineDataCacheX->update(inValuesX, version);
+    m_window.m_onlineDataCacheY->update(inValuesY, version);
+    step(version);
+}
+
+void OnlineNanSumProduct::step(size_t version) noexcept {
+    const auto& oldValuesX = m_window.m_onlineDataCacheX->getOutValues();
+    const auto& oldValuesY = m_window.m_onlineDataCacheY->getOutValues();
+    const auto& newValuesX = m_window.m_onlineDataCacheX->getInValues();
+    const auto& newValuesY = m_window.m_onlineDataCacheY->getInValues();
+    // 当前样本数（时间窗口每步可变，X、Y 与掩码须共用同一组时间戳）
+    m_windowSize = m_window.m_onlineDataCacheX->getCount();
+    // 代价选择：增量每个进、出样本一组补偿累加，重算每个窗口样本一组
+    if(preferRecompute(static_cast<size_t>(newValuesX.size() + oldValuesX.size()), m_windowSize, 1.0, 1.0)){
+        computeSumProduct();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：成对有效的新样本加入、成对有效的旧样本移出；时间窗口进、出个数可以不同
+    const auto* maskCache = m_window.m_onlineDataCacheMask.get();
+    const double* newValuesMask = maskCache ? maskCache->getInValues().data() : nullptr;
+    const double* oldValuesMask = maskCache ? maskCache->getOutValues().data() : nullptr;
+    const Eigen::Index count = std::max(newValuesX.size(), oldValuesX.size());
+    for(Eigen::Index i = 0; i < count; ++i){
+        if(i < newValuesX.size()){
+            accumulate(newValuesX[i], newValuesY[i], newValuesMask ? newValuesMask[i] : 0.0, 1.0);
+        }
+        if(i < oldValuesX.size()){
+            accumulate(oldValuesX[i], oldValuesY[i], oldValuesMask ? oldValuesMask[i] : 0.0, -1.0);
+        }
+    }
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanSumProduct::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCacheX.get());
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+    if(m_window.m_onlineDataCacheMask){
+        inputs.push_back(m_window.m_onlineDataCacheMask.get());
+    }
+}
+
+void OnlineNanSumProduct::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_compensation, m_sumX, m_compensationX, m_sumY, m_compensationY, m_shiftX, m_shiftY, m_count, m_version, m_windowSize);
+}
+
+void OnlineNanSumProduct::reanchor() noexcept {
+    const double incrementalValue = getValue();
+    computeSumProduct();
+    recordDrift(incrementalValue, getValue());
+}
+
+void OnlineNanSumProduct::computeSumProduct() noexcept {
+    m_shiftX = m_window.m_onlineDataCacheX->getShift();
+    m_shiftY = m_window.m_onlineDataCacheY->getShift();
+    m_value = m_compensation = 0.0;
+    m_sumX = m_compensationX = 0.0;
+    m_sumY = m_compensationY = 0.0;
+    m_count = 0;
+    const auto& samplesX = m_window.m_onlineDataCacheX->getValues();
+    const auto& samplesY = m_window.m_onlineDataCacheY->getValues();
+    const auto* maskCache = m_window.m_onlineDataCacheMask.get();
+    for(int i = 0; i < samplesX.size(); ++i){
+        const double mask = maskCache ? maskCache->getValues()[i] : 0.0;
+        accumulate(samplesX[i], samplesY[i], mask, 1.0);
+    }
+}
+
+inline void OnlineNanSumProduct::accumulate(double x, double y, double mask, double sign) noexcept {
+    if(std::isnan(x) || std::isnan(y) || std::isnan(mask)){
+        return;
+    }
+    const double shiftedX = x - m_shiftX;
+    const double shiftedY = y - m_shiftY;
+    neumaierAdd(m_value, m_compensation, sign * shiftedX * shiftedY);
+    neumaierAdd(m_sumX, m_compensationX, sign * shiftedX);
+    neumaierAdd(m_sumY, m_compensationY, sign * shiftedY);
+    if(sign > 0.0){
+        ++m_count;
+    } else {
+        --m_count;
+    }
+}
+
+// OnlineNanMean 均值（NaN 跳过）
+void OnlineNanMean::constructor(const Ve& initialValue, const Window& window){
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineNanMean", window.m_onlineNanSum);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineNanSum->getWindowSize();
+    step(0);
+}
+
+void OnlineNanMean::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（方法层）
+    m_window.m_onlineNanSum->update(inValues, version);
+    step(version);
+}
+
+void OnlineNanMean::step(size_t version) noexcept {
+    const auto& sum = *m_window.m_onlineNanSum;
+    m_value = computeMean(sum.getShiftedValue(), sum.getShift(), sum.getCount());
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanMean::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineNanSum.get());
+}
+
+void OnlineNanMean::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+inline double OnlineNanMean::computeMean(double shiftedSum, double shift, size_t count) noexcept {
+    return (count > 0)
+        ? (shift + shiftedSum / static_cast<double>(count))
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+// OnlineNanVar 方差（NaN 跳过）
+void OnlineNanVar::constructor(const Ve& initialValue, const Window& window){
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineNanVar", window.m_onlineNanSumProduct);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineNanSumProduct->getWindowSize();
+    step(0);
+}
+
+void OnlineNanVar::update(const Ve& inValues, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（方法层）
+    m_window.m_onlineNanSumProduct->update(inValues, inValues, version);
+    step(version);
+}
+
+void OnlineNanVar::step(size_t version) noexcept {
+    const auto& sumProduct = *m_window.m_onlineNanSumProduct;
+    m_value = computeVariance(sumProduct.getShiftedValue(), sumProduct.getShiftedSumX(), sumProduct.getCount());
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanVar::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineNanSumProduct.get());
+}
+
+void OnlineNanVar::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+inline double OnlineNanVar::computeVariance(double shiftedSumSquares, double shiftedSum, size_t count) noexcept {
+    const double numSamples = static_cast<double>(count);
+    return (count > 1)
+        ? std::max(0.0, (shiftedSumSquares - shiftedSum * shiftedSum / numSamples) / (numSamples - 1.0))
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+// OnlineNanCov 协方差（NaN 跳过）
+void OnlineNanCov::constructor(const Ve& initialValueX, const Ve& initialValueY, const Window& window){
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineNanCov", window.m_onlineNanSumProductXY);
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineNanSumProductXY->getWindowSize();
+    step(0);
+}
+
+void OnlineNanCov::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    // 更新下游组件（方法层）
+    m_window.m_onlineNanSumProductXY->update(inValuesX, inValuesY, version);
+    step(version);
+}
+
+void OnlineNanCov::step(size_t version) noexcept {
+    const auto& sumProduct = *m_window.m_onlineNanSumProductXY;
+    m_value = computeCovariance(sumProduct.getShiftedValue(), sumProduct.getShiftedSumX(),
+                                sumProduct.getShiftedSumY(), sumProduct.getCount());
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanCov::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineNanSumProductXY.get());
+}
+
+void OnlineNanCov::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+inline double OnlineNanCov::computeCovariance(double shiftedSumXY, double shiftedSumX, double shiftedSumY, size_t count) noexcept {
+    const double numSamples = static_cast<double>(count);
+    return (count > 1)
+        ? ((shiftedSumXY - shiftedSumX * shiftedSumY / numSamples) / (numSamples - 1.0))
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+// OnlineNanCorrelation 相关系数（NaN 跳过）
+void OnlineNanCorrelation::constructor(const Window& window){
+    m_window = window;
+
+    // 检查所有必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineNanCorrelation", m_window.m_onlineNanVarX);
+    CHECK_NULLPTR("OnlineNanCorrelation", m_window.m_onlineNanVarY);
+    CHECK_NULLPTR("OnlineNanCorrelation", m_window.m_onlineNanCovXY);
+
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineNanCovXY->getWindowSize();
+    step(0);
+}
+
+void OnlineNanCorrelation::update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    if(inValuesX.size() != inValuesY.size()){
+        std::cout << "OnlineNanCorrelation::update: X和Y的向量大小不一致\n";
+        exit(1);
+    }
+
+    // 更新下游组件（方法层）：协方差先更新 X、Y 缓存，方差的掩码缓存随之就绪
+    m_window.m_onlineNanCovXY->update(inValuesX, inValuesY, version);
+    m_window.m_onlineNanVarX->update(inValuesX, version);
+    m_window.m_onlineNanVarY->update(inValuesY, version);
+    step(version);
+}
+
+void OnlineNanCorrelation::step(size_t version) noexcept {
+    const double varX = m_window.m_onlineNanVarX->getValue();
+    const double varY = m_window.m_onlineNanVarY->getValue();
+    const double covXY = m_window.m_onlineNanCovXY->getValue();
+    m_value = computeCorrelation(covXY, varX, varY);
+    m_version = version;  // 更新版本号
+}
+
+void OnlineNanCorrelation::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineNanVarX.get());
+    inputs.push_back(m_window.m_onlineNanVarY.get());
+    inputs.push_back(m_window.m_onlineNanCovXY.get());
+}
+
+void OnlineNanCorrelation::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_value, m_version, m_windowSize);
+}
+
+inline double OnlineNanCorrelation::computeCorrelation(double covXY, double varX, double varY) noexcept {
+    const double stdX = std::sqrt(varX);
+    const double stdY = std::sqrt(varY);
+    if(stdX == 0.0 || stdY == 0.0 || std::isnan(stdX) || std::isnan(stdY) || std::isnan(covXY)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::clamp(covXY / (stdX * stdY), -1.0, 1.0);
+}
+
+// OnlineMaskedCorrelation 掩码相关系数
+void OnlineMaskedCorrelation::constructor(const Ve& initialFlags, const Window& window) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineMaskedCorrelation", window.m_onlineDataCacheX);
+    CHECK_NULLPTR("OnlineMaskedCorrelation", window.m_onlineDataCacheY);
+    // 标记环按窗口位置对齐，只支持定长窗口
+    if(window.m_onlineDataCacheX->isTimeWindow() || window.m_onlineDataCacheY->isTimeWindow()){
+        std::cout << "OnlineMaskedCorrelation: 不支持时间窗口缓存\n";
+        exit(1);
+    }
+
+    m_window = window;
+    // 在构造时确定窗口大小（只确定一次，后续不再更新）
+    const size_t windowSizeX = m_window.m_onlineDataCacheX->getWindowSize();
+    const size_t windowSizeY = m_window.m_onlineDataCacheY->getWindowSize();
+    if (windowSizeX != windowSizeY || static_cast<size_t>(initialFlags.size()) != windowSizeX) {
+        std::cout << "OnlineMaskedCorrelation: X、Y和标记的窗口大小不一致\n";
+        exit(1);
+    }
+    m_windowSize = windowSizeX;
+    m_flags.assign(m_windowSize, 0);
+    m_inFlags = Ve::Zero(static_cast<Eigen::Index>(m_windowSize));
+    m_flagHead = 0;
+    for(size_t i = 0; i < m_windowSize; ++i){
+        m_flags[i] = (initialFlags[static_cast<Eigen::Index>(i)] != 0.0) ? 1 : 0;
+    }
+    computeSums();
+    computeCorrelation();
+    m_version = 0;
+}
+
+void OnlineMaskedCorrelation::update(const Ve& inValuesX, const Ve& inValuesY, const Ve& inFlags, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    if(inValuesX.size() != inValuesY.size() || inValuesX.size() != inFlags.size()){
+        std::cout << "OnlineMaskedCorrelation::update: X、Y和标记的向量大小不一致\n";
+        exit(1);
+    }
+
+    // 标记写入预分配缓冲，供 step 读取（步长超过窗口时扩容）
+    if(inFlags.size() > m_inFlags.size()){
+        m_inFlags.resize(inFlags.size());
+    }
+    m_inFlags.head(inFlags.size()) = inFlags;
+    // 更新下游组件（缓存层）
+    m_window.m_onlineDataCacheX->update(inValuesX, version);
+    m_window.m_onlineDataCacheY->update(inValuesY, version);
+    step(version);
+}
+
+void OnlineMaskedCorrelation::step(size_t version) noexcept {
+    const auto& oldValuesX = m_window.m_onlineDataCacheX->getOutValues();
+    const auto& oldValuesY = m_window.m_onlineDataCacheY->getOutValues();
+    const auto& newValuesX = m_window.m_onlineDataCacheX->getInValues();
+    const auto& newValuesY = m_window.m_onlineDataCacheY->getInValues();
+    // 代价选择：增量每个样本进、出各一组补偿累加，重算每个窗口样本一组；标记环两条路径都逐个写入
+    if(preferRecompute(newValuesX.size(), m_windowSize, 2.0, 1.0)){
+        for(Eigen::Index i = 0; i < newValuesX.size(); ++i){
+            m_flags[m_flagHead] = (m_inFlags[i] != 0.0) ? 1 : 0;
+            m_flagHead = (m_flagHead + 1 == m_windowSize) ? 0 : m_flagHead + 1;
+        }
+        computeSums();
+        computeCorrelation();
+        ++m_recomputeCalls;
+        m_version = version;  // 更新版本号
+        return;
+    }
+    // 增量更新：被挤出样本按其当前标记移出，新样本按本次标记加入
+    for(Eigen::Index i = 0; i < newValuesX.size(); ++i){
+        uint8_t& flag = m_flags[m_flagHead];
+        if(flag){
+            accumulate(oldValuesX[i], oldValuesY[i], -1.0);
+        }
+        // 最旧位置出队即成为最新位置
+        flag = (m_inFlags[i] != 0.0) ? 1 : 0;
+        if(flag){
+            accumulate(newValuesX[i], newValuesY[i], 1.0);
+        }
+        m_flagHead = (m_flagHead + 1 == m_windowSize) ? 0 : m_flagHead + 1;
+    }
+    computeCorrelation();
+    m_version = version;  // 更新版本号
+}
+
+void OnlineMaskedCorrelation::setFlag(size_t logicalIndex, bool flag) noexcept {
+    uint8_t& current = m_flags[physical(logicalIndex)];
+    if((current != 0) == flag){
+        return;
+    }
+    current = flag ? 1 : 0;
+    const int index = static_cast<int>(logicalIndex);
+    accumulate(m_window.m_onlineDataCacheX->getValues()[index], m_window.m_onlineDataCacheY->getValues()[index], flag ? 1.0 : -1.0);
+    computeCorrelation();
+}
+
+void OnlineMaskedCorrelation::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    inputs.push_back(m_window.m_onlineDataCacheX.get());
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+}
+
+void OnlineMaskedCorrelation::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_flags, m_flagHead);
+    archive(m_sumX, m_compensationX, m_sumY, m_compensationY, m_sumXX, m_compensationXX);
+    archive(m_sumYY, m_compensationYY, m_sumXY, m_compensationXY, m_shiftX, m_shiftY);
+    archive(m_value, m_count, m_version, m_windowSize);
+}
+
+void OnlineMaskedCorrelation::reanchor() noexcept {
+    const double incrementalValue = m_value;
+    computeSums();
+    computeCorrelation();
+    recordDrift(incrementalValue, m_value);
+}
+
+void OnlineMaskedCorrelation::computeSums() noexcept {
+    m_shiftX = m_window.m_onlineDataCacheX->getShift();
+    m_shiftY = m_window.m_onlineDataCacheY->getShift();
+    m_sumX = m_compensationX = 0.0;
+    m_sumY = m_compensationY = 0.0;
+    m_sumXX = m_compensationXX = 0.0;
+    m_sumYY = m_compensationYY = 0.0;
+    m_sumXY = m_compensationXY = 0.0;
+    m_count = 0;
+    const auto& samplesX = m_window.m_onlineDataCacheX->getValues();
+    const auto& samplesY = m_window.m_onlineDataCacheY->getValues();
+    for(int i = 0; i < samplesX.size(); ++i){
+        if(m_flags[physical(static_cast<size_t>(i))]){
+            accumulate(samplesX[i], samplesY[i], 1.0);
+        }
+    }
+}
+
+inline void OnlineMaskedCorrelation::accumulate(double x, double y, double sign) noexcept {
+    if(std::isnan(x) || std::isnan(y)){
+        return;
+    }
+    const double shiftedX = x - m_shiftX;
+    const double shiftedY = y - m_shiftY;
+    neumaierAdd(m_sumX, m_compensationX, sign * shiftedX);
+    neumaierAdd(m_sumY, m_compensationY, sign * shiftedY);
+    neumaierAdd(m_sumXX, m_compensationXX, sign * shiftedX * shiftedX);
+    neumaierAdd(m_sumYY, m_compensationYY, sign * shiftedY * shiftedY);
+    neumaierAdd(m_sumXY, m_compensationXY, sign * shiftedX * shiftedY);
+    if(sign > 0.0){
+        ++m_count;
+    } else {
+        --m_count;
+    }
+}
+
+void OnlineMaskedCorrelation::computeCorrelation() noexcept {
+    if(m_count == 0){
+        m_value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    // 离差平方和：S_xx - S_x^2 / n（平移后计算，平移量不影响结果）
+    const double count = static_cast<double>(m_count);
+    const double sumX = m_sumX + m_compensationX;
+    const double sumY = m_sumY + m_compensationY;
+    const double sumXX = m_sumXX + m_compensationXX;
+    const double sumYY = m_sumYY + m_compensationYY;
+    const double devXX = sumXX - sumX * sumX / count;
+    const double devYY = sumYY - sumY * sumY / count;
+    const double devXY = (m_sumXY + m_compensationXY) - sumX * sumY / count;
+    // 两遍算法下恒定序列的离差恰为 0；增量相消只剩舍入残差，按相对量级判为 0
+    constexpr double relativeEps = 1e-12;
+    if(devXX <= relativeEps * sumXX || devYY <= relativeEps * sumYY){
+        m_value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    m_value = std::clamp(devXY / std::sqrt(devXX * devYY), -1.0, 1.0);
+}
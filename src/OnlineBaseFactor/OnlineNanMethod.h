@@ -0,0 +1,358 @@
+#pragma once
+#include "OnlineDataCache.h"
+#include <memory>
+#include <limits>
+#include <vector>
+#include <cstdint>
+
+// 方法层（NaN 跳过版本）：窗口内的 NaN 不参与计算，维护有效样本数，含缺失值的序列仍走 O(1) 增量更新
+// 单输入节点统计该序列的有效数；双输入节点统计成对有效数（X、Y 同时非 NaN，与 BaseFactor::pearson_correlation 一致）
+// 与 OnlineSum/OnlineSumProduct 相同，内部以缓存平移量为锚累加并做 Neumaier 补偿，支持 reanchor
+
+// 在线求和类（NaN 跳过）
+class OnlineNanSum : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层
+        std::shared_ptr<OnlineDataCache> m_onlineDataCache;
+    };
+
+    OnlineNanSum(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值（无有效值时为 0）
+    [[nodiscard]] double getValue() const noexcept { return getShiftedValue() + static_cast<double>(m_count) * m_shift; }
+    // 获取平移后的和：sum(x - 平移量)
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShift() const noexcept { return m_shift; }
+    // 获取窗口内有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算平移后的和与有效样本数
+    void computeSum() noexcept;
+
+    Window m_window;
+    double m_value = 0.0;         // 平移后的和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_shift = 0.0;
+    size_t m_count = 0;           // 有效样本数
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线乘积和类（NaN 跳过，成对有效：X、Y 及可选的掩码序列同时非 NaN 的位置才参与）
+// 掩码缓存用于相关系数：以 Y 为掩码的 X 平方和只统计与 Y 成对有效的样本
+// 注意：掩码缓存不由本节点 update，须由共用它的其他节点或调用方先行更新
+class OnlineNanSumProduct : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层X
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheX;
+        // 缓存层Y
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheY;
+        // 缓存层（掩码，可为空）
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheMask;
+    };
+
+    OnlineNanSumProduct(const Ve& initialValueX, const Ve& initialValueY, const Window& window) {
+        constructor(initialValueX, initialValueY, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValueX, const Ve& initialValueY, const Window& window);
+    // 递归更新（只更新 X、Y 缓存）
+    void update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept;
+    // 获取值：成对有效样本的 sum(x * y)
+    [[nodiscard]] double getValue() const noexcept {
+        return getShiftedValue() + m_shiftY * getShiftedSumX() + m_shiftX * getShiftedSumY()
+            + static_cast<double>(m_count) * m_shiftX * m_shiftY;
+    }
+    // 获取平移后的乘积和：sum((x - 平移量X) * (y - 平移量Y))
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    // 获取成对有效样本平移后的 X、Y 之和
+    [[nodiscard]] double getShiftedSumX() const noexcept { return m_sumX + m_compensationX; }
+    [[nodiscard]] double getShiftedSumY() const noexcept { return m_sumY + m_compensationY; }
+    // 获取平移量（重锚时从缓存层复制）
+    [[nodiscard]] double getShiftX() const noexcept { return m_shiftX; }
+    [[nodiscard]] double getShiftY() const noexcept { return m_shiftY; }
+    // 获取成对有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确计算平移后的乘积和、平移后的和与成对有效样本数
+    void computeSumProduct() noexcept;
+    // 累加一个成对样本（sign 为 +1 加入、-1 移出），任一值为 NaN 时跳过
+    inline void accumulate(double x, double y, double mask, double sign) noexcept;
+
+    Window m_window;
+    double m_value = 0.0;         // 平移后的乘积和（补偿前）
+    double m_compensation = 0.0;  // Neumaier 补偿项
+    double m_sumX = 0.0;          // 平移后的 X 之和（补偿前）
+    double m_compensationX = 0.0;
+    double m_sumY = 0.0;          // 平移后的 Y 之和（补偿前）
+    double m_compensationY = 0.0;
+    double m_shiftX = 0.0;
+    double m_shiftY = 0.0;
+    size_t m_count = 0;           // 成对有效样本数
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线均值类（NaN 跳过，无有效值时为 NaN，与 BaseFactor::nanmean 一致）
+class OnlineNanMean : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineNanSum> m_onlineNanSum;
+    };
+
+    OnlineNanMean(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取窗口内有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_window.m_onlineNanSum->getCount(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算均值
+    [[nodiscard]] static inline double computeMean(double shiftedSum, double shift, size_t count) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线方差类（NaN 跳过，样本无偏，有效值少于2个时为 NaN，与 BaseFactor::nanstd 的平方一致）
+// 均值取自同一乘积和节点的成对有效样本，掩码乘积和即得到与另一序列成对有效的方差
+class OnlineNanVar : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后），X 与 Y 为同一缓存
+        std::shared_ptr<OnlineNanSumProduct> m_onlineNanSumProduct;
+    };
+
+    OnlineNanVar(const Ve& initialValue, const Window& window) {
+        constructor(initialValue, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValue, const Window& window);
+    // 递归更新
+    void update(const Ve& inValues, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取参与计算的有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_window.m_onlineNanSumProduct->getCount(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算方差：输入为平移后的平方和、平移后的和与有效样本数
+    [[nodiscard]] static inline double computeVariance(double shiftedSumSquares, double shiftedSum, size_t count) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线样本协方差类（NaN 跳过，成对有效样本，有效对少于2个时为 NaN）
+class OnlineNanCov : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineNanSumProduct> m_onlineNanSumProductXY;
+    };
+
+    OnlineNanCov(const Ve& initialValueX, const Ve& initialValueY, const Window& window) {
+        constructor(initialValueX, initialValueY, window);
+    }
+    // 构造
+    void constructor(const Ve& initialValueX, const Ve& initialValueY, const Window& window);
+    // 递归更新
+    void update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取成对有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_window.m_onlineNanSumProductXY->getCount(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算协方差：输入为平移后的乘积和、平移后的和与成对有效样本数
+    [[nodiscard]] static inline double computeCovariance(double shiftedSumXY, double shiftedSumX, double shiftedSumY, size_t count) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线相关系数类（NaN 跳过）
+// 方差须以另一序列为掩码构建（成对有效），此时与 BaseFactor::pearson_correlation 一致
+class OnlineNanCorrelation : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 方法层（去重后）
+        std::shared_ptr<OnlineNanVar> m_onlineNanVarX;
+        std::shared_ptr<OnlineNanVar> m_onlineNanVarY;
+        std::shared_ptr<OnlineNanCov> m_onlineNanCovXY;
+    };
+
+    OnlineNanCorrelation(const Window& window) {
+        constructor(window);
+    }
+    // 构造
+    void constructor(const Window& window);
+    // 递归更新（先更新协方差，使方差的掩码缓存已是本版本）
+    void update(const Ve& inValuesX, const Ve& inValuesY, size_t version) noexcept;
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取成对有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_window.m_onlineNanCovXY->getCount(); }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：输入已重锚，重新计算
+    void reanchor() noexcept override { step(m_version); }
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 计算相关系数
+    [[nodiscard]] static inline double computeCorrelation(double covXY, double varX, double varY) noexcept;
+
+    Window m_window;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
+
+// 在线掩码相关系数类（只统计被标记的成对有效样本，标记可对窗口内已有样本翻转）
+// 与 BaseFactor::pearson_correlation 一致：未标记的样本视为 NaN，X、Y 任一为 NaN 的样本跳过
+// 标记随 update 写入（与新样本一一对应），被挤出样本按其当前标记移出；setFlag 为 O(1) 加入/移出
+// 注意：标记不来自缓存层，编译模式下须通过 update 驱动
+class OnlineMaskedCorrelation : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层X
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheX;
+        // 缓存层Y
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheY;
+    };
+
+    OnlineMaskedCorrelation(const Ve& initialFlags, const Window& window) {
+        constructor(initialFlags, window);
+    }
+    // 构造（标记非 0 即参与统计）
+    void constructor(const Ve& initialFlags, const Window& window);
+    // 递归更新：新样本及其标记写入，被挤出样本按当前标记移出
+    void update(const Ve& inValuesX, const Ve& inValuesY, const Ve& inFlags, size_t version) noexcept;
+    // 翻转窗口内已有样本的标记（逻辑位置 0 为最旧样本），标记不变时不做任何事
+    void setFlag(size_t logicalIndex, bool flag) noexcept;
+    // 获取窗口内样本的当前标记
+    [[nodiscard]] bool getFlag(size_t logicalIndex) const noexcept { return m_flags[physical(logicalIndex)] != 0; }
+    // 获取值
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    // 获取被标记的成对有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重算
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点（标记取自最近一次 update）
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口与标记精确计算平移后的各阶和
+    void computeSums() noexcept;
+    // 累加一个成对样本（sign 为 +1 加入、-1 移出），任一值为 NaN 时跳过
+    inline void accumulate(double x, double y, double sign) noexcept;
+    // 由各阶和计算相关系数
+    void computeCorrelation() noexcept;
+    // 标记环形缓冲的逻辑位置映射到物理位置
+    size_t physical(size_t logicalIndex) const noexcept {
+        const size_t pos = m_flagHead + logicalIndex;
+        return (pos >= m_windowSize) ? pos - m_windowSize : pos;
+    }
+
+    Window m_window;
+    std::vector<uint8_t> m_flags;  // 标记环形缓冲（与缓存层窗口逐位对齐）
+    Ve m_inFlags;                  // 本次 update 新样本标记的预分配缓冲
+    size_t m_flagHead = 0;         // 最旧样本标记的物理位置
+    // 平移后的各阶和（补偿前）与 Neumaier 补偿项
+    double m_sumX = 0.0, m_compensationX = 0.0;
+    double m_sumY = 0.0, m_compensationY = 0.0;
+    double m_sumXX = 0.0, m_compensationXX = 0.0;
+    double m_sumYY = 0.0, m_compensationYY = 0.0;
+    double m_sumXY = 0.0, m_compensationXY = 0.0;
+    double m_shiftX = 0.0;
+    double m_shiftY = 0.0;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_count = 0;            // 被标记的成对有效样本数
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
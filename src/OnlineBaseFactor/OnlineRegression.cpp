@@ -0,0 +1,262 @@
+#include "OnlineRegression.h"
+#include "OnlineCheckpoint.h"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace {
+// 秩一移出的分母、LDLT 主元的相对下限：低于此值视为（即将）奇异，转为精确重建
+constexpr double kSingularTolerance = 1e-12;
+}
+
+// OnlineOLS 滑动最小二乘
+void OnlineOLS::constructor(const Window& window, bool fitIntercept) {
+    // 检查必需的组件是否已实例化（框架层只负责链接，不负责创建）
+    CHECK_NULLPTR("OnlineOLS", window.m_onlineDataCacheY);
+    if(window.m_onlineDataCacheX.empty()){
+        std::cout << "OnlineOLS: 自变量缓存为空\n";
+        exit(1);
+    }
+    for(const auto& cacheX : window.m_onlineDataCacheX){
+        CHECK_NULLPTR("OnlineOLS", cacheX);
+        if(cacheX->getWindowSize() != window.m_onlineDataCacheY->getWindowSize()){
+            std::cout << "OnlineOLS: X和Y的窗口大小不一致\n";
+            exit(1);
+        }
+    }
+
+    m_window = window;
+    m_fitIntercept = fitIntercept;
+    // 在构造时确定窗口大小与系数个数（只确定一次，后续不再更新）
+    m_windowSize = m_window.m_onlineDataCacheY->getWindowSize();
+    m_numRegressors = m_window.m_onlineDataCacheX.size();
+    m_numCoefficients = m_numRegressors + (m_fitIntercept ? 1 : 0);
+
+    const Eigen::Index k = static_cast<Eigen::Index>(m_numCoefficients);
+    m_shiftX = Ve::Zero(static_cast<Eigen::Index>(m_numRegressors));
+    m_gram = Ma::Zero(k, k);
+    m_gramInverse = Ma::Zero(k, k);
+    m_xty = Ve::Zero(k);
+    m_row = Ve::Zero(k);
+    m_gainVector = Ve::Zero(k);
+    m_shiftedBeta = Ve::Zero(k);
+    m_beta = Ve::Constant(k, std::numeric_limits<double>::quiet_NaN());
+    rebuild();
+    m_version = 0;
+}
+
+void OnlineOLS::update(const Ma& inValuesX, const Ve& inValuesY, size_t version) noexcept {
+    ++m_updateCalls;
+    // 版本号检查：如果版本号相等，则已更新过，直接返回
+    if(m_version == version){
+        return;
+    }
+
+    if(inValuesX.rows() != inValuesY.size() || static_cast<size_t>(inValuesX.cols()) != m_numRegressors){
+        std::cout << "OnlineOLS::update: X和Y的维度不一致\n";
+        exit(1);
+    }
+
+    // 更新下游组件（缓存层）
+    for(size_t j = 0; j < m_numRegressors; ++j){
+        m_columnValues = inValuesX.col(static_cast<Eigen::Index>(j));
+        m_window.m_onlineDataCacheX[j]->update(m_columnValues, version);
+    }
+    m_window.m_onlineDataCacheY->update(inValuesY, version);
+    step(version);
+}
+
+void OnlineOLS::step(size_t version) noexcept {
+    m_version = version;  // 更新版本号
+    // 奇异状态下秩一更新无从进行，精确重建直至满秩
+    if(m_singular){
+        rebuild();
+        return;
+    }
+
+    // 代价选择：增量每个进、出样本约 2k^2，重算每个窗口样本 k^2 并求逆 k^3（时间窗口进、出个数可以不同）
+    const Eigen::Index inSize = m_window.m_onlineDataCacheY->getInValues().size();
+    const Eigen::Index outSize = m_window.m_onlineDataCacheY->getOutValues().size();
+    m_windowSize = m_window.m_onlineDataCacheY->getCount();
+    const double k = static_cast<double>(m_numCoefficients);
+    if(preferRecompute(static_cast<size_t>(inSize + outSize), m_windowSize, 2.0 * k * k, k * k + k * k * k / static_cast<double>(m_windowSize))){
+        rebuild();
+        ++m_recomputeCalls;
+        return;
+    }
+
+    // 先加入新样本再移出旧样本，避免窗口样本数恰为 k 时中间状态奇异
+    double y = 0.0;
+    for(Eigen::Index i = 0; i < inSize; ++i){
+        if(loadInRow(i, m_row, y)){
+            addSample(m_row, y);
+        }
+    }
+    for(Eigen::Index i = 0; i < outSize; ++i){
+        if(loadOutRow(i, m_row, y) && !removeSample(m_row, y)){
+            // 移出后（接近）奇异：秩一公式不再可靠，由窗口精确重建
+            rebuild();
+            return;
+        }
+    }
+    computeStatistics();
+}
+
+void OnlineOLS::collectInputs(std::vector<OnlineBaseFactor*>& inputs) const {
+    for(const auto& cacheX : m_window.m_onlineDataCacheX){
+        inputs.push_back(cacheX.get());
+    }
+    inputs.push_back(m_window.m_onlineDataCacheY.get());
+}
+
+void OnlineOLS::checkpointState(OnlineCheckpoint& archive) {
+    archive(m_shiftX, m_shiftY, m_gram, m_gramInverse, m_xty, m_yty, m_sumY, m_singular);
+    archive(m_shiftedBeta, m_beta, m_residualVariance, m_rSquared, m_count, m_version, m_windowSize);
+}
+
+void OnlineOLS::reanchor() noexcept {
+    const Ve incrementalBeta = m_beta;
+    rebuild();
+    for(Eigen::Index j = 0; j < m_beta.size(); ++j){
+        recordDrift(incrementalBeta[j], m_beta[j]);
+    }
+}
+
+void OnlineOLS::rebuild() noexcept {
+    // 含截距时以缓存平移量为锚；不含截距时平移会改变模型，不做平移
+    for(size_t j = 0; j < m_numRegressors; ++j){
+        m_shiftX[static_cast<Eigen::Index>(j)] = m_fitIntercept ? m_window.m_onlineDataCacheX[j]->getShift() : 0.0;
+    }
+    m_shiftY = m_fitIntercept ? m_window.m_onlineDataCacheY->getShift() : 0.0;
+
+    m_gram.setZero();
+    m_xty.setZero();
+    m_yty = 0.0;
+    m_sumY = 0.0;
+    m_count = 0;
+    const auto& samplesY = m_window.m_onlineDataCacheY->getValues();
+    for(int i = 0; i < samplesY.size(); ++i){
+        bool valid = !std::isnan(samplesY[i]);
+        for(size_t j = 0; j < m_numRegressors && valid; ++j){
+            const double x = m_window.m_onlineDataCacheX[j]->getValues()[i];
+            valid = !std::isnan(x);
+            m_row[static_cast<Eigen::Index>(j)] = x - m_shiftX[static_cast<Eigen::Index>(j)];
+        }
+        if(!valid){
+            continue;
+        }
+        if(m_fitIntercept){
+            m_row[static_cast<Eigen::Index>(m_numRegressors)] = 1.0;
+        }
+        const double y = samplesY[i] - m_shiftY;
+        m_gram.selfadjointView<Eigen::Lower>().rankUpdate(m_row, 1.0);
+        m_xty += m_row * y;
+        m_yty += y * y;
+        m_sumY += y;
+        ++m_count;
+    }
+
+    // 有效样本数不超过系数个数，或 LDLT 主元相对过小，均视为奇异
+    m_singular = (m_count <= m_numCoefficients);
+    if(!m_singular){
+        const Eigen::LDLT<Ma, Eigen::Lower> ldlt(m_gram);
+        const Ve pivots = ldlt.vectorD();
+        m_singular = (ldlt.info() != Eigen::Success)
+            || (pivots.minCoeff() <= kSingularTolerance * pivots.cwiseAbs().maxCoeff());
+        if(!m_singular){
+            m_gramInverse = ldlt.solve(Ma::Identity(m_gram.rows(), m_gram.cols()));
+        }
+    }
+    computeStatistics();
+}
+
+bool OnlineOLS::loadInRow(Eigen::Index i, Ve& row, double& y) const noexcept {
+    y = m_window.m_onlineDataCacheY->getInValues()[i] - m_shiftY;
+    if(std::isnan(y)){
+        return false;
+    }
+    for(size_t j = 0; j < m_numRegressors; ++j){
+        const Eigen::Index col = static_cast<Eigen::Index>(j);
+        row[col] = m_window.m_onlineDataCacheX[j]->getInValues()[i] - m_shiftX[col];
+        if(std::isnan(row[col])){
+            return false;
+        }
+    }
+    if(m_fitIntercept){
+        row[static_cast<Eigen::Index>(m_numRegressors)] = 1.0;
+    }
+    return true;
+}
+
+bool OnlineOLS::loadOutRow(Eigen::Index i, Ve& row, double& y) const noexcept {
+    y = m_window.m_onlineDataCacheY->getOutValues()[i] - m_shiftY;
+    if(std::isnan(y)){
+        return false;
+    }
+    for(size_t j = 0; j < m_numRegressors; ++j){
+        const Eigen::Index col = static_cast<Eigen::Index>(j);
+        row[col] = m_window.m_onlineDataCacheX[j]->getOutValues()[i] - m_shiftX[col];
+        if(std::isnan(row[col])){
+            return false;
+        }
+    }
+    if(m_fitIntercept){
+        row[static_cast<Eigen::Index>(m_numRegressors)] = 1.0;
+    }
+    return true;
+}
+
+void OnlineOLS::addSample(const Ve& row, double y) noexcept {
+    // Sherman-Morrison：(A + a a')^-1 = A^-1 - (A^-1 a)(A^-1 a)' / (1 + a' A^-1 a)
+    m_gainVector.noalias() = m_gramInverse.selfadjointView<Eigen::Lower>() * row;
+    const double denominator = 1.0 + row.dot(m_gainVector);
+    m_gramInverse.selfadjointView<Eigen::Lower>().rankUpdate(m_gainVector, -1.0 / denominator);
+    m_gram.selfadjointView<Eigen::Lower>().rankUpdate(row, 1.0);
+    m_xty += row * y;
+    m_yty += y * y;
+    m_sumY += y;
+    ++m_count;
+}
+
+bool OnlineOLS::removeSample(const Ve& row, double y) noexcept {
+    // Sherman-Morrison：(A - a a')^-1 = A^-1 + (A^-1 a)(A^-1 a)' / (1 - a' A^-1 a)，分母即该样本的 1 - 杠杆值
+    m_gainVector.noalias() = m_gramInverse.selfadjointView<Eigen::Lower>() * row;
+    const double denominator = 1.0 - row.dot(m_gainVector);
+    if(denominator <= kSingularTolerance){
+        return false;
+    }
+    m_gramInverse.selfadjointView<Eigen::Lower>().rankUpdate(m_gainVector, 1.0 / denominator);
+    m_gram.selfadjointView<Eigen::Lower>().rankUpdate(row, -1.0);
+    m_xty -= row * y;
+    m_yty -= y * y;
+    m_sumY -= y;
+    --m_count;
+    return true;
+}
+
+void OnlineOLS::computeStatistics() noexcept {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if(m_singular){
+        m_beta.setConstant(nan);
+        m_residualVariance = nan;
+        m_rSquared = nan;
+        return;
+    }
+
+    m_shiftedBeta.noalias() = m_gramInverse.selfadjointView<Eigen::Lower>() * m_xty;
+    // 斜率不受平移影响；截距还原：b0 = b0' + 平移量Y - sum(斜率 * 平移量X)
+    const Eigen::Index p = static_cast<Eigen::Index>(m_numRegressors);
+    m_beta.head(p) = m_shiftedBeta.head(p);
+    if(m_fitIntercept){
+        m_beta[p] = m_shiftedBeta[p] + m_shiftY - m_shiftedBeta.head(p).dot(m_shiftX);
+    }
+
+    // 残差平方和 SSE = y'y - beta' X'y（平移后计算，含截距时与平移无关）
+    const double count = static_cast<double>(m_count);
+    const double residualSum = std::max(0.0, m_yty - m_shiftedBeta.dot(m_xty));
+    const double totalSum = m_yty - m_sumY * m_sumY / count;
+    m_residualVariance = residualSum / (count - static_cast<double>(m_numCoefficients));
+    m_rSquared = (totalSum > 0.0) ? 1.0 - residualSum / totalSum : nan;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "OnlineDataCache.h"
+#include <memory>
+#include <limits>
+#include <vector>
+
+// 方法层（回归）：滑动窗口多元最小二乘，窗口进出样本时做秩一更新，每步 O(k^2)（k 为系数个数）
+
+// 在线滑动 OLS 类
+// 维护 (X'X)^-1 与 X'y：新样本以 Sherman-Morrison 秩一加入，旧样本秩一移出，系数 beta = (X'X)^-1 X'y
+// 系数顺序与 BaseFactor::ols_solve 一致：各自变量系数在前，截距（fitIntercept 时）在最后
+// 含截距时以缓存平移量为锚（x - 平移量X、y - 平移量Y），改善条件数，斜率不变、截距还原
+// 含 NaN 的样本不参与回归；有效样本数不超过系数个数或矩阵奇异时系数为 NaN，并在之后每步精确重建直至满秩
+class OnlineOLS : public OnlineBaseFactor {
+    public:
+    struct Window{
+        // 缓存层X（每个自变量一个缓存）
+        std::vector<std::shared_ptr<OnlineDataCache>> m_onlineDataCacheX;
+        // 缓存层Y
+        std::shared_ptr<OnlineDataCache> m_onlineDataCacheY;
+    };
+
+    OnlineOLS(const Window& window, bool fitIntercept = true) {
+        constructor(window, fitIntercept);
+    }
+    // 构造
+    void constructor(const Window& window, bool fitIntercept);
+    // 递归更新：inValuesX 每行一个新样本、每列一个自变量
+    void update(const Ma& inValuesX, const Ve& inValuesY, size_t version) noexcept;
+    // 获取回归系数（奇异时为 NaN）
+    [[nodiscard]] const Ve& getBeta() const noexcept { return m_beta; }
+    // 获取残差方差 SSE / (n - k)
+    [[nodiscard]] double getResidualVariance() const noexcept { return m_residualVariance; }
+    // 获取拟合优度 R^2 = 1 - SSE / SST（SST 为 y 的离差平方和）
+    [[nodiscard]] double getRSquared() const noexcept { return m_rSquared; }
+    // 获取有效样本数
+    [[nodiscard]] size_t getCount() const noexcept { return m_count; }
+    // 获取窗口大小
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    // 编译模式：收集输入节点
+    void collectInputs(std::vector<OnlineBaseFactor*>& inputs) const override;
+    // 重锚：按缓存层新的平移量由窗口精确重建，消除秩一更新/移出累积的误差
+    void reanchor() noexcept override;
+
+    private:
+    // 单步计算：输入节点已更新，只计算本节点
+    void step(size_t version) noexcept override;
+    // 检查点：保存/恢复状态成员
+    void checkpointState(OnlineCheckpoint& archive) override;
+    // 由窗口精确重建 X'X、X'y 及其逆（O(n*k^2 + k^3)）
+    void rebuild() noexcept;
+    // 读取缓存第 i 个新值/被挤出值组成的回归行（平移后，含截距列）；含 NaN 时返回 false
+    bool loadInRow(Eigen::Index i, Ve& row, double& y) const noexcept;
+    bool loadOutRow(Eigen::Index i, Ve& row, double& y) const noexcept;
+    // 秩一加入/移出一个样本；移出时分母接近 0（移出后奇异）返回 false
+    void addSample(const Ve& row, double y) noexcept;
+    bool removeSample(const Ve& row, double y) noexcept;
+    // 由 (X'X)^-1 与 X'y 计算系数、残差方差与 R^2
+    void computeStatistics() noexcept;
+
+    Window m_window;
+    bool m_fitIntercept = true;
+    size_t m_numRegressors = 0;   // 自变量个数 p
+    size_t m_numCoefficients = 0; // 系数个数 k = p + 截距
+    Ve m_shiftX;                  // 各自变量平移量（不含截距时为 0）
+    double m_shiftY = 0.0;
+    Ma m_gram;                    // X'X（平移后）
+    Ma m_gramInverse;             // (X'X)^-1（满秩时有效）
+    Ve m_xty;                     // X'y（平移后）
+    double m_yty = 0.0;           // y'y（平移后）
+    double m_sumY = 0.0;          // sum(y)（平移后）
+    bool m_singular = true;       // 当前 X'X 是否奇异（奇异时每步精确重建）
+    // 预分配缓冲：输入列、回归行与 (X'X)^-1 * 行
+    Ve m_columnValues;
+    Ve m_row;
+    Ve m_gainVector;
+    Ve m_shiftedBeta;
+    Ve m_beta;
+    double m_residualVariance = std::numeric_limits<double>::quiet_NaN();
+    double m_rSquared = std::numeric_limits<double>::quiet_NaN();
+    size_t m_count = 0;           // 有效样本数
+    size_t m_version = 0;
+    size_t m_windowSize = 0;
+};
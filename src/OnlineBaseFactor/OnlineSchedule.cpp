@@ -0,0 +1,136 @@
+#include "OnlineSchedule.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+// OnlineSchedule 节点图编译
+void OnlineSchedule::addRoot(const std::shared_ptr<OnlineBaseFactor>& root, size_t group) {
+    m_roots.push_back(root);
+    m_rootGroups.push_back(group);
+}
+
+void OnlineSchedule::compile() {
+    m_nodes.clear();
+    m_leaves.clear();
+    std::unordered_set<OnlineBaseFactor*> visited;
+    for (const auto& root : m_roots) {
+        visit(root.get(), visited);
+    }
+
+    // 分组归属：只被一个分组的根节点到达的节点归该组，否则为共享
+    constexpr size_t SHARED_GROUP = std::numeric_limits<size_t>::max();
+    std::unordered_map<OnlineBaseFactor*, size_t> owner;
+    std::vector<OnlineBaseFactor*> stack;
+    std::vector<OnlineBaseFactor*> inputs;
+    for (size_t r = 0; r < m_roots.size(); ++r) {
+        const size_t group = m_rootGroups[r];
+        std::unordered_set<OnlineBaseFactor*> reached;
+        stack.assign(1, m_roots[r].get());
+        while (!stack.empty()) {
+            OnlineBaseFactor* node = stack.back();
+            stack.pop_back();
+            if (!reached.insert(node).second) {
+                continue;
+            }
+            auto it = owner.find(node);
+            if (it == owner.end()) {
+                owner.emplace(node, group);
+            } else if (it->second != group) {
+                it->second = SHARED_GROUP;
+            }
+            inputs.clear();
+            node->collectInputs(inputs);
+            stack.insert(stack.end(), inputs.begin(), inputs.end());
+        }
+    }
+
+    const size_t groupsNum = m_rootGroups.empty() ? 0 : *std::max_element(m_rootGroups.begin(), m_rootGroups.end()) + 1;
+    m_sharedNodes.clear();
+    m_groupNodes.assign(groupsNum, {});
+    for (auto* node : m_nodes) {
+        const size_t group = owner[node];
+        if (group == SHARED_GROUP) {
+            m_sharedNodes.push_back(node);
+        } else {
+            m_groupNodes[group].push_back(node);
+        }
+    }
+}
+
+void OnlineSchedule::visit(OnlineBaseFactor* node, std::unordered_set<OnlineBaseFactor*>& visited) {
+    if (node == nullptr || !visited.insert(node).second) {
+        return;
+    }
+    // 先访问所有输入节点（后序），保证输入节点排在本节点之前
+    std::vector<OnlineBaseFactor*> inputs;
+    node->collectInputs(inputs);
+    for (auto* input : inputs) {
+        visit(input, visited);
+    }
+    if (inputs.empty()) {
+        m_leaves.push_back(node);
+    } else {
+        m_nodes.push_back(node);
+    }
+}
+
+void OnlineSchedule::run(size_t version) noexcept {
+    for (auto* node : m_nodes) {
+        node->compiledStep(version);
+    }
+}
+
+void OnlineSchedule::runShared(size_t version) noexcept {
+    for (auto* node : m_sharedNodes) {
+        node->compiledStep(version);
+    }
+}
+
+void OnlineSchedule::runGroup(size_t group, size_t version) noexcept {
+    for (auto* node : m_groupNodes[group]) {
+        node->compiledStep(version);
+    }
+}
+
+void OnlineSchedule::reanchor() noexcept {
+    for (auto* leaf : m_leaves) {
+        leaf->reanchor();
+    }
+    for (auto* node : m_nodes) {
+        node->reanchor();
+    }
+}
+
+void OnlineSchedule::checkpoint(OnlineCheckpoint& archive) {
+    uint64_t nodeCount = getNodeCount();
+    archive(nodeCount);
+    if (nodeCount != getNodeCount()) {
+        std::cout << "OnlineSchedule: 节点数与快照不一致\n";
+        exit(1);
+    }
+    for (auto* leaf : m_leaves) {
+        leaf->checkpoint(archive);
+    }
+    for (auto* node : m_nodes) {
+        node->checkpoint(archive);
+    }
+}
+
+size_t OnlineSchedule::getTotalUpdateCalls() const noexcept {
+    size_t totalCalls = 0;
+    for (const auto* leaf : m_leaves) {
+        totalCalls += leaf->getUpdateCalls();
+    }
+    for (const auto* node : m_nodes) {
+        totalCalls += node->getUpdateCalls();
+    }
+    return totalCalls;
+}
+
+double OnlineSchedule::getMaxDrift() const noexcept {
+    double maxDrift = 0.0;
+    for (const auto* node : m_nodes) {
+        maxDrift = std::max(maxDrift, node->getMaxDrift());
+    }
+    return maxDrift;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "OnlineBaseFactor.h"
+#include "OnlineCheckpoint.h"
+#include <memory>
+#include <vector>
+#include <unordered_set>
+
+// 在线节点图编译器：对已链接的节点图做一次拓扑排序，得到扁平的执行序列
+// 编译后每个版本号每个节点只执行一次 step，不再经过递归 update 和重复的版本号检查
+// 使用方式：addRoot 添加根节点 -> compile -> 每个版本先由调用方更新叶子节点（缓存层），再 run
+// 分组执行：根节点可指定分组（如股票下标），编译时把只被一个分组用到的计算节点划入该组，
+// 被多个分组共用的节点划入共享序列；先 runShared，各分组之间再互不依赖（可并行执行 runGroup）
+class OnlineSchedule {
+    public:
+    // 添加根节点（通常为因子最终使用的节点），group 为所属分组
+    void addRoot(const std::shared_ptr<OnlineBaseFactor>& root, size_t group = 0);
+    // 拓扑排序（后序深度优先），叶子节点（无输入，即缓存层）与计算节点分开存放，并按分组划分计算节点
+    void compile();
+    // 按拓扑序执行所有计算节点（叶子节点须已由调用方更新）
+    void run(size_t version) noexcept;
+    // 执行共享计算节点
+    void runShared(size_t version) noexcept;
+    // 执行某一分组独占的计算节点（须先 runShared）
+    void runGroup(size_t group, size_t version) noexcept;
+    // 重锚：先叶子节点（缓存层更新平移量），再按拓扑序由缓存窗口精确重算所有计算节点
+    void reanchor() noexcept;
+    // 检查点：按编译顺序（先叶子节点，再拓扑序的计算节点）保存/恢复图中所有节点的状态
+    // 恢复时图须由相同配置重建并编译，节点顺序与保存时一致
+    void checkpoint(OnlineCheckpoint& archive);
+
+    // 计算节点（拓扑序）
+    [[nodiscard]] const std::vector<OnlineBaseFactor*>& getNodes() const noexcept { return m_nodes; }
+    // 叶子节点（缓存层）
+    [[nodiscard]] const std::vector<OnlineBaseFactor*>& getLeaves() const noexcept { return m_leaves; }
+    // 共享计算节点（拓扑序）
+    [[nodiscard]] const std::vector<OnlineBaseFactor*>& getSharedNodes() const noexcept { return m_sharedNodes; }
+    // 分组数
+    [[nodiscard]] size_t getGroupCount() const noexcept { return m_groupNodes.size(); }
+    // 图中节点总数（叶子 + 计算节点）
+    [[nodiscard]] size_t getNodeCount() const noexcept { return m_leaves.size() + m_nodes.size(); }
+    // 图中所有节点的 update/step 调用次数之和
+    [[nodiscard]] size_t getTotalUpdateCalls() const noexcept;
+    // 图中所有节点历次重锚观测到的最大漂移
+    [[nodiscard]] double getMaxDrift() const noexcept;
+
+    private:
+    void visit(OnlineBaseFactor* node, std::unordered_set<OnlineBaseFactor*>& visited);
+
+    std::vector<std::shared_ptr<OnlineBaseFactor>> m_roots;
+    std::vector<size_t> m_rootGroups;
+    std::vector<OnlineBaseFactor*> m_nodes;
+    std::vector<OnlineBaseFactor*> m_leaves;
+    std::vector<OnlineBaseFactor*> m_sharedNodes;
+    std::vector<std::vector<OnlineBaseFactor*>> m_groupNodes;
+};
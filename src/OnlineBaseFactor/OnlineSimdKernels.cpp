@@ -0,0 +1,301 @@
+#include "OnlineSimdKernels.h"
+#include <atomic>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ONLINE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace OnlineSimd {
+namespace {
+
+// 累加路数：AVX-512 一个 8 宽累加器，AVX2 两个 4 宽累加器，标量 8 个累加器
+constexpr size_t LANES = 8;
+
+// 固定的两两归约顺序（各实现共用）
+inline double reduceLanes(const double (&lanes)[LANES]) noexcept {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+// 标量实现：项 i 累加到第 i % 8 路；向量实现用它处理不足 8 项的尾部
+// 单项：p = w * x1 * ... * x(N-1)，lane = fma(p, xN, lane)；任一输入为 NaN 时各输入置 0
+template <size_t N>
+inline double scalarTerm(const double* weights, const double* const (&data)[N], size_t i, double lane) noexcept {
+    double operands[N];
+    bool valid = true;
+    for (size_t k = 0; k < N; ++k) {
+        operands[k] = data[k][i];
+        valid &= !std::isnan(operands[k]);
+    }
+    double product = weights[i];
+    for (size_t k = 0; k + 1 < N; ++k) {
+        product *= valid ? operands[k] : 0.0;
+    }
+    return std::fma(product, valid ? operands[N - 1] : 0.0, lane);
+}
+
+template <size_t N>
+inline void scalarAccumulate(const double* weights, const double* const (&data)[N], size_t begin, size_t count,
+                             double (&lanes)[LANES]) noexcept {
+    for (size_t i = begin; i < count; ++i) {
+        lanes[i % LANES] = scalarTerm<N>(weights, data, i, lanes[i % LANES]);
+    }
+}
+
+template <size_t N>
+double scalarSum(const double* weights, const double* const (&data)[N], size_t count) noexcept {
+    double lanes[LANES] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    // 整 8 项一组展开（各路互不依赖，编译器可自动向量化），尾部逐项
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            lanes[lane] = scalarTerm<N>(weights, data, i + lane, lanes[lane]);
+        }
+    }
+    scalarAccumulate<N>(weights, data, i, count, lanes);
+    return reduceLanes(lanes);
+}
+
+// 各阶幂和：lanes[k][路] 累加 w * x^(k+1)，逐阶乘积与 weightedSum 的 p = w * x * ... * x 相同
+constexpr size_t POWERS = 4;
+
+inline void scalarPowerTerm(double weight, double x, size_t lane, double (&lanes)[POWERS][LANES]) noexcept {
+    const double value = std::isnan(x) ? 0.0 : x;
+    double product = weight;
+    for (size_t k = 0; k < POWERS; ++k) {
+        lanes[k][lane] = std::fma(product, value, lanes[k][lane]);
+        product *= value;
+    }
+}
+
+inline void scalarPowerAccumulate(const double* weights, const double* x, size_t begin, size_t count,
+                                  double (&lanes)[POWERS][LANES]) noexcept {
+    for (size_t i = begin; i < count; ++i) {
+        scalarPowerTerm(weights[i], x[i], i % LANES, lanes);
+    }
+}
+
+inline void reducePowerLanes(const double (&lanes)[POWERS][LANES], double (&sums)[POWERS]) noexcept {
+    for (size_t k = 0; k < POWERS; ++k) {
+        sums[k] = reduceLanes(lanes[k]);
+    }
+}
+
+void scalarPowerSums(const double* weights, const double* x, size_t count, double (&sums)[POWERS]) noexcept {
+    double lanes[POWERS][LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            scalarPowerTerm(weights[i + lane], x[i + lane], lane, lanes);
+        }
+    }
+    scalarPowerAccumulate(weights, x, i, count, lanes);
+    reducePowerLanes(lanes, sums);
+}
+
+#ifdef ONLINE_SIMD_X86
+// AVX2 + FMA：4 项一组，有序比较生成掩码，按位与把 NaN 所在项的各输入置 0
+template <size_t N>
+__attribute__((target("avx2,fma"))) inline __m256d avx2Step(const double* weights, const double* const (&data)[N],
+                                                             size_t i, __m256d acc) noexcept {
+    __m256d operands[N];
+    __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (size_t k = 0; k < N; ++k) {
+        operands[k] = _mm256_loadu_pd(data[k] + i);
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(operands[k], operands[k], _CMP_ORD_Q));
+    }
+    __m256d product = _mm256_loadu_pd(weights + i);
+    for (size_t k = 0; k + 1 < N; ++k) {
+        product = _mm256_mul_pd(product, _mm256_and_pd(operands[k], mask));
+    }
+    return _mm256_fmadd_pd(product, _mm256_and_pd(operands[N - 1], mask), acc);
+}
+
+template <size_t N>
+__attribute__((target("avx2,fma"))) double avx2Sum(const double* weights, const double* const (&data)[N], size_t count) noexcept {
+    // acc0 对应第 0-3 路，acc1 对应第 4-7 路
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        acc0 = avx2Step<N>(weights, data, i, acc0);
+        acc1 = avx2Step<N>(weights, data, i + 4, acc1);
+    }
+    double lanes[LANES];
+    _mm256_storeu_pd(lanes, acc0);
+    _mm256_storeu_pd(lanes + 4, acc1);
+    scalarAccumulate<N>(weights, data, i, count, lanes);
+    return reduceLanes(lanes);
+}
+
+__attribute__((target("avx2,fma"))) void avx2PowerSums(const double* weights, const double* x, size_t count, double (&sums)[POWERS]) noexcept {
+    // acc[k][0] 对应第 0-3 路，acc[k][1] 对应第 4-7 路
+    __m256d acc[POWERS][2];
+    for (size_t k = 0; k < POWERS; ++k) {
+        acc[k][0] = _mm256_setzero_pd();
+        acc[k][1] = _mm256_setzero_pd();
+    }
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t half = 0; half < 2; ++half) {
+            const __m256d raw = _mm256_loadu_pd(x + i + 4 * half);
+            const __m256d value = _mm256_and_pd(raw, _mm256_cmp_pd(raw, raw, _CMP_ORD_Q));
+            __m256d product = _mm256_loadu_pd(weights + i + 4 * half);
+            for (size_t k = 0; k < POWERS; ++k) {
+                acc[k][half] = _mm256_fmadd_pd(product, value, acc[k][half]);
+                product = _mm256_mul_pd(product, value);
+            }
+        }
+    }
+    double lanes[POWERS][LANES];
+    for (size_t k = 0; k < POWERS; ++k) {
+        _mm256_storeu_pd(lanes[k], acc[k][0]);
+        _mm256_storeu_pd(lanes[k] + 4, acc[k][1]);
+    }
+    scalarPowerAccumulate(weights, x, i, count, lanes);
+    reducePowerLanes(lanes, sums);
+}
+
+// AVX-512：8 项一组，掩码寄存器置 0
+template <size_t N>
+__attribute__((target("avx512f"))) double avx512Sum(const double* weights, const double* const (&data)[N], size_t count) noexcept {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        __m512d operands[N];
+        __mmask8 mask = 0xFF;
+        for (size_t k = 0; k < N; ++k) {
+            operands[k] = _mm512_loadu_pd(data[k] + i);
+            mask &= _mm512_cmp_pd_mask(operands[k], operands[k], _CMP_ORD_Q);
+        }
+        __m512d product = _mm512_loadu_pd(weights + i);
+        for (size_t k = 0; k + 1 < N; ++k) {
+            product = _mm512_mul_pd(product, _mm512_maskz_mov_pd(mask, operands[k]));
+        }
+        acc = _mm512_fmadd_pd(product, _mm512_maskz_mov_pd(mask, operands[N - 1]), acc);
+    }
+    double lanes[LANES];
+    _mm512_storeu_pd(lanes, acc);
+    scalarAccumulate<N>(weights, data, i, count, lanes);
+    return reduceLanes(lanes);
+}
+
+__attribute__((target("avx512f"))) void avx512PowerSums(const double* weights, const double* x, size_t count, double (&sums)[POWERS]) noexcept {
+    __m512d acc[POWERS];
+    for (size_t k = 0; k < POWERS; ++k) {
+        acc[k] = _mm512_setzero_pd();
+    }
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const __m512d raw = _mm512_loadu_pd(x + i);
+        const __m512d value = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(raw, raw, _CMP_ORD_Q), raw);
+        __m512d product = _mm512_loadu_pd(weights + i);
+        for (size_t k = 0; k < POWERS; ++k) {
+            acc[k] = _mm512_fmadd_pd(product, value, acc[k]);
+            product = _mm512_mul_pd(product, value);
+        }
+    }
+    double lanes[POWERS][LANES];
+    for (size_t k = 0; k < POWERS; ++k) {
+        _mm512_storeu_pd(lanes[k], acc[k]);
+    }
+    scalarPowerAccumulate(weights, x, i, count, lanes);
+    reducePowerLanes(lanes, sums);
+}
+#endif
+
+Isa detectIsa() noexcept {
+#ifdef ONLINE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Isa::Avx2;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+Isa bestIsa() noexcept {
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+std::atomic<Isa>& selectedIsa() noexcept {
+    static std::atomic<Isa> isa{bestIsa()};
+    return isa;
+}
+
+template <size_t N>
+double dispatchSum(const double* weights, const double* const (&data)[N], size_t count) noexcept {
+    switch (selectedIsa().load(std::memory_order_relaxed)) {
+#ifdef ONLINE_SIMD_X86
+    case Isa::Avx512:
+        return avx512Sum<N>(weights, data, count);
+    case Isa::Avx2:
+        return avx2Sum<N>(weights, data, count);
+#endif
+    default:
+        return scalarSum<N>(weights, data, count);
+    }
+}
+
+}
+
+Isa activeIsa() noexcept {
+    return selectedIsa().load(std::memory_order_relaxed);
+}
+
+bool isSupported(Isa isa) noexcept {
+    return static_cast<int>(isa) <= static_cast<int>(bestIsa());
+}
+
+void setIsa(Isa isa) noexcept {
+    selectedIsa().store(isSupported(isa) ? isa : Isa::Scalar, std::memory_order_relaxed);
+}
+
+const char* isaName(Isa isa) noexcept {
+    switch (isa) {
+    case Isa::Avx512:
+        return "avx512";
+    case Isa::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+double weightedSum(const double* weights, const double* x, size_t count) noexcept {
+    const double* const data[1] = {x};
+    return dispatchSum<1>(weights, data, count);
+}
+
+double weightedSum(const double* weights, const double* x, const double* y, size_t count) noexcept {
+    const double* const data[2] = {x, y};
+    return dispatchSum<2>(weights, data, count);
+}
+
+double weightedSum(const double* weights, const double* x, const double* y, const double* z, size_t count) noexcept {
+    const double* const data[3] = {x, y, z};
+    return dispatchSum<3>(weights, data, count);
+}
+
+void weightedPowerSums(const double* weights, const double* x, size_t count, double (&sums)[4]) noexcept {
+    switch (selectedIsa().load(std::memory_order_relaxed)) {
+#ifdef ONLINE_SIMD_X86
+    case Isa::Avx512:
+        avx512PowerSums(weights, x, count, sums);
+        return;
+    case Isa::Avx2:
+        avx2PowerSums(weights, x, count, sums);
+        return;
+#endif
+    default:
+        scalarPowerSums(weights, x, count, sums);
+        return;
+    }
+}
+
+}
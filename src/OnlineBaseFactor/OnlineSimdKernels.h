@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+
+// 带权点积内核（EWM 移入/移出与整窗重算共用）：NaN 样本无分支屏蔽（置 0 后照常累加），乘加使用 FMA
+// 运行时按 CPU 特性选择 AVX-512 / AVX2+FMA / 标量实现：
+// 三者都按 8 路交错累加（第 i 项进第 i % 8 路）、按同一顺序两两归约，结果逐位一致
+// 非 GCC/Clang 的 x86 编译器只有标量实现
+namespace OnlineSimd {
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+// 步长不小于该值时 EWM 增量更新走向量内核（小步长保持逐项循环）
+inline constexpr size_t MIN_VECTOR_STEP = 16;
+
+// 当前选用的实现（首次调用时按 CPU 特性检测）
+[[nodiscard]] Isa activeIsa() noexcept;
+// CPU 是否支持该实现
+[[nodiscard]] bool isSupported(Isa isa) noexcept;
+// 指定实现（测试/基准用；CPU 不支持时回退标量）
+void setIsa(Isa isa) noexcept;
+[[nodiscard]] const char* isaName(Isa isa) noexcept;
+
+// sum(w * x)，x 为 NaN 的项不计
+[[nodiscard]] double weightedSum(const double* weights, const double* x, size_t count) noexcept;
+// sum(w * x * y)，x、y 任一为 NaN 的项不计
+[[nodiscard]] double weightedSum(const double* weights, const double* x, const double* y, size_t count) noexcept;
+// sum(w * x * y * z)，x、y、z 任一为 NaN 的项不计
+[[nodiscard]] double weightedSum(const double* weights, const double* x, const double* y, const double* z, size_t count) noexcept;
+// 一遍求 sums[k] = sum(w * x^(k+1))，k = 0..3，x 为 NaN 的项不计；各阶与对应的 weightedSum(w, x, ..., x) 逐位一致
+void weightedPowerSums(const double* weights, const double* x, size_t count, double (&sums)[4]) noexcept;
+
+}
@@ -0,0 +1,357 @@
+#pragma once
+#include "OnlineDataCache.h"
+#include "OnlineMethod.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// 静态组合的在线算子链（编译期组合，与动态节点图二选一）
+// 动态节点图中每个节点经 Window 中的 shared_ptr 持有输入，逐层取值都是一次间接访问，编译器无法跨节点内联
+// 静态组合中算子是 CRTP 模板，子算子按值持有，整条链（如 相关系数 ← 方差/协方差 ← 均值/乘积和 ← 缓存）
+// 在编译期展开为一个更新例程；增量公式、代价选择与组合公式均与动态节点相同，数值逐位一致
+// 缓存层由链统一持有，算子以输入序号 StaticInput<I> 引用，同一序列的各算子共用一份缓存
+// 被多个父算子使用的中间算子（如均值）按值各持一份、各自累加（每步只是步长个标量运算，换取无间接访问）
+
+// 静态链的输入：第 I 个序列的缓存
+template<size_t I>
+struct StaticInput {
+    template<typename Caches>
+    [[nodiscard]] static const OnlineDataCache& cache(const Caches& caches) noexcept { return caches[I]; }
+};
+
+// 静态算子基类（CRTP）：先子算子后本算子，按值递归展开
+// 派生类提供 stepSelf / rebuildSelf，有子算子时提供 forEachChild
+template<typename Derived>
+class OnlineStaticOp {
+    public:
+    // 单步：缓存已写入本次新值
+    template<typename Caches>
+    void step(const Caches& caches) noexcept {
+        derived().forEachChild([&](auto& child) { child.step(caches); });
+        derived().stepSelf(caches);
+    }
+    // 由缓存窗口精确重建（构造与重锚）
+    template<typename Caches>
+    void rebuild(const Caches& caches) noexcept {
+        derived().forEachChild([&](auto& child) { child.rebuild(caches); });
+        derived().rebuildSelf(caches);
+    }
+
+    protected:
+    // 直接读取缓存的算子没有子算子
+    template<typename Visit>
+    void forEachChild(Visit&&) noexcept {}
+    // 代价选择：与动态节点相同（增量、重算每个样本代价均为 1，步长不小于窗口时重算）
+    [[nodiscard]] static bool preferRecompute(size_t stepSize, size_t windowSize) noexcept { return stepSize >= windowSize; }
+
+    private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+};
+
+// 求和（同 OnlineSum）
+template<typename Input>
+class StaticSum : public OnlineStaticOp<StaticSum<Input>> {
+    friend class OnlineStaticOp<StaticSum<Input>>;
+    public:
+    using InputType = Input;
+    [[nodiscard]] double getValue() const noexcept { return getShiftedValue() + static_cast<double>(m_windowSize) * m_shift; }
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    [[nodiscard]] double getShift() const noexcept { return m_shift; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    private:
+    template<typename Caches>
+    void stepSelf(const Caches& caches) noexcept {
+        const OnlineDataCache& cache = Input::cache(caches);
+        const auto outValues = cache.getOutValues();
+        const auto inValues = cache.getInValues();
+        m_windowSize = cache.getCount();
+        if(this->preferRecompute(static_cast<size_t>(inValues.size() + outValues.size()), m_windowSize)){
+            rebuildSelf(caches);
+            return;
+        }
+        const Eigen::Index count = std::max(inValues.size(), outValues.size());
+        for(Eigen::Index i = 0; i < count; ++i){
+            if(i < inValues.size()){
+                neumaierAdd(m_value, m_compensation, inValues[i] - m_shift);
+            }
+            if(i < outValues.size()){
+                neumaierAdd(m_value, m_compensation, m_shift - outValues[i]);
+            }
+        }
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept {
+        const OnlineDataCache& cache = Input::cache(caches);
+        m_windowSize = cache.getCount();
+        m_shift = cache.getShift();
+        m_value = 0.0;
+        m_compensation = 0.0;
+        for(auto sample : cache.getValues()){
+            neumaierAdd(m_value, m_compensation, sample - m_shift);
+        }
+    }
+
+    double m_value = 0.0;
+    double m_compensation = 0.0;
+    double m_shift = 0.0;
+    size_t m_windowSize = 0;
+};
+
+// 乘积和（同 OnlineSumProduct，两个输入相同时为平方和）
+template<typename InputX, typename InputY>
+class StaticSumProduct : public OnlineStaticOp<StaticSumProduct<InputX, InputY>> {
+    friend class OnlineStaticOp<StaticSumProduct<InputX, InputY>>;
+    public:
+    using InputTypeX = InputX;
+    using InputTypeY = InputY;
+    [[nodiscard]] double getValue() const noexcept {
+        return getShiftedValue() + m_shiftY * (m_sumX + m_compensationX) + m_shiftX * (m_sumY + m_compensationY)
+            + static_cast<double>(m_windowSize) * m_shiftX * m_shiftY;
+    }
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_value + m_compensation; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    private:
+    template<typename Caches>
+    void stepSelf(const Caches& caches) noexcept {
+        const OnlineDataCache& cacheX = InputX::cache(caches);
+        const OnlineDataCache& cacheY = InputY::cache(caches);
+        const auto oldValuesX = cacheX.getOutValues();
+        const auto oldValuesY = cacheY.getOutValues();
+        const auto newValuesX = cacheX.getInValues();
+        const auto newValuesY = cacheY.getInValues();
+        m_windowSize = cacheX.getCount();
+        if(this->preferRecompute(static_cast<size_t>(newValuesX.size() + oldValuesX.size()), m_windowSize)){
+            rebuildSelf(caches);
+            return;
+        }
+        const Eigen::Index count = std::max(newValuesX.size(), oldValuesX.size());
+        for(Eigen::Index i = 0; i < count; ++i){
+            if(i < newValuesX.size()){
+                const double newX = newValuesX[i] - m_shiftX;
+                const double newY = newValuesY[i] - m_shiftY;
+                neumaierAdd(m_value, m_compensation, newX * newY);
+                neumaierAdd(m_sumX, m_compensationX, newX);
+                neumaierAdd(m_sumY, m_compensationY, newY);
+            }
+            if(i < oldValuesX.size()){
+                const double oldX = oldValuesX[i] - m_shiftX;
+                const double oldY = oldValuesY[i] - m_shiftY;
+                neumaierAdd(m_value, m_compensation, -oldX * oldY);
+                neumaierAdd(m_sumX, m_compensationX, -oldX);
+                neumaierAdd(m_sumY, m_compensationY, -oldY);
+            }
+        }
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept {
+        const OnlineDataCache& cacheX = InputX::cache(caches);
+        const OnlineDataCache& cacheY = InputY::cache(caches);
+        m_windowSize = cacheX.getCount();
+        m_shiftX = cacheX.getShift();
+        m_shiftY = cacheY.getShift();
+        m_value = m_compensation = 0.0;
+        m_sumX = m_compensationX = 0.0;
+        m_sumY = m_compensationY = 0.0;
+        const auto& samplesX = cacheX.getValues();
+        const auto& samplesY = cacheY.getValues();
+        for(int i = 0; i < samplesX.size(); ++i){
+            const double sampleX = samplesX[i] - m_shiftX;
+            const double sampleY = samplesY[i] - m_shiftY;
+            neumaierAdd(m_value, m_compensation, sampleX * sampleY);
+            neumaierAdd(m_sumX, m_compensationX, sampleX);
+            neumaierAdd(m_sumY, m_compensationY, sampleY);
+        }
+    }
+
+    double m_value = 0.0;
+    double m_compensation = 0.0;
+    double m_sumX = 0.0;
+    double m_compensationX = 0.0;
+    double m_sumY = 0.0;
+    double m_compensationY = 0.0;
+    double m_shiftX = 0.0;
+    double m_shiftY = 0.0;
+    size_t m_windowSize = 0;
+};
+
+// 均值（同 OnlineMean）
+template<typename SumOp>
+class StaticMean : public OnlineStaticOp<StaticMean<SumOp>> {
+    friend class OnlineStaticOp<StaticMean<SumOp>>;
+    public:
+    using InputType = typename SumOp::InputType;
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    [[nodiscard]] double getShiftedValue() const noexcept { return m_shiftedValue; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    private:
+    template<typename Visit>
+    void forEachChild(Visit&& visit) noexcept { visit(m_sum); }
+    template<typename Caches>
+    void stepSelf(const Caches&) noexcept {
+        m_windowSize = m_sum.getWindowSize();
+        m_value = OnlineMean::computeMean(m_sum.getValue(), m_windowSize);
+        m_shiftedValue = OnlineMean::computeMean(m_sum.getShiftedValue(), m_windowSize);
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept { stepSelf(caches); }
+
+    SumOp m_sum;
+    double m_value = 0.0;
+    double m_shiftedValue = 0.0;
+    size_t m_windowSize = 0;
+};
+
+// 样本方差（同 OnlineVar）：平方和与均值须基于同一输入
+template<typename SumProductOp, typename MeanOp>
+class StaticVar : public OnlineStaticOp<StaticVar<SumProductOp, MeanOp>> {
+    friend class OnlineStaticOp<StaticVar<SumProductOp, MeanOp>>;
+    static_assert(std::is_same_v<typename SumProductOp::InputTypeX, typename MeanOp::InputType>
+                  && std::is_same_v<typename SumProductOp::InputTypeY, typename MeanOp::InputType>,
+                  "StaticVar: 平方和与均值的输入不一致");
+    public:
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    private:
+    template<typename Visit>
+    void forEachChild(Visit&& visit) noexcept {
+        visit(m_mean);
+        visit(m_sumProduct);
+    }
+    template<typename Caches>
+    void stepSelf(const Caches&) noexcept {
+        m_windowSize = m_sumProduct.getWindowSize();
+        m_value = OnlineVar::computeVariance(m_sumProduct.getShiftedValue(), m_mean.getShiftedValue(), m_windowSize);
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept { stepSelf(caches); }
+
+    SumProductOp m_sumProduct;
+    MeanOp m_mean;
+    double m_value = 0.0;
+    size_t m_windowSize = 0;
+};
+
+// 样本协方差（同 OnlineCov）：乘积和与两个均值须基于相同输入
+template<typename SumProductOp, typename MeanOpX, typename MeanOpY>
+class StaticCov : public OnlineStaticOp<StaticCov<SumProductOp, MeanOpX, MeanOpY>> {
+    friend class OnlineStaticOp<StaticCov<SumProductOp, MeanOpX, MeanOpY>>;
+    static_assert(std::is_same_v<typename SumProductOp::InputTypeX, typename MeanOpX::InputType>
+                  && std::is_same_v<typename SumProductOp::InputTypeY, typename MeanOpY::InputType>,
+                  "StaticCov: 乘积和与均值的输入不一致");
+    public:
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    private:
+    template<typename Visit>
+    void forEachChild(Visit&& visit) noexcept {
+        visit(m_meanX);
+        visit(m_meanY);
+        visit(m_sumProduct);
+    }
+    template<typename Caches>
+    void stepSelf(const Caches&) noexcept {
+        m_windowSize = m_sumProduct.getWindowSize();
+        m_value = OnlineCov::computeCovariance(m_sumProduct.getShiftedValue(), m_meanX.getShiftedValue(), m_meanY.getShiftedValue(), m_windowSize);
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept { stepSelf(caches); }
+
+    SumProductOp m_sumProduct;
+    MeanOpX m_meanX;
+    MeanOpY m_meanY;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_windowSize = 0;
+};
+
+// 相关系数（同 OnlineCorrelation）
+template<typename VarOpX, typename VarOpY, typename CovOp>
+class StaticCorrelation : public OnlineStaticOp<StaticCorrelation<VarOpX, VarOpY, CovOp>> {
+    friend class OnlineStaticOp<StaticCorrelation<VarOpX, VarOpY, CovOp>>;
+    public:
+    [[nodiscard]] double getValue() const noexcept { return m_value; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+    [[nodiscard]] const VarOpX& getVarX() const noexcept { return m_varX; }
+    [[nodiscard]] const VarOpY& getVarY() const noexcept { return m_varY; }
+    [[nodiscard]] const CovOp& getCov() const noexcept { return m_cov; }
+
+    private:
+    template<typename Visit>
+    void forEachChild(Visit&& visit) noexcept {
+        visit(m_varX);
+        visit(m_varY);
+        visit(m_cov);
+    }
+    template<typename Caches>
+    void stepSelf(const Caches&) noexcept {
+        m_windowSize = m_varX.getWindowSize();
+        m_value = OnlineCorrelation::computeCorrelation(m_cov.getValue(), m_varX.getValue(), m_varY.getValue());
+    }
+    template<typename Caches>
+    void rebuildSelf(const Caches& caches) noexcept { stepSelf(caches); }
+
+    VarOpX m_varX;
+    VarOpY m_varY;
+    CovOp m_cov;
+    double m_value = std::numeric_limits<double>::quiet_NaN();
+    size_t m_windowSize = 0;
+};
+
+// 常用组合：X、Y 两个输入的相关系数链（与 barra_cne5_1_beta 逐股票节点图同构）
+template<typename InputX, typename InputY>
+using StaticCorrelationOf = StaticCorrelation<
+    StaticVar<StaticSumProduct<InputX, InputX>, StaticMean<StaticSum<InputX>>>,
+    StaticVar<StaticSumProduct<InputY, InputY>, StaticMean<StaticSum<InputY>>>,
+    StaticCov<StaticSumProduct<InputX, InputY>, StaticMean<StaticSum<InputX>>, StaticMean<StaticSum<InputY>>>>;
+
+// 静态链：持有 NumInputs 个定长窗口缓存与根算子（整条链按值内嵌，无堆上节点）
+template<typename Root, size_t NumInputs>
+class OnlineStaticChain {
+    public:
+    explicit OnlineStaticChain(const std::array<Ve, NumInputs>& initialValues)
+        : m_caches(makeCaches(initialValues, std::make_index_sequence<NumInputs>{})) {
+        m_root.rebuild(m_caches);
+    }
+
+    // 更新：各输入序列的新值依次写入缓存，再按编译期展开的顺序更新整条链
+    template<typename... InValues>
+    void update(const InValues&... inValues) noexcept {
+        static_assert(sizeof...(InValues) == NumInputs, "OnlineStaticChain: 输入个数与链的输入数不一致");
+        ++m_version;
+        updateCaches(std::index_sequence_for<InValues...>{}, inValues...);
+        m_root.step(m_caches);
+    }
+    // 重锚：缓存取新的平移量，整条链由窗口精确重建
+    void reanchor() noexcept {
+        for(auto& cache : m_caches){
+            cache.reanchor();
+        }
+        m_root.rebuild(m_caches);
+    }
+
+    [[nodiscard]] double getValue() const noexcept { return m_root.getValue(); }
+    [[nodiscard]] const Root& getRoot() const noexcept { return m_root; }
+    [[nodiscard]] const OnlineDataCache& getCache(size_t index) const noexcept { return m_caches[index]; }
+
+    private:
+    template<size_t... Indices>
+    static std::array<OnlineDataCache, NumInputs> makeCaches(const std::array<Ve, NumInputs>& initialValues, std::index_sequence<Indices...>) {
+        return {OnlineDataCache(initialValues[Indices])...};
+    }
+    template<size_t... Indices, typename... InValues>
+    void updateCaches(std::index_sequence<Indices...>, const InValues&... inValues) noexcept {
+        (m_caches[Indices].update(inValues, m_version), ...);
+    }
+
+    std::array<OnlineDataCache, NumInputs> m_caches;
+    Root m_root;
+    size_t m_version = 0;
+};
+
+// X、Y 两个输入的静态相关系数链
+using OnlineStaticCorrelation = OnlineStaticChain<StaticCorrelationOf<StaticInput<0>, StaticInput<1>>, 2>;
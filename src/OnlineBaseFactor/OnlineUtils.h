@@ -1,6 +1,7 @@
 #pragma once
 #include <iostream>
 #include <cstdlib>
+#include <cmath>
 
 // 辅助宏：简化构造函数中的空指针检测
 #define CHECK_NULLPTR(className, memberPtr) \
@@ -9,3 +10,13 @@
         exit(1); \
     }
 
+// Neumaier 补偿求和：sum 为累计值，compensation 为累计的舍入误差，真实和为 sum + compensation
+inline void neumaierAdd(double& sum, double& compensation, double value) noexcept {
+    const double total = sum + value;
+    if (std::abs(sum) >= std::abs(value)) {
+        compensation += (sum - total) + value;
+    } else {
+        compensation += (value - total) + sum;
+    }
+    sum = total;
+}
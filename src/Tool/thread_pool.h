@@ -0,0 +1,120 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Tool {
+
+// 常驻线程池：按区间静态分块并行执行，调用线程负责第 0 块并等待全部完成
+// 分块只由区间和线程数决定，同一下标总在同一块内，结果与串行一致（各下标互不依赖时）
+class ThreadPool {
+private:
+    size_t chunks_num_ = 1;   // 总并行度（含调用线程），构造后不变
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    // 当前任务：func(chunk, chunkBegin, chunkEnd)，parallelFor 返回前一直有效
+    const std::function<void(size_t, size_t, size_t)>* task_ = nullptr;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    size_t generation_ = 0;   // 任务代数，工作线程据此判断是否有新任务
+    size_t pending_ = 0;      // 尚未完成的工作线程数
+    bool stop_ = false;
+
+public:
+    // threadsNum 为总并行度（含调用线程），0 或 1 时不创建工作线程
+    explicit ThreadPool(size_t threadsNum) : chunks_num_(threadsNum > 1 ? threadsNum : 1) {
+        for (size_t chunk = 1; chunk < chunks_num_; ++chunk) {
+            workers_.emplace_back([this, chunk]() { workerLoop(chunk); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 总并行度（分块数）
+    size_t size() const { return chunks_num_; }
+
+    // 第 chunk 块的区间 [chunkBegin, chunkEnd)
+    static void chunkRange(size_t begin, size_t end, size_t chunk, size_t chunksNum,
+                           size_t& chunkBegin, size_t& chunkEnd) {
+        const size_t count = end - begin;
+        chunkBegin = begin + count * chunk / chunksNum;
+        chunkEnd = begin + count * (chunk + 1) / chunksNum;
+    }
+
+    // 将 [begin, end) 静态分为 size() 块并行执行 func(chunk, chunkBegin, chunkEnd)，返回时全部完成
+    void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t, size_t)>& func) {
+        if (workers_.empty() || end <= begin) {
+            func(0, begin, end);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &func;
+            begin_ = begin;
+            end_ = end;
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        size_t chunkBegin = 0;
+        size_t chunkEnd = 0;
+        chunkRange(begin, end, 0, size(), chunkBegin, chunkEnd);
+        func(0, chunkBegin, chunkEnd);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void workerLoop(size_t chunk) {
+        size_t seenGeneration = 0;
+        while (true) {
+            const std::function<void(size_t, size_t, size_t)>* task = nullptr;
+            size_t chunkBegin = 0;
+            size_t chunkEnd = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [this, seenGeneration]() { return stop_ || generation_ != seenGeneration; });
+                if (stop_) {
+                    return;
+                }
+                seenGeneration = generation_;
+                task = task_;
+                chunkRange(begin_, end_, chunk, size(), chunkBegin, chunkEnd);
+            }
+            if (chunkBegin < chunkEnd) {
+                (*task)(chunk, chunkBegin, chunkEnd);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --pending_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+};
+
+} // namespace Tool
+
+#endif // THREAD_POOL_H
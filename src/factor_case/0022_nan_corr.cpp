@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineNanMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（缺失值由 NaN 跳过节点处理）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_x_csv = config.getString("0022_nan_corr", "initial_x_csv", "");
+        const std::string initial_y_csv = config.getString("0022_nan_corr", "initial_y_csv", "");
+        const std::string update_x_csv = config.getString("0022_nan_corr", "update_x_csv", "");
+        const std::string update_y_csv = config.getString("0022_nan_corr", "update_y_csv", "");
+        const std::string output_csv = config.getString("0022_nan_corr", "output_csv", "");
+        const int precision = config.getInt("0022_nan_corr", "precision", 6);
+
+        if (initial_x_csv.empty() || initial_y_csv.empty() || update_x_csv.empty() ||
+            update_y_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial_x", initial_x_csv);
+        database.loadFromCSV("initial_y", initial_y_csv);
+        database.loadFromCSV("update_x", update_x_csv);
+        database.loadFromCSV("update_y", update_y_csv);
+
+        MatrixXd initial_x = database.getMatrix("initial_x");
+        MatrixXd initial_y = database.getMatrix("initial_y");
+        MatrixXd update_x = database.getMatrix("update_x");
+        MatrixXd update_y = database.getMatrix("update_y");
+
+        if (initial_x.cols() == 0 || initial_y.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values_x = columnToVector(initial_x, 0);
+        Ve initial_values_y = columnToVector(initial_y, 0);
+
+        auto data_cache_x = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values_x);
+        auto data_cache_y = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values_y);
+
+        // 成对有效：X、Y 的平方和分别以另一序列为掩码
+        auto nan_sum_product_xx = OnlineBaseFactor::createOnlineBaseF<OnlineNanSumProduct>(
+            initial_values_x, initial_values_x, OnlineNanSumProduct::Window{data_cache_x, data_cache_x, data_cache_y});
+        auto nan_sum_product_yy = OnlineBaseFactor::createOnlineBaseF<OnlineNanSumProduct>(
+            initial_values_y, initial_values_y, OnlineNanSumProduct::Window{data_cache_y, data_cache_y, data_cache_x});
+        auto nan_sum_product_xy = OnlineBaseFactor::createOnlineBaseF<OnlineNanSumProduct>(
+            initial_values_x, initial_values_y, OnlineNanSumProduct::Window{data_cache_x, data_cache_y, nullptr});
+
+        auto nan_var_x = OnlineBaseFactor::createOnlineBaseF<OnlineNanVar>(initial_values_x, OnlineNanVar::Window{nan_sum_product_xx});
+        auto nan_var_y = OnlineBaseFactor::createOnlineBaseF<OnlineNanVar>(initial_values_y, OnlineNanVar::Window{nan_sum_product_yy});
+        auto nan_cov = OnlineBaseFactor::createOnlineBaseF<OnlineNanCov>(
+            initial_values_x, initial_values_y, OnlineNanCov::Window{nan_sum_product_xy});
+        auto nan_corr = OnlineBaseFactor::createOnlineBaseF<OnlineNanCorrelation>(
+            OnlineNanCorrelation::Window{nan_var_x, nan_var_y, nan_cov});
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,value\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0022_NAN_CORR 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_values_x.size() << endl;
+
+        const double init_value = nan_corr->getValue();
+        output_file << 0 << ",init," << std::fixed << std::setprecision(precision) << init_value << "\n";
+        cout << "初始相关系数: " << std::fixed << std::setprecision(precision) << init_value
+             << "（成对有效样本 " << nan_corr->getCount() << " 个）" << endl;
+
+        const int update_rows = std::min(update_x.rows(), update_y.rows());
+        for (int row = 0; row < update_rows; ++row) {
+            Ve update_values_x = rowToVector(update_x, row);
+            Ve update_values_y = rowToVector(update_y, row);
+            if (update_values_x.size() != update_values_y.size()) {
+                std::cerr << "错误: 更新数据长度不一致" << std::endl;
+                return 1;
+            }
+
+            const size_t version = static_cast<size_t>(row + 1);
+            nan_corr->update(update_values_x, update_values_y, version);
+            const double current_value = nan_corr->getValue();
+            output_file << (row + 1) << ",update," << std::fixed << std::setprecision(precision) << current_value << "\n";
+            cout << "更新 " << (row + 1) << " -> 相关系数: " << std::fixed << std::setprecision(precision) << current_value
+                 << "（成对有效样本 " << nan_corr->getCount() << " 个）" << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（极值节点跳过 NaN）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+// 一行即一次更新的批量新值
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+void writeValue(std::ofstream& output_file, double value, int precision) {
+    if (std::isnan(value)) {
+        output_file << ",nan";
+    } else {
+        output_file << "," << std::fixed << std::setprecision(precision) << value;
+    }
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0023_rolling_max", "initial_csv", "");
+        const std::string update_csv = config.getString("0023_rolling_max", "update_csv", "");
+        const std::string output_csv = config.getString("0023_rolling_max", "output_csv", "");
+        const int precision = config.getInt("0023_rolling_max", "precision", 6);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values);
+        auto rolling_max = OnlineBaseFactor::createOnlineBaseF<OnlineMax>(initial_values, OnlineMax::Window{data_cache});
+        auto rolling_min = OnlineBaseFactor::createOnlineBaseF<OnlineMin>(initial_values, OnlineMin::Window{data_cache});
+        auto rolling_argmax = OnlineBaseFactor::createOnlineBaseF<OnlineArgMax>(initial_values, OnlineArgMax::Window{rolling_max});
+        auto rolling_range = OnlineBaseFactor::createOnlineBaseF<OnlineRange>(initial_values, OnlineRange::Window{rolling_max, rolling_min});
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,max,min,argmax,range\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0023_ROLLING_MAX 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_values.size() << endl;
+
+        output_file << 0 << ",init";
+        writeValue(output_file, rolling_max->getValue(), precision);
+        writeValue(output_file, rolling_min->getValue(), precision);
+        writeValue(output_file, rolling_argmax->getValue(), precision);
+        writeValue(output_file, rolling_range->getValue(), precision);
+        output_file << "\n";
+        cout << "初始 最大值: " << rolling_max->getValue() << ", 最小值: " << rolling_min->getValue()
+             << ", 最大值位置: " << rolling_argmax->getValue() << ", 极差: " << rolling_range->getValue() << endl;
+
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            Ve step_values = rowToVector(update_matrix, row);
+            const size_t version = static_cast<size_t>(row + 1);
+            // 极差与最大值位置共享同一最大值节点，版本号保证每个节点只更新一次
+            rolling_range->update(step_values, version);
+            rolling_argmax->update(step_values, version);
+
+            output_file << (row + 1) << ",update";
+            writeValue(output_file, rolling_max->getValue(), precision);
+            writeValue(output_file, rolling_min->getValue(), precision);
+            writeValue(output_file, rolling_argmax->getValue(), precision);
+            writeValue(output_file, rolling_range->getValue(), precision);
+            output_file << "\n";
+            cout << "更新 " << (row + 1) << " -> 最大值: " << rolling_max->getValue() << ", 最小值: " << rolling_min->getValue()
+                 << ", 最大值位置: " << rolling_argmax->getValue() << ", 极差: " << rolling_range->getValue() << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（排名节点跳过 NaN）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+// 一行即一次更新的批量新值
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+void writeValue(std::ofstream& output_file, double value, int precision) {
+    if (std::isnan(value)) {
+        output_file << ",nan";
+    } else {
+        output_file << "," << std::fixed << std::setprecision(precision) << value;
+    }
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0024_rolling_rank", "initial_csv", "");
+        const std::string update_csv = config.getString("0024_rolling_rank", "update_csv", "");
+        const std::string output_csv = config.getString("0024_rolling_rank", "output_csv", "");
+        const int precision = config.getInt("0024_rolling_rank", "precision", 6);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values);
+        auto rolling_rank = OnlineBaseFactor::createOnlineBaseF<OnlineRank>(initial_values, OnlineRank::Window{data_cache});
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,count,rank,median,top_cutoff\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0024_ROLLING_RANK 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_values.size() << endl;
+
+        output_file << 0 << ",init," << rolling_rank->getCount();
+        writeValue(output_file, rolling_rank->getValue(), precision);
+        writeValue(output_file, rolling_rank->getQuantile(0.5), precision);
+        writeValue(output_file, rolling_rank->getTopCutoff(0.9), precision);
+        output_file << "\n";
+        cout << "初始 有效个数: " << rolling_rank->getCount() << ", 最新值排名: " << rolling_rank->getValue()
+             << ", 中位数: " << rolling_rank->getQuantile(0.5) << ", 前10%下界: " << rolling_rank->getTopCutoff(0.9) << endl;
+
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            Ve step_values = rowToVector(update_matrix, row);
+            const size_t version = static_cast<size_t>(row + 1);
+            rolling_rank->update(step_values, version);
+
+            output_file << (row + 1) << ",update," << rolling_rank->getCount();
+            writeValue(output_file, rolling_rank->getValue(), precision);
+            writeValue(output_file, rolling_rank->getQuantile(0.5), precision);
+            writeValue(output_file, rolling_rank->getTopCutoff(0.9), precision);
+            output_file << "\n";
+            cout << "更新 " << (row + 1) << " -> 有效个数: " << rolling_rank->getCount() << ", 最新值排名: " << rolling_rank->getValue()
+                 << ", 中位数: " << rolling_rank->getQuantile(0.5) << ", 前10%下界: " << rolling_rank->getTopCutoff(0.9) << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
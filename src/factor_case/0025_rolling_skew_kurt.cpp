@@ -0,0 +1,128 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 等权节点不跳过 NaN，输入须为完整序列
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+// 一行即一次更新的批量新值
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+void writeValue(std::ofstream& output_file, double value, int precision) {
+    if (std::isnan(value)) {
+        output_file << ",nan";
+    } else {
+        output_file << "," << std::fixed << std::setprecision(precision) << value;
+    }
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0025_rolling_skew_kurt", "initial_csv", "");
+        const std::string update_csv = config.getString("0025_rolling_skew_kurt", "update_csv", "");
+        const std::string output_csv = config.getString("0025_rolling_skew_kurt", "output_csv", "");
+        const int precision = config.getInt("0025_rolling_skew_kurt", "precision", 6);
+        const bool unbiased = config.getBool("0025_rolling_skew_kurt", "unbiased", true);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+
+        // 偏度、峰度共用同一组均值、平方和、三次方和节点
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values);
+        auto online_sum = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(initial_values, OnlineSum::Window{data_cache});
+        auto online_mean = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(initial_values, OnlineMean::Window{online_sum});
+        auto sum_product = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(
+            initial_values, initial_values, OnlineSumProduct::Window{data_cache, data_cache});
+        auto sum_power3 = OnlineBaseFactor::createOnlineBaseF<OnlineSumPower3>(initial_values, OnlineSumPower3::Window{data_cache});
+        auto sum_power4 = OnlineBaseFactor::createOnlineBaseF<OnlineSumPower4>(initial_values, OnlineSumPower4::Window{data_cache});
+        auto online_skew = OnlineBaseFactor::createOnlineBaseF<OnlineSkew>(
+            initial_values, OnlineSkew::Window{online_mean, sum_product, sum_power3}, unbiased);
+        auto online_kurt = OnlineBaseFactor::createOnlineBaseF<OnlineKurt>(
+            initial_values, OnlineKurt::Window{online_mean, sum_product, sum_power3, sum_power4}, unbiased);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,skew,kurt\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0025_ROLLING_SKEW_KURT 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_values.size() << "，算法类型: " << (unbiased ? "无偏" : "有偏") << endl;
+
+        output_file << 0 << ",init";
+        writeValue(output_file, online_skew->getValue(), precision);
+        writeValue(output_file, online_kurt->getValue(), precision);
+        output_file << "\n";
+        cout << "初始 偏度: " << online_skew->getValue() << ", 峰度: " << online_kurt->getValue() << endl;
+
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            Ve step_values = rowToVector(update_matrix, row);
+            const size_t version = static_cast<size_t>(row + 1);
+            // 共用的输入节点按版本号只更新一次
+            online_skew->update(step_values, version);
+            online_kurt->update(step_values, version);
+
+            output_file << (row + 1) << ",update";
+            writeValue(output_file, online_skew->getValue(), precision);
+            writeValue(output_file, online_kurt->getValue(), precision);
+            output_file << "\n";
+            cout << "更新 " << (row + 1) << " -> 偏度: " << online_skew->getValue() << ", 峰度: " << online_kurt->getValue() << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineRegression.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using EigenExtra::Ma;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（含 NaN 的样本不参与回归）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+void writeValue(std::ofstream& output_file, double value, int precision) {
+    if (std::isnan(value)) {
+        output_file << ",nan";
+    } else {
+        output_file << "," << std::fixed << std::setprecision(precision) << value;
+    }
+}
+
+void writeResult(std::ofstream& output_file, const OnlineOLS& ols, int precision) {
+    const Ve& beta = ols.getBeta();
+    for (int i = 0; i < beta.size(); ++i) {
+        writeValue(output_file, beta[i], precision);
+    }
+    writeValue(output_file, ols.getResidualVariance(), precision);
+    writeValue(output_file, ols.getRSquared(), precision);
+    output_file << "," << ols.getCount() << "\n";
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_x_csv = config.getString("0026_rolling_ols", "initial_x_csv", "");
+        const std::string initial_y_csv = config.getString("0026_rolling_ols", "initial_y_csv", "");
+        const std::string update_x_csv = config.getString("0026_rolling_ols", "update_x_csv", "");
+        const std::string update_y_csv = config.getString("0026_rolling_ols", "update_y_csv", "");
+        const std::string output_csv = config.getString("0026_rolling_ols", "output_csv", "");
+        const int precision = config.getInt("0026_rolling_ols", "precision", 6);
+
+        if (initial_x_csv.empty() || initial_y_csv.empty() || update_x_csv.empty() ||
+            update_y_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial_x", initial_x_csv);
+        database.loadFromCSV("initial_y", initial_y_csv);
+        database.loadFromCSV("update_x", update_x_csv);
+        database.loadFromCSV("update_y", update_y_csv);
+
+        // X 每行一个样本、每列一个自变量；更新数据每行即一次更新的一个新样本
+        MatrixXd initial_x = database.getMatrix("initial_x");
+        MatrixXd initial_y = database.getMatrix("initial_y");
+        MatrixXd update_x = database.getMatrix("update_x");
+        MatrixXd update_y = database.getMatrix("update_y");
+
+        if (initial_x.cols() == 0 || initial_y.cols() == 0 || initial_x.rows() != initial_y.rows()) {
+            std::cerr << "错误: 初始数据为空或长度不一致" << std::endl;
+            return 1;
+        }
+
+        OnlineOLS::Window window;
+        for (int col = 0; col < initial_x.cols(); ++col) {
+            window.m_onlineDataCacheX.push_back(
+                OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(columnToVector(initial_x, col)));
+        }
+        window.m_onlineDataCacheY = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(columnToVector(initial_y, 0));
+        auto rolling_ols = OnlineBaseFactor::createOnlineBaseF<OnlineOLS>(window, true);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation";
+        for (int col = 0; col < initial_x.cols(); ++col) {
+            output_file << ",beta_" << col;
+        }
+        output_file << ",intercept,resid_var,r2,count\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0026_ROLLING_OLS 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_x.rows() << ", 自变量个数: " << initial_x.cols() << endl;
+
+        output_file << 0 << ",init";
+        writeResult(output_file, *rolling_ols, precision);
+        cout << "初始 R2: " << rolling_ols->getRSquared() << "（有效样本 " << rolling_ols->getCount() << " 个）" << endl;
+
+        const int update_rows = std::min(update_x.rows(), update_y.rows());
+        Ma step_x(1, initial_x.cols());
+        Ve step_y(1);
+        for (int row = 0; row < update_rows; ++row) {
+            step_x = update_x.row(row);
+            step_y[0] = update_y(row, 0);
+            const size_t version = static_cast<size_t>(row + 1);
+            rolling_ols->update(step_x, step_y, version);
+
+            output_file << (row + 1) << ",update";
+            writeResult(output_file, *rolling_ols, precision);
+            cout << "更新 " << (row + 1) << " -> R2: " << rolling_ols->getRSquared()
+                 << ", 残差方差: " << rolling_ols->getResidualVariance()
+                 << "（有效样本 " << rolling_ols->getCount() << " 个）" << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineMethod.h"
+#include "../OnlineBaseFactor/OnlineEWMMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+void writeValue(std::ofstream& output_file, double value, int precision) {
+    if (std::isnan(value)) {
+        output_file << ",nan";
+    } else {
+        output_file << "," << std::fixed << std::setprecision(precision) << value;
+    }
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0027_time_window", "initial_csv", "");
+        const std::string update_csv = config.getString("0027_time_window", "update_csv", "");
+        const std::string output_csv = config.getString("0027_time_window", "output_csv", "");
+        const int precision = config.getInt("0027_time_window", "precision", 6);
+        const double duration = config.getDouble("0027_time_window", "duration", 30.0);
+        const double halflife = config.getDouble("0027_time_window", "halflife", 10.0);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        // 每行一个样本：时间戳, 值（时间戳单调不减，间隔不规则）
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() < 2 || update_matrix.cols() < 2) {
+            std::cerr << "错误: 数据须包含时间戳与值两列" << std::endl;
+            return 1;
+        }
+
+        Ve initial_times = columnToVector(initial_matrix, 0);
+        Ve initial_values = columnToVector(initial_matrix, 1);
+
+        // 时间窗口缓存：均值、方差沿用定长窗口的节点，每步进出个数可变
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values, initial_times, duration);
+        auto online_sum = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(initial_values, OnlineSum::Window{data_cache});
+        auto online_mean = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(initial_values, OnlineMean::Window{online_sum});
+        auto sum_product = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(
+            initial_values, initial_values, OnlineSumProduct::Window{data_cache, data_cache});
+        auto online_var = OnlineBaseFactor::createOnlineBaseF<OnlineVar>(initial_values, OnlineVar::Window{sum_product, online_mean});
+        auto time_ewm = OnlineBaseFactor::createOnlineBaseF<OnlineTimeEWM>(OnlineTimeEWM::Window{data_cache}, halflife);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,count,sum,mean,var,ewm_mean,ewm_var\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0027_TIME_WINDOW 测试 ===" << endl;
+        cout << "窗口时长: " << duration << ", 半衰期: " << halflife << ", 初始样本数: " << data_cache->getCount() << endl;
+
+        auto writeRow = [&](int step, const char* operation) {
+            output_file << step << "," << operation << "," << data_cache->getCount();
+            writeValue(output_file, online_sum->getValue(), precision);
+            writeValue(output_file, online_mean->getValue(), precision);
+            writeValue(output_file, online_var->getValue(), precision);
+            writeValue(output_file, time_ewm->getValue(), precision);
+            writeValue(output_file, time_ewm->getVar(), precision);
+            output_file << "\n";
+        };
+
+        writeRow(0, "init");
+        Ve step_times(1);
+        Ve step_values(1);
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            step_times[0] = update_matrix(row, 0);
+            step_values[0] = update_matrix(row, 1);
+            const size_t version = static_cast<size_t>(row + 1);
+            // 时间窗口缓存先写入时间戳，方法层的 update 随后命中同一版本号
+            data_cache->update(step_values, step_times, version);
+            online_var->update(step_values, version);
+            time_ewm->update(step_values, version);
+
+            writeRow(row + 1, "update");
+            cout << "更新 " << (row + 1) << " -> 样本数: " << data_cache->getCount() << "（淘汰 " << data_cache->getOutValues().size()
+                 << " 个）, 均值: " << online_mean->getValue() << ", 时间衰减均值: " << time_ewm->getValue() << endl;
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
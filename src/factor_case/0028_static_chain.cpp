@@ -0,0 +1,196 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineMethod.h"
+#include "../OnlineBaseFactor/OnlineStaticChain.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+// 动态节点图：与 barra_cne5_1_beta 逐股票节点图同构的相关系数链
+std::shared_ptr<OnlineCorrelation> buildDynamicCorrelation(const Ve& initialX, const Ve& initialY) {
+    auto cacheX = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initialX);
+    auto cacheY = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initialY);
+    auto sumX = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(initialX, OnlineSum::Window{cacheX});
+    auto sumY = OnlineBaseFactor::createOnlineBaseF<OnlineSum>(initialY, OnlineSum::Window{cacheY});
+    auto prodXX = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(initialX, initialX, OnlineSumProduct::Window{cacheX, cacheX});
+    auto prodYY = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(initialY, initialY, OnlineSumProduct::Window{cacheY, cacheY});
+    auto prodXY = OnlineBaseFactor::createOnlineBaseF<OnlineSumProduct>(initialX, initialY, OnlineSumProduct::Window{cacheX, cacheY});
+    auto meanX = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(initialX, OnlineMean::Window{sumX});
+    auto meanY = OnlineBaseFactor::createOnlineBaseF<OnlineMean>(initialY, OnlineMean::Window{sumY});
+    auto varX = OnlineBaseFactor::createOnlineBaseF<OnlineVar>(initialX, OnlineVar::Window{prodXX, meanX});
+    auto varY = OnlineBaseFactor::createOnlineBaseF<OnlineVar>(initialY, OnlineVar::Window{prodYY, meanY});
+    auto covXY = OnlineBaseFactor::createOnlineBaseF<OnlineCov>(initialX, initialY, OnlineCov::Window{prodXY, meanX, meanY});
+    return OnlineBaseFactor::createOnlineBaseF<OnlineCorrelation>(OnlineCorrelation::Window{varX, varY, covXY});
+}
+
+// 两值是否一致（同为 NaN 视为一致）
+bool sameValue(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+// 基准数据：线性同余生成的价格序列（确定性，便于复现）
+Ve benchmarkSeries(size_t length, unsigned int seed, double base) {
+    Ve series(static_cast<Eigen::Index>(length));
+    unsigned int state = seed;
+    for (size_t i = 0; i < length; ++i) {
+        state = state * 1103515245u + 12345u;
+        series[static_cast<Eigen::Index>(i)] = base + static_cast<double>((state >> 8) % 10000) / 100.0;
+    }
+    return series;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_x_csv = config.getString("0028_static_chain", "initial_x_csv", "");
+        const std::string initial_y_csv = config.getString("0028_static_chain", "initial_y_csv", "");
+        const std::string update_x_csv = config.getString("0028_static_chain", "update_x_csv", "");
+        const std::string update_y_csv = config.getString("0028_static_chain", "update_y_csv", "");
+        const std::string output_csv = config.getString("0028_static_chain", "output_csv", "");
+        const int precision = config.getInt("0028_static_chain", "precision", 6);
+        // 基准：窗口长度与更新次数（0 为不做基准）
+        const int bench_window = config.getInt("0028_static_chain", "bench_window", 250);
+        const int bench_updates = config.getInt("0028_static_chain", "bench_updates", 1000000);
+
+        if (initial_x_csv.empty() || initial_y_csv.empty() || update_x_csv.empty() ||
+            update_y_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial_x", initial_x_csv);
+        database.loadFromCSV("initial_y", initial_y_csv);
+        database.loadFromCSV("update_x", update_x_csv);
+        database.loadFromCSV("update_y", update_y_csv);
+
+        MatrixXd initial_x = database.getMatrix("initial_x");
+        MatrixXd initial_y = database.getMatrix("initial_y");
+        MatrixXd update_x = database.getMatrix("update_x");
+        MatrixXd update_y = database.getMatrix("update_y");
+
+        if (initial_x.cols() == 0 || initial_y.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values_x = columnToVector(initial_x, 0);
+        Ve initial_values_y = columnToVector(initial_y, 0);
+
+        // 同一数据分别构建动态节点图与静态链，逐步核对数值
+        auto dynamic_corr = buildDynamicCorrelation(initial_values_x, initial_values_y);
+        OnlineStaticCorrelation static_corr({initial_values_x, initial_values_y});
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,value\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0028_STATIC_CHAIN 测试 ===" << endl;
+        cout << "初始窗口长度: " << initial_values_x.size() << endl;
+
+        int mismatches = sameValue(static_corr.getValue(), dynamic_corr->getValue()) ? 0 : 1;
+        output_file << 0 << ",init," << std::fixed << std::setprecision(precision) << static_corr.getValue() << "\n";
+        cout << "初始相关系数: " << std::fixed << std::setprecision(precision) << static_corr.getValue() << endl;
+
+        const int update_rows = std::min(update_x.rows(), update_y.rows());
+        for (int row = 0; row < update_rows; ++row) {
+            Ve update_values_x = rowToVector(update_x, row);
+            Ve update_values_y = rowToVector(update_y, row);
+            if (update_values_x.size() != update_values_y.size()) {
+                std::cerr << "错误: 更新数据长度不一致" << std::endl;
+                return 1;
+            }
+
+            dynamic_corr->update(update_values_x, update_values_y, static_cast<size_t>(row + 1));
+            static_corr.update(update_values_x, update_values_y);
+            if (!sameValue(static_corr.getValue(), dynamic_corr->getValue())) {
+                ++mismatches;
+            }
+            output_file << (row + 1) << ",update," << std::fixed << std::setprecision(precision) << static_corr.getValue() << "\n";
+            cout << "更新 " << (row + 1) << " -> 相关系数: " << std::fixed << std::setprecision(precision) << static_corr.getValue() << endl;
+        }
+        output_file.close();
+        cout << "静态链与动态节点图不一致的步数: " << mismatches << endl;
+
+        // 基准：同一序列逐个样本更新，比较两种组合方式的单次更新耗时
+        if (bench_window > 1 && bench_updates > 0) {
+            const size_t total = static_cast<size_t>(bench_window) + static_cast<size_t>(bench_updates);
+            const Ve series_x = benchmarkSeries(total, 7u, 100.0);
+            const Ve series_y = benchmarkSeries(total, 11u, 50.0);
+            const Ve window_x = series_x.head(bench_window);
+            const Ve window_y = series_y.head(bench_window);
+            auto bench_dynamic = buildDynamicCorrelation(window_x, window_y);
+            OnlineStaticCorrelation bench_static({window_x, window_y});
+            Ve step_x(1);
+            Ve step_y(1);
+
+            double dynamic_checksum = 0.0;
+            auto dynamic_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_x[0] = series_x[bench_window + i];
+                step_y[0] = series_y[bench_window + i];
+                bench_dynamic->update(step_x, step_y, static_cast<size_t>(i + 1));
+                dynamic_checksum += bench_dynamic->getValue();
+            }
+            const double dynamic_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - dynamic_start).count();
+
+            double static_checksum = 0.0;
+            auto static_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_x[0] = series_x[bench_window + i];
+                step_y[0] = series_y[bench_window + i];
+                bench_static.update(step_x, step_y);
+                static_checksum += bench_static.getValue();
+            }
+            const double static_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - static_start).count();
+
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 基准: 窗口 " << bench_window << ", 更新 " << bench_updates << " 次" << endl;
+            cout << "  动态节点图: " << std::fixed << std::setprecision(1) << dynamic_ms * 1e6 / bench_updates << " ns/次" << endl;
+            cout << "  静态链:     " << std::fixed << std::setprecision(1) << static_ms * 1e6 / bench_updates << " ns/次"
+                 << "（加速 " << std::setprecision(2) << dynamic_ms / static_ms << "x）" << endl;
+            cout << "  结果校验: " << (sameValue(dynamic_checksum, static_checksum) ? "一致" : "不一致") << endl;
+        }
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
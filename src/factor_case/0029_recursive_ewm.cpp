@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineEWMMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（递归EWM按 ignore_na 处理缺失值）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_x_csv = config.getString("0029_recursive_ewm", "initial_x_csv", "");
+        const std::string initial_y_csv = config.getString("0029_recursive_ewm", "initial_y_csv", "");
+        const std::string update_x_csv = config.getString("0029_recursive_ewm", "update_x_csv", "");
+        const std::string update_y_csv = config.getString("0029_recursive_ewm", "update_y_csv", "");
+        const std::string output_csv = config.getString("0029_recursive_ewm", "output_csv", "");
+        const double halflife = config.getDouble("0029_recursive_ewm", "halflife", 5.0);
+        const int precision = config.getInt("0029_recursive_ewm", "precision", 6);
+
+        if (initial_x_csv.empty() || initial_y_csv.empty() || update_x_csv.empty() ||
+            update_y_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial_x", initial_x_csv);
+        database.loadFromCSV("initial_y", initial_y_csv);
+        database.loadFromCSV("update_x", update_x_csv);
+        database.loadFromCSV("update_y", update_y_csv);
+
+        MatrixXd initial_x = database.getMatrix("initial_x");
+        MatrixXd initial_y = database.getMatrix("initial_y");
+        MatrixXd update_x = database.getMatrix("update_x");
+        MatrixXd update_y = database.getMatrix("update_y");
+
+        if (initial_x.cols() == 0 || initial_y.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values_x = columnToVector(initial_x, 0);
+        Ve initial_values_y = columnToVector(initial_y, 0);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,adjust,sum,mean,var,cov,skew\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0029_RECURSIVE_EWM 测试 ===" << endl;
+        cout << "初始序列长度: " << initial_values_x.size() << ", 半衰期: " << halflife << endl;
+
+        // adjust=true / adjust=false 两种模式依次输出
+        for (const bool adjust : {true, false}) {
+            const auto params = OnlineRecursiveEWMParams::fromHalflife(halflife, adjust);
+            auto ewm_sum = OnlineBaseFactor::createOnlineBaseF<OnlineRecursiveEWMSum>(initial_values_x, params);
+            auto ewm_mean = OnlineBaseFactor::createOnlineBaseF<OnlineRecursiveEWMMean>(initial_values_x, params);
+            auto ewm_var = OnlineBaseFactor::createOnlineBaseF<OnlineRecursiveEWMVar>(initial_values_x, params);
+            auto ewm_cov = OnlineBaseFactor::createOnlineBaseF<OnlineRecursiveEWMCov>(initial_values_x, initial_values_y, params);
+            auto ewm_skew = OnlineBaseFactor::createOnlineBaseF<OnlineRecursiveEWMSkew>(initial_values_x, params);
+
+            const auto write_row = [&](int step, const char* operation) {
+                output_file << step << "," << operation << "," << (adjust ? 1 : 0) << std::fixed << std::setprecision(precision)
+                            << "," << ewm_sum->getValue() << "," << ewm_mean->getValue() << "," << ewm_var->getValue()
+                            << "," << ewm_cov->getValue() << "," << ewm_skew->getValue() << "\n";
+                cout << "adjust=" << (adjust ? 1 : 0) << " 步 " << step << " -> 均值: " << std::fixed << std::setprecision(precision)
+                     << ewm_mean->getValue() << ", 方差: " << ewm_var->getValue() << ", 协方差: " << ewm_cov->getValue()
+                     << ", 偏度: " << ewm_skew->getValue() << endl;
+            };
+
+            write_row(0, "init");
+            const int update_rows = std::min(update_x.rows(), update_y.rows());
+            for (int row = 0; row < update_rows; ++row) {
+                Ve update_values_x = rowToVector(update_x, row);
+                Ve update_values_y = rowToVector(update_y, row);
+                const size_t version = static_cast<size_t>(row + 1);
+                ewm_sum->update(update_values_x, version);
+                ewm_mean->update(update_values_x, version);
+                ewm_var->update(update_values_x, version);
+                ewm_cov->update(update_values_x, update_values_y, version);
+                ewm_skew->update(update_values_x, version);
+                write_row(row + 1, "update");
+            }
+        }
+
+        output_file.close();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineEWMMethod.h"
+#include "../OnlineBaseFactor/BaseFactor/BaseFactor.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（与单半衰期链一致地跳过）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+// 解析逗号分隔的半衰期列表
+std::vector<double> parseHalflives(const std::string& text) {
+    std::vector<double> halflives;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            halflives.push_back(std::stod(item));
+        }
+    }
+    return halflives;
+}
+
+// 单半衰期链：各自的权重缓存与 OnlineEWMSum / OnlineEWMSumProduct / OnlineEWMMean / OnlineEWMVar（对照组）
+struct SingleChain {
+    std::shared_ptr<OnlineEWMMean> m_mean;
+    std::shared_ptr<OnlineEWMVar> m_var;
+};
+
+std::vector<SingleChain> buildSingleChains(const Ve& initialValues, const std::vector<double>& halflives) {
+    const size_t windowSize = static_cast<size_t>(initialValues.size());
+    auto dataCache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initialValues);
+    std::vector<SingleChain> chains;
+    for (const double halflife : halflives) {
+        VectorXd weights;
+        BaseFactor::ewm_weights(2 * windowSize, halflife, weights);
+        auto weightCache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(weights);
+        auto sum = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, dataCache});
+        auto sumSquares = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, dataCache, dataCache});
+        auto mean = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sum});
+        auto var = OnlineBaseFactor::createOnlineBaseF<OnlineEWMVar>(OnlineEWMVar::Window{weightCache, mean, sumSquares});
+        chains.push_back(SingleChain{mean, var});
+    }
+    return chains;
+}
+
+// 两值是否一致（同为 NaN 视为一致）
+bool sameValue(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+// 基准数据：线性同余生成的收益率序列（确定性，便于复现）
+Ve benchmarkSeries(size_t length, unsigned int seed) {
+    Ve series(static_cast<Eigen::Index>(length));
+    unsigned int state = seed;
+    for (size_t i = 0; i < length; ++i) {
+        state = state * 1103515245u + 12345u;
+        series[static_cast<Eigen::Index>(i)] = (static_cast<double>((state >> 8) % 20001) - 10000.0) / 1e6;
+    }
+    return series;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0030_ewm_bank", "initial_csv", "");
+        const std::string update_csv = config.getString("0030_ewm_bank", "update_csv", "");
+        const std::string output_csv = config.getString("0030_ewm_bank", "output_csv", "");
+        const std::vector<double> halflives = parseHalflives(config.getString("0030_ewm_bank", "halflives", "2,21,63,252"));
+        const int precision = config.getInt("0030_ewm_bank", "precision", 6);
+        // 基准：窗口长度与更新次数（0 为不做基准）
+        const int bench_window = config.getInt("0030_ewm_bank", "bench_window", 504);
+        const int bench_updates = config.getInt("0030_ewm_bank", "bench_updates", 200000);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty() || halflives.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径或半衰期" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+        const size_t window_size = static_cast<size_t>(initial_values.size());
+
+        // 多半衰期统计：一个数据缓存、一个权重表、一个节点
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values);
+        auto weight_bank = OnlineEWMBank::createWeightBank(window_size, halflives);
+        auto ewm_bank = OnlineBaseFactor::createOnlineBaseF<OnlineEWMBank>(OnlineEWMBank::Window{weight_bank, data_cache});
+        // 对照组：每个半衰期一条单独的链
+        auto single_chains = buildSingleChains(initial_values, halflives);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,halflife,mean,var\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0030_EWM_BANK 测试 ===" << endl;
+        cout << "初始窗口长度: " << window_size << ", 半衰期个数: " << halflives.size() << endl;
+
+        int mismatches = 0;
+        const auto write_rows = [&](int step, const char* operation) {
+            for (size_t k = 0; k < halflives.size(); ++k) {
+                const Eigen::Index index = static_cast<Eigen::Index>(k);
+                const double mean = ewm_bank->getMean(index);
+                const double var = ewm_bank->getVar(index);
+                if (!sameValue(mean, single_chains[k].m_mean->getValue()) || !sameValue(var, single_chains[k].m_var->getValue())) {
+                    ++mismatches;
+                }
+                output_file << step << "," << operation << "," << halflives[k] << std::fixed << std::setprecision(precision)
+                            << "," << mean << "," << var << "\n";
+                output_file.unsetf(std::ios::fixed);
+            }
+        };
+
+        write_rows(0, "init");
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            Ve update_values = rowToVector(update_matrix, row);
+            const size_t version = static_cast<size_t>(row + 1);
+            ewm_bank->update(update_values, version);
+            for (auto& chain : single_chains) {
+                chain.m_var->update(update_values, version);
+            }
+            write_rows(row + 1, "update");
+            cout << "更新 " << (row + 1) << " -> 带权均值[0]: " << std::fixed << std::setprecision(precision)
+                 << ewm_bank->getMean(0) << ", 带权方差[0]: " << ewm_bank->getVar(0) << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+        output_file.close();
+        cout << "多半衰期节点与单半衰期链不一致的项数: " << mismatches << endl;
+
+        // 基准：同一序列逐个样本更新，比较一个多半衰期节点与 K 条单独链的单次更新耗时
+        if (bench_window > 1 && bench_updates > 0) {
+            const size_t total = static_cast<size_t>(bench_window) + static_cast<size_t>(bench_updates);
+            const Ve series = benchmarkSeries(total, 7u);
+            const Ve window = series.head(bench_window);
+            auto bench_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(window);
+            auto bench_weights = OnlineEWMBank::createWeightBank(static_cast<size_t>(bench_window), halflives);
+            auto bench_bank = OnlineBaseFactor::createOnlineBaseF<OnlineEWMBank>(OnlineEWMBank::Window{bench_weights, bench_cache});
+            auto bench_chains = buildSingleChains(window, halflives);
+            Ve step_values(1);
+
+            double single_checksum = 0.0;
+            auto single_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                for (auto& chain : bench_chains) {
+                    chain.m_var->update(step_values, static_cast<size_t>(i + 1));
+                    single_checksum += chain.m_var->getValue();
+                }
+            }
+            const double single_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - single_start).count();
+
+            double bank_checksum = 0.0;
+            auto bank_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                bench_bank->update(step_values, static_cast<size_t>(i + 1));
+                for (Eigen::Index k = 0; k < bench_bank->getBankSize(); ++k) {
+                    bank_checksum += bench_bank->getVar(k);
+                }
+            }
+            const double bank_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - bank_start).count();
+
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 基准: 窗口 " << bench_window << ", 半衰期 "
+                 << halflives.size() << " 个, 更新 " << bench_updates << " 次" << endl;
+            cout << "  单半衰期链: " << std::fixed << std::setprecision(1) << single_ms * 1e6 / bench_updates << " ns/次" << endl;
+            cout << "  多半衰期节点: " << std::fixed << std::setprecision(1) << bank_ms * 1e6 / bench_updates << " ns/次"
+                 << "（加速 " << std::setprecision(2) << single_ms / bank_ms << "x）" << endl;
+            cout << "  结果校验: " << (sameValue(single_checksum, bank_checksum) ? "一致" : "不一致") << endl;
+        }
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineKernelMethod.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（核加权和跳过缺失值）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+// 整窗直接加权（对照组）
+double bruteForceSum(const RingVec<double>& values, const OnlineKernel& kernel) {
+    double value = 0.0;
+    for (int i = 0; i < values.size(); ++i) {
+        if (!std::isnan(values[i])) {
+            value += kernel.weight(static_cast<size_t>(i)) * values[i];
+        }
+    }
+    return value;
+}
+
+// 基准数据：线性同余生成的价格序列（确定性，便于复现）
+Ve benchmarkSeries(size_t length, unsigned int seed, double base) {
+    Ve series(static_cast<Eigen::Index>(length));
+    unsigned int state = seed;
+    for (size_t i = 0; i < length; ++i) {
+        state = state * 1103515245u + 12345u;
+        series[static_cast<Eigen::Index>(i)] = base + static_cast<double>((state >> 8) % 10000) / 100.0;
+    }
+    return series;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0031_kernel_sum", "initial_csv", "");
+        const std::string update_csv = config.getString("0031_kernel_sum", "update_csv", "");
+        const std::string output_csv = config.getString("0031_kernel_sum", "output_csv", "");
+        const int precision = config.getInt("0031_kernel_sum", "precision", 6);
+        // 基准：窗口长度与更新次数（0 为不做基准）
+        const int bench_window = config.getInt("0031_kernel_sum", "bench_window", 250);
+        const int bench_updates = config.getInt("0031_kernel_sum", "bench_updates", 200000);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+        const size_t window_size = static_cast<size_t>(initial_values.size());
+
+        // 三种核共用一个数据缓存：线性衰减、三角核、自定义（前段 1 + p^2，后段取前段末端值的常数）
+        const size_t knee = window_size / 2;
+        const double knee_weight = 1.0 + static_cast<double>(knee) * static_cast<double>(knee);
+        const std::vector<std::pair<std::string, OnlineKernel>> kernels = {
+            {"linear", OnlineKernel::linearDecay(window_size)},
+            {"triangular", OnlineKernel::triangular(window_size)},
+            {"custom", OnlineKernel::piecewise(window_size, {OnlineKernel::Segment{0, 1.0, 0.0, 1.0},
+                                                             OnlineKernel::Segment{knee, knee_weight, 0.0, 0.0}})},
+        };
+        auto data_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initial_values);
+        std::vector<std::shared_ptr<OnlineKernelSum>> kernel_sums;
+        for (const auto& kernel : kernels) {
+            kernel_sums.push_back(OnlineBaseFactor::createOnlineBaseF<OnlineKernelSum>(OnlineKernelSum::Window{data_cache}, kernel.second));
+        }
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,kernel,value,mean\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0031_KERNEL_SUM 测试 ===" << endl;
+        cout << "初始窗口长度: " << window_size << endl;
+
+        double max_error = 0.0;
+        const auto write_rows = [&](int step, const char* operation) {
+            for (size_t k = 0; k < kernels.size(); ++k) {
+                const double value = kernel_sums[k]->getValue();
+                max_error = std::max(max_error, std::abs(value - bruteForceSum(data_cache->getValues(), kernels[k].second)));
+                output_file << step << "," << operation << "," << kernels[k].first << std::fixed << std::setprecision(precision)
+                            << "," << value << "," << kernel_sums[k]->getMean() << "\n";
+            }
+        };
+
+        write_rows(0, "init");
+        for (int row = 0; row < update_matrix.rows(); ++row) {
+            Ve update_values = rowToVector(update_matrix, row);
+            const size_t version = static_cast<size_t>(row + 1);
+            for (auto& kernel_sum : kernel_sums) {
+                kernel_sum->update(update_values, version);
+            }
+            write_rows(row + 1, "update");
+            cout << "更新 " << (row + 1) << " -> 线性衰减加权均值: " << std::fixed << std::setprecision(precision)
+                 << kernel_sums[0]->getMean() << ", 三角核加权均值: " << kernel_sums[1]->getMean() << endl;
+        }
+        output_file.close();
+        cout << "与整窗直接加权的最大偏差: " << std::scientific << std::setprecision(3) << max_error << endl;
+        cout.unsetf(std::ios::scientific);
+
+        // 基准：线性衰减核，增量更新与整窗直接加权的单次更新耗时
+        if (bench_window > 1 && bench_updates > 0) {
+            const size_t total = static_cast<size_t>(bench_window) + static_cast<size_t>(bench_updates);
+            const Ve series = benchmarkSeries(total, 7u, 100.0);
+            const Ve window = series.head(bench_window);
+            const OnlineKernel kernel = OnlineKernel::linearDecay(static_cast<size_t>(bench_window));
+            auto bench_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(window);
+            auto bench_sum = OnlineBaseFactor::createOnlineBaseF<OnlineKernelSum>(OnlineKernelSum::Window{bench_cache}, kernel);
+            auto brute_cache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(window);
+            Ve step_values(1);
+
+            double brute_checksum = 0.0;
+            auto brute_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                brute_cache->update(step_values, static_cast<size_t>(i + 1));
+                brute_checksum += bruteForceSum(brute_cache->getValues(), kernel);
+            }
+            const double brute_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - brute_start).count();
+
+            double kernel_checksum = 0.0;
+            auto kernel_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                bench_sum->update(step_values, static_cast<size_t>(i + 1));
+                kernel_checksum += bench_sum->getValue();
+            }
+            const double kernel_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - kernel_start).count();
+
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 基准: 线性衰减核, 窗口 " << bench_window << ", 更新 " << bench_updates << " 次" << endl;
+            cout << "  整窗直接加权: " << std::fixed << std::setprecision(1) << brute_ms * 1e6 / bench_updates << " ns/次" << endl;
+            cout << "  增量核加权和: " << std::fixed << std::setprecision(1) << kernel_ms * 1e6 / bench_updates << " ns/次"
+                 << "（加速 " << std::setprecision(2) << brute_ms / kernel_ms << "x）" << endl;
+            cout << "  校验和相对偏差: " << std::scientific << std::setprecision(3)
+                 << std::abs(kernel_checksum - brute_checksum) / std::abs(brute_checksum) << endl;
+            cout.unsetf(std::ios::scientific);
+        }
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineEWMMethod.h"
+#include "../OnlineBaseFactor/OnlineSimdKernels.h"
+#include "../OnlineBaseFactor/BaseFactor/BaseFactor.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（向量内核按掩码跳过）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+// 一组 EWM 加权和节点：sum(w x)、sum(w x y)、sum(w x y z)
+struct EWMNodes {
+    std::shared_ptr<OnlineEWMSum> m_sum;
+    std::shared_ptr<OnlineEWMSumProduct> m_sumProduct;
+    std::shared_ptr<OnlineEWMSumProduct3> m_sumProduct3;
+};
+
+EWMNodes buildNodes(const Ve& weights, const Ve& x, const Ve& y, const Ve& z) {
+    auto weightCache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(weights);
+    auto cacheX = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(x);
+    auto cacheY = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(y);
+    auto cacheZ = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(z);
+    return EWMNodes{
+        OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, cacheX}),
+        OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, cacheX, cacheY}),
+        OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct3>(OnlineEWMSumProduct3::Window{weightCache, cacheX, cacheY, cacheZ}),
+    };
+}
+
+// 逐项分支循环（向量内核之前的写法，对照组）
+double branchySum(const double* weights, const double* x, const double* y, const double* z, size_t count) {
+    double value = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (std::isnan(x[i]) || std::isnan(y[i]) || std::isnan(z[i])) {
+            continue;
+        }
+        value += weights[i] * x[i] * y[i] * z[i];
+    }
+    return value;
+}
+
+// 两值是否逐位一致（同为 NaN 视为一致）
+bool sameValue(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+// 基准数据：线性同余生成的收益率序列，约 5% 为 NaN（确定性，便于复现）
+Ve benchmarkSeries(size_t length, unsigned int seed) {
+    Ve series(static_cast<Eigen::Index>(length));
+    unsigned int state = seed;
+    for (size_t i = 0; i < length; ++i) {
+        state = state * 1103515245u + 12345u;
+        const unsigned int draw = (state >> 8) % 20001;
+        series[static_cast<Eigen::Index>(i)] = draw % 20 == 0 ? std::nan("") : (static_cast<double>(draw) - 10000.0) / 1e4;
+    }
+    return series;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_x_csv = config.getString("0032_ewm_simd", "initial_x_csv", "");
+        const std::string initial_y_csv = config.getString("0032_ewm_simd", "initial_y_csv", "");
+        const std::string initial_z_csv = config.getString("0032_ewm_simd", "initial_z_csv", "");
+        const std::string update_x_csv = config.getString("0032_ewm_simd", "update_x_csv", "");
+        const std::string update_y_csv = config.getString("0032_ewm_simd", "update_y_csv", "");
+        const std::string update_z_csv = config.getString("0032_ewm_simd", "update_z_csv", "");
+        const std::string output_csv = config.getString("0032_ewm_simd", "output_csv", "");
+        const double halflife = config.getDouble("0032_ewm_simd", "halflife", 10.0);
+        const int precision = config.getInt("0032_ewm_simd", "precision", 6);
+        // 基准：单次加权和的长度与重复次数（0 为不做基准）
+        const int bench_step = config.getInt("0032_ewm_simd", "bench_step", 64);
+        const int bench_updates = config.getInt("0032_ewm_simd", "bench_updates", 1000000);
+
+        if (initial_x_csv.empty() || initial_y_csv.empty() || initial_z_csv.empty() ||
+            update_x_csv.empty() || update_y_csv.empty() || update_z_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial_x", initial_x_csv);
+        database.loadFromCSV("initial_y", initial_y_csv);
+        database.loadFromCSV("initial_z", initial_z_csv);
+        database.loadFromCSV("update_x", update_x_csv);
+        database.loadFromCSV("update_y", update_y_csv);
+        database.loadFromCSV("update_z", update_z_csv);
+
+        MatrixXd initial_x = database.getMatrix("initial_x");
+        MatrixXd initial_y = database.getMatrix("initial_y");
+        MatrixXd initial_z = database.getMatrix("initial_z");
+        MatrixXd update_x = database.getMatrix("update_x");
+        MatrixXd update_y = database.getMatrix("update_y");
+        MatrixXd update_z = database.getMatrix("update_z");
+
+        if (initial_x.cols() == 0 || initial_y.cols() == 0 || initial_z.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values_x = columnToVector(initial_x, 0);
+        Ve initial_values_y = columnToVector(initial_y, 0);
+        Ve initial_values_z = columnToVector(initial_z, 0);
+        const size_t window_size = static_cast<size_t>(initial_values_x.size());
+        VectorXd weights;
+        BaseFactor::ewm_weights(2 * window_size, halflife, weights);
+
+        // 每种 CPU 支持的实现各跑一遍：结果写出用检测到的实现，其余实现与标量实现逐位比对
+        const OnlineSimd::Isa detected = OnlineSimd::activeIsa();
+        std::vector<OnlineSimd::Isa> isas;
+        for (const auto isa : {OnlineSimd::Isa::Scalar, OnlineSimd::Isa::Avx2, OnlineSimd::Isa::Avx512}) {
+            if (OnlineSimd::isSupported(isa)) {
+                isas.push_back(isa);
+            }
+        }
+        const int update_rows = std::min({update_x.rows(), update_y.rows(), update_z.rows()});
+        std::vector<std::vector<double>> results(isas.size());
+        for (size_t k = 0; k < isas.size(); ++k) {
+            OnlineSimd::setIsa(isas[k]);
+            EWMNodes nodes = buildNodes(weights, initial_values_x, initial_values_y, initial_values_z);
+            const auto record = [&]() {
+                results[k].push_back(nodes.m_sum->getValue());
+                results[k].push_back(nodes.m_sumProduct->getValue());
+                results[k].push_back(nodes.m_sumProduct3->getValue());
+            };
+            record();
+            for (int row = 0; row < update_rows; ++row) {
+                Ve update_values_x = rowToVector(update_x, row);
+                Ve update_values_y = rowToVector(update_y, row);
+                Ve update_values_z = rowToVector(update_z, row);
+                const size_t version = static_cast<size_t>(row + 1);
+                nodes.m_sum->update(update_values_x, version);
+                nodes.m_sumProduct->update(update_values_x, update_values_y, version);
+                nodes.m_sumProduct3->update(update_values_x, update_values_y, update_values_z, version);
+                record();
+            }
+        }
+        OnlineSimd::setIsa(detected);
+
+        int mismatches = 0;
+        for (size_t k = 1; k < isas.size(); ++k) {
+            for (size_t i = 0; i < results[0].size(); ++i) {
+                if (!sameValue(results[k][i], results[0][i])) {
+                    ++mismatches;
+                }
+            }
+        }
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,operation,sum,sum_product,sum_product3\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0032_EWM_SIMD 测试 ===" << endl;
+        cout << "初始窗口长度: " << window_size << ", 每步更新: " << update_x.cols() << ", 检测到的实现: " << OnlineSimd::isaName(detected) << endl;
+
+        const std::vector<double>& values = results.back();
+        for (int step = 0; step <= update_rows; ++step) {
+            const size_t offset = static_cast<size_t>(step) * 3;
+            output_file << step << "," << (step == 0 ? "init" : "update") << std::fixed << std::setprecision(precision)
+                        << "," << values[offset] << "," << values[offset + 1] << "," << values[offset + 2] << "\n";
+            output_file.unsetf(std::ios::fixed);
+            cout << "步 " << step << " -> 加权和: " << std::fixed << std::setprecision(precision) << values[offset]
+                 << ", 加权乘积和: " << values[offset + 1] << ", 三元加权乘积和: " << values[offset + 2] << endl;
+            cout.unsetf(std::ios::fixed);
+        }
+        output_file.close();
+        cout << "各实现与标量实现不一致的项数: " << mismatches << endl;
+
+        // 基准：sum(w x y z) 单次加权和，逐项分支循环与各实现的耗时
+        if (bench_step > 0 && bench_updates > 0) {
+            const size_t length = static_cast<size_t>(bench_step) * 64;
+            const Ve series_x = benchmarkSeries(length, 7u);
+            const Ve series_y = benchmarkSeries(length, 11u);
+            const Ve series_z = benchmarkSeries(length, 13u);
+            const Ve bench_weights = Ve::LinSpaced(static_cast<Eigen::Index>(length), 0.5, 1.5);
+            const size_t count = static_cast<size_t>(bench_step);
+            const size_t offsets = length - count;
+
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 基准: 三元加权乘积和, 长度 " << bench_step << ", 重复 " << bench_updates << " 次" << endl;
+            double branchy_checksum = 0.0;
+            auto branchy_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                const size_t offset = static_cast<size_t>(i) % offsets;
+                branchy_checksum += branchySum(bench_weights.data() + offset, series_x.data() + offset,
+                                               series_y.data() + offset, series_z.data() + offset, count);
+            }
+            const double branchy_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - branchy_start).count();
+            cout << "  逐项分支循环: " << std::fixed << std::setprecision(1) << branchy_ms * 1e6 / bench_updates << " ns/次" << endl;
+
+            for (const auto isa : isas) {
+                OnlineSimd::setIsa(isa);
+                double checksum = 0.0;
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < bench_updates; ++i) {
+                    const size_t offset = static_cast<size_t>(i) % offsets;
+                    checksum += OnlineSimd::weightedSum(bench_weights.data() + offset, series_x.data() + offset,
+                                                        series_y.data() + offset, series_z.data() + offset, count);
+                }
+                const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+                cout << "  " << OnlineSimd::isaName(isa) << ": " << std::fixed << std::setprecision(1) << ms * 1e6 / bench_updates << " ns/次"
+                     << "（加速 " << std::setprecision(2) << branchy_ms / ms << "x，校验和相对偏差 " << std::scientific << std::setprecision(3)
+                     << std::abs(checksum - branchy_checksum) / std::abs(branchy_checksum) << "）" << endl;
+                cout.unsetf(std::ios::scientific);
+            }
+            OnlineSimd::setIsa(detected);
+        }
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "../Tool/Tool.h"
+#include "../OnlineBaseFactor/OnlineEWMMethod.h"
+#include "../OnlineBaseFactor/BaseFactor/BaseFactor.h"
+
+using Eigen::MatrixXd;
+using EigenExtra::Ve;
+using std::cout;
+using std::endl;
+
+namespace {
+
+// 保留 NaN（与单独节点一致地跳过）
+Ve columnToVector(const MatrixXd& matrix, int column) {
+    Ve result(static_cast<int>(matrix.rows()));
+    for (int row = 0; row < matrix.rows(); ++row) {
+        result[row] = matrix(row, column);
+    }
+    return result;
+}
+
+Ve rowToVector(const MatrixXd& matrix, int row) {
+    Ve result(static_cast<int>(matrix.cols()));
+    for (int col = 0; col < matrix.cols(); ++col) {
+        result[col] = matrix(row, col);
+    }
+    return result;
+}
+
+// 单独节点链：OnlineEWMSum -> OnlineEWMMean，OnlineEWMSumProduct(x,x)，OnlineEWMSumProduct3(x,x,x) -> OnlineEWMVar / OnlineEWMSkew（对照组）
+struct SkewChain {
+    std::shared_ptr<OnlineEWMMean> m_mean;
+    std::shared_ptr<OnlineEWMVar> m_var;
+    std::shared_ptr<OnlineEWMSkew> m_skew;
+};
+
+SkewChain buildSkewChain(const std::shared_ptr<OnlineWeightCache>& weightCache, const Ve& initialValues) {
+    auto dataCache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initialValues);
+    auto sum = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSum>(OnlineEWMSum::Window{weightCache, dataCache});
+    auto mean = OnlineBaseFactor::createOnlineBaseF<OnlineEWMMean>(OnlineEWMMean::Window{weightCache, sum});
+    auto sumSquares = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct>(OnlineEWMSumProduct::Window{weightCache, dataCache, dataCache});
+    auto sumCubes = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSumProduct3>(OnlineEWMSumProduct3::Window{weightCache, dataCache, dataCache, dataCache});
+    auto var = OnlineBaseFactor::createOnlineBaseF<OnlineEWMVar>(OnlineEWMVar::Window{weightCache, mean, sumSquares});
+    auto skew = OnlineBaseFactor::createOnlineBaseF<OnlineEWMSkew>(OnlineEWMSkew::Window{weightCache, mean, sumSquares, sumCubes});
+    return SkewChain{mean, var, skew};
+}
+
+std::shared_ptr<OnlineEWMMoments> buildMoments(const std::shared_ptr<OnlineWeightCache>& weightCache, const Ve& initialValues) {
+    auto dataCache = OnlineBaseFactor::createOnlineBaseF<OnlineDataCache>(initialValues);
+    return OnlineBaseFactor::createOnlineBaseF<OnlineEWMMoments>(OnlineEWMMoments::Window{weightCache, dataCache});
+}
+
+// 两值之差（同为 NaN 视为 0）
+double deviation(double a, double b) {
+    if (std::isnan(a) && std::isnan(b)) {
+        return 0.0;
+    }
+    return std::abs(a - b);
+}
+
+// 基准数据：线性同余生成的收益率序列（确定性，便于复现）
+Ve benchmarkSeries(size_t length, unsigned int seed) {
+    Ve series(static_cast<Eigen::Index>(length));
+    unsigned int state = seed;
+    for (size_t i = 0; i < length; ++i) {
+        state = state * 1103515245u + 12345u;
+        series[static_cast<Eigen::Index>(i)] = (static_cast<double>((state >> 8) % 20001) - 10000.0) / 1e4;
+    }
+    return series;
+}
+
+}
+
+int main() {
+    try {
+        Tool::ConfigReader config("config.ini");
+        const std::string initial_csv = config.getString("0033_ewm_moments", "initial_csv", "");
+        const std::string update_csv = config.getString("0033_ewm_moments", "update_csv", "");
+        const std::string output_csv = config.getString("0033_ewm_moments", "output_csv", "");
+        const double halflife = config.getDouble("0033_ewm_moments", "halflife", 10.0);
+        const int precision = config.getInt("0033_ewm_moments", "precision", 6);
+        // 基准：窗口长度与更新次数（0 为不做基准）
+        const int bench_window = config.getInt("0033_ewm_moments", "bench_window", 238);
+        const int bench_updates = config.getInt("0033_ewm_moments", "bench_updates", 1000000);
+
+        if (initial_csv.empty() || update_csv.empty() || output_csv.empty()) {
+            std::cerr << "错误: 配置文件中缺少必要的路径" << std::endl;
+            return 1;
+        }
+
+        Tool::MemoryDatabase database;
+        database.loadFromCSV("initial", initial_csv);
+        database.loadFromCSV("update", update_csv);
+
+        MatrixXd initial_matrix = database.getMatrix("initial");
+        MatrixXd update_matrix = database.getMatrix("update");
+
+        if (initial_matrix.cols() == 0) {
+            std::cerr << "错误: 初始数据为空" << std::endl;
+            return 1;
+        }
+
+        Ve initial_values = columnToVector(initial_matrix, 0);
+        const size_t window_size = static_cast<size_t>(initial_values.size());
+        VectorXd weights;
+        BaseFactor::ewm_weights(2 * window_size, halflife, weights);
+        auto weight_cache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(weights);
+
+        std::ofstream output_file(output_csv);
+        if (!output_file.is_open()) {
+            std::cerr << "错误: 无法写入输出文件: " << output_csv << std::endl;
+            return 1;
+        }
+
+        output_file << "# Generated at: " << Tool::Timestamp::getCurrentTimestamp() << "\n";
+        output_file << "step,mode,mean,var,skew,kurt\n";
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 0033_EWM_MOMENTS 测试 ===" << endl;
+        cout << "初始窗口长度: " << window_size << ", 每步更新: " << update_matrix.cols() << ", 半衰期: " << halflife << endl;
+
+        // batch：每行整体更新一次（大步长）；single：逐个样本更新（小步长），每行末尾输出
+        double max_deviation = 0.0;
+        for (const bool batch : {true, false}) {
+            const char* mode = batch ? "batch" : "single";
+            auto moments = buildMoments(weight_cache, initial_values);
+            SkewChain chain = buildSkewChain(weight_cache, initial_values);
+            size_t version = 0;
+
+            const auto write_row = [&](int step) {
+                max_deviation = std::max({max_deviation, deviation(moments->getMean(), chain.m_mean->getValue()),
+                                          deviation(moments->getVar(), chain.m_var->getValue()),
+                                          deviation(moments->getSkew(), chain.m_skew->getValue())});
+                output_file << step << "," << mode << std::fixed << std::setprecision(precision) << "," << moments->getMean()
+                            << "," << moments->getVar() << "," << moments->getSkew() << "," << moments->getBiasedKurt() << "\n";
+                output_file.unsetf(std::ios::fixed);
+                cout << mode << " 步 " << step << " -> 均值: " << std::fixed << std::setprecision(precision) << moments->getMean()
+                     << ", 方差: " << moments->getVar() << ", 偏度: " << moments->getSkew() << ", 峰度(有偏): " << moments->getBiasedKurt() << endl;
+                cout.unsetf(std::ios::fixed);
+            };
+
+            write_row(0);
+            for (int row = 0; row < update_matrix.rows(); ++row) {
+                const Ve update_values = rowToVector(update_matrix, row);
+                if (batch) {
+                    ++version;
+                    moments->update(update_values, version);
+                    chain.m_var->update(update_values, version);
+                    chain.m_skew->update(update_values, version);
+                } else {
+                    for (Eigen::Index col = 0; col < update_values.size(); ++col) {
+                        const Ve step_values = update_values.segment(col, 1);
+                        ++version;
+                        moments->update(step_values, version);
+                        chain.m_var->update(step_values, version);
+                        chain.m_skew->update(step_values, version);
+                    }
+                }
+                write_row(row + 1);
+            }
+        }
+        output_file.close();
+        cout << "多阶矩节点与单独节点链的最大偏差: " << std::scientific << std::setprecision(3) << max_deviation << endl;
+        cout.unsetf(std::ios::scientific);
+
+        // 基准：逐个样本更新，比较单独节点链（均值/平方和/立方和各读一遍窗口）与多阶矩节点求偏度的单次更新耗时
+        if (bench_window > 1 && bench_updates > 0) {
+            const size_t total = static_cast<size_t>(bench_window) + static_cast<size_t>(bench_updates);
+            const Ve series = benchmarkSeries(total, 7u);
+            const Ve window = series.head(bench_window);
+            VectorXd bench_weights;
+            BaseFactor::ewm_weights(2 * static_cast<size_t>(bench_window), halflife, bench_weights);
+            auto bench_weight_cache = OnlineBaseFactor::createOnlineBaseF<OnlineWeightCache>(bench_weights);
+            SkewChain bench_chain = buildSkewChain(bench_weight_cache, window);
+            auto bench_moments = buildMoments(bench_weight_cache, window);
+            Ve step_values(1);
+
+            double chain_checksum = 0.0;
+            auto chain_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                bench_chain.m_skew->update(step_values, static_cast<size_t>(i + 1));
+                chain_checksum += bench_chain.m_skew->getValue();
+            }
+            const double chain_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - chain_start).count();
+
+            double moments_checksum = 0.0;
+            auto moments_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < bench_updates; ++i) {
+                step_values[0] = series[bench_window + i];
+                bench_moments->update(step_values, static_cast<size_t>(i + 1));
+                moments_checksum += bench_moments->getSkew();
+            }
+            const double moments_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - moments_start).count();
+
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 基准: 偏度, 窗口 " << bench_window << ", 更新 " << bench_updates << " 次" << endl;
+            cout << "  单独节点链: " << std::fixed << std::setprecision(1) << chain_ms * 1e6 / bench_updates << " ns/次" << endl;
+            cout << "  多阶矩节点: " << std::fixed << std::setprecision(1) << moments_ms * 1e6 / bench_updates << " ns/次"
+                 << "（加速 " << std::setprecision(2) << chain_ms / moments_ms << "x）" << endl;
+            cout << "  校验和相对偏差: " << std::scientific << std::setprecision(3)
+                 << std::abs(moments_checksum - chain_checksum) / std::abs(chain_checksum) << endl;
+            cout.unsetf(std::ios::scientific);
+        }
+
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已写入: " << output_csv << endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
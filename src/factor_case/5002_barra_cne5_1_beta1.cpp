@@ -3,6 +3,8 @@
 #include <fstream>
 #include <chrono>
 #include <vector>
+#include <memory>
+#include <string>
 #include <algorithm>
 #include <climits>
 
@@ -42,7 +44,11 @@ int main() {
         int precision = config.getInt("5002_cne5_1_beta1", "precision", 6);
         int stepSize = config.getInt("5002_cne5_1_beta1", "stepSize", 1);
         int lagWindow = config.getInt("5002_cne5_1_beta1", "lagWindow", 100);
-        int reformWindow = config.getInt("5002_cne5_1_beta1", "reformWindow", 1);
+        int reformWindow = config.getInt("5002_cne5_1_beta1", "reformWindow", 0);
+        bool useCrossSection = config.getBool("5002_cne5_1_beta1", "useCrossSection", false);
+        int threadsNum = config.getInt("5002_cne5_1_beta1", "threadsNum", 1);
+        // 检查点文件（非空时初始化后保存快照，并由新实例恢复后继续更新）
+        std::string checkpoint_path = config.getString("5002_cne5_1_beta1", "checkpoint_path", "");
         
         if (input_pct_chg.empty() || input_a_mkt_cap.empty() || 
             input_is_valid.empty() || output_csv.empty()) {
@@ -55,6 +61,8 @@ int main() {
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   lagWindow = " << lagWindow << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   stepSize = " << stepSize << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   reformWindow = " << reformWindow << endl;
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   useCrossSection = " << (useCrossSection ? "true" : "false") << endl;
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   threadsNum = " << threadsNum << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   precision = " << precision << endl;
         
         // 读取输入数据（多线程并行加载）
@@ -97,8 +105,15 @@ int main() {
             return 1;
         }
         
-        // 创建beta实例
-        barra_cne5_1_beta1 beta;
+        // 创建实例（检查点恢复时按相同设置另建实例）
+        auto createBarra_cne5_1_beta1 = [&]() {
+            auto instance = std::make_unique<barra_cne5_1_beta1>();
+            instance->setUseCrossSection(useCrossSection);
+            instance->setThreadsNum(static_cast<size_t>(threadsNum));
+            instance->setReformWindow(reformWindow > 0 ? static_cast<size_t>(reformWindow) : 0);
+            return instance;
+        };
+        auto beta = createBarra_cne5_1_beta1();
         
         // 准备输出文件
         std::ofstream output_file(output_csv);
@@ -125,14 +140,22 @@ int main() {
         
         {
             PROFILE_SCOPE("barra_cne5_1_beta1::Init");
-            int init_result = beta.Init(initRet, initCap, initValid);
+            int init_result = beta->Init(initRet, initCap, initValid);
         }
         double init_elapsed = getElapsedMs(init_start);
         
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 初始化完成，耗时: " << std::fixed << std::setprecision(3) << init_elapsed << " ms" << endl;
+        const auto arena_stats = beta->getArenaStats();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 节点内存池: " << arena_stats.nodes << " 个节点, "
+             << arena_stats.allocations << " 次分配, 已用 " << std::fixed << std::setprecision(1) << arena_stats.usedBytes / 1024.0
+             << " KB / 预留 " << arena_stats.reservedBytes / 1024.0 << " KB, " << arena_stats.blocks << " 块" << endl;
+        const auto& graph_stats = beta->getGraphStats();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 节点去重: 创建 " << graph_stats.createdNodes
+             << " 个, 复用 " << graph_stats.dedupedNodes << " 个, 节省约 "
+             << std::fixed << std::setprecision(1) << graph_stats.savedBytes / 1024.0 << " KB" << endl;
         
         // 输出初始化结果
-        const Ve& init_beta = beta.getValue();
+        const Ve& init_beta = beta->getValue();
         output_file << lagWindow - 1 << ",0,init," << std::fixed << std::setprecision(3) << init_elapsed;
         for (int i = 0; i < num_stocks; ++i) {
             if (i < init_beta.size()) {
@@ -147,6 +170,26 @@ int main() {
         }
         output_file << "\n";
         
+        // 检查点：保存快照后在新实例上恢复，后续更新由恢复出的实例继续（结果应与连续运行一致）
+        if (!checkpoint_path.empty()) {
+            auto save_start = std::chrono::high_resolution_clock::now();
+            if (beta->SaveCheckpoint(checkpoint_path) != 0) {
+                std::cerr << "错误: 检查点保存失败: " << checkpoint_path << std::endl;
+                return 1;
+            }
+            double save_elapsed = getElapsedMs(save_start);
+            auto restore_start = std::chrono::high_resolution_clock::now();
+            auto restored = createBarra_cne5_1_beta1();
+            if (restored->RestoreCheckpoint(checkpoint_path) != 0) {
+                std::cerr << "错误: 检查点恢复失败: " << checkpoint_path << std::endl;
+                return 1;
+            }
+            double restore_elapsed = getElapsedMs(restore_start);
+            beta = std::move(restored);
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 检查点: 保存耗时 " << std::fixed << std::setprecision(3) << save_elapsed
+                 << " ms, 恢复耗时 " << restore_elapsed << " ms" << endl;
+        }
+
         // 持续更新：按stepSize逐步处理后续数据
         int update_count = 0;
         int current_time = lagWindow;
@@ -168,14 +211,14 @@ int main() {
             // 调用Update
             {
                 PROFILE_SCOPE("barra_cne5_1_beta1::Update");
-                beta.Update(updateRet, updateCap, updateValid);
+                beta->Update(updateRet, updateCap, updateValid);
             }
             
             double update_elapsed = getElapsedMs(update_start);
             update_count++;
             
             // 输出更新结果
-            const Ve& update_beta = beta.getValue();
+            const Ve& update_beta = beta->getValue();
             output_file << (current_time + update_size - 1) << "," << update_count << ",update," 
                        << std::fixed << std::setprecision(3) << update_elapsed;
             for (int i = 0; i < num_stocks; ++i) {
@@ -206,6 +249,7 @@ int main() {
         
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 计算完成 ===" << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 总更新次数: " << update_count << endl;
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 重锚最大漂移: " << std::scientific << std::setprecision(3) << beta->getMaxDrift() << std::defaultfloat << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 结果已保存到: " << output_csv << endl;
         
         // 输出性能分析报告
@@ -3,6 +3,8 @@
 #include <fstream>
 #include <chrono>
 #include <vector>
+#include <memory>
+#include <string>
 #include <algorithm>
 #include <climits>
 #include <cmath>
@@ -40,6 +42,9 @@ int main() {
         int precision = config.getInt("6002_m_vpc_mut_ty_log2", "precision", 6);
         int stepSize = config.getInt("6002_m_vpc_mut_ty_log2", "stepSize", 1);
         int lagWindow = config.getInt("6002_m_vpc_mut_ty_log2", "lagWindow", 120);
+        int threadsNum = config.getInt("6002_m_vpc_mut_ty_log2", "threadsNum", 1);
+        // 检查点文件（非空时初始化后保存快照，并由新实例恢复后继续更新）
+        std::string checkpoint_path = config.getString("6002_m_vpc_mut_ty_log2", "checkpoint_path", "");
 
         if (input_amt.empty() || input_close.empty() || output_csv.empty()) {
             std::cerr << "错误: 配置文件中缺少必要的输入/输出路径" << std::endl;
@@ -50,6 +55,7 @@ int main() {
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 配置参数:" << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   lagWindow = " << lagWindow << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   stepSize = " << stepSize << endl;
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   threadsNum = " << threadsNum << endl;
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "]   precision = " << precision << endl;
 
         // 加载输入数据
@@ -81,7 +87,13 @@ int main() {
             return 1;
         }
 
-        m_vpc_mut_ty_log2 factor;
+        // 创建实例（检查点恢复时按相同设置另建实例）
+        auto createM_vpc_mut_ty_log2 = [&]() {
+            auto instance = std::make_unique<m_vpc_mut_ty_log2>();
+            instance->setThreadsNum(static_cast<size_t>(threadsNum));
+            return instance;
+        };
+        auto factor = createM_vpc_mut_ty_log2();
 
         std::ofstream output_file(output_csv);
         if (!output_file.is_open()) {
@@ -104,7 +116,7 @@ int main() {
 
         {
             PROFILE_SCOPE("m_vpc_mut_ty_log2::Init");
-            int ret = factor.Init(initAmt, initClose);
+            int ret = factor->Init(initAmt, initClose);
             if (ret != 0) {
                 std::cerr << "错误: Init 返回非零状态码: " << ret << std::endl;
                 return 1;
@@ -114,8 +126,12 @@ int main() {
         double init_elapsed = getElapsedMs(init_start);
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 初始化完成，耗时: " 
              << std::fixed << std::setprecision(3) << init_elapsed << " ms" << endl;
+        const auto arena_stats = factor->getArenaStats();
+        cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 节点内存池: " << arena_stats.nodes << " 个节点, "
+             << arena_stats.allocations << " 次分配, 已用 " << std::fixed << std::setprecision(1) << arena_stats.usedBytes / 1024.0
+             << " KB / 预留 " << arena_stats.reservedBytes / 1024.0 << " KB, " << arena_stats.blocks << " 块" << endl;
 
-        const Ve& init_value = factor.getValue();
+        const Ve& init_value = factor->getValue();
         output_file << lagWindow - 1 << ",0,init," << std::fixed << std::setprecision(3) << init_elapsed;
         for (int i = 0; i < num_stocks; ++i) {
             if (i < init_value.size()) {
@@ -131,6 +147,26 @@ int main() {
         }
         output_file << "\n";
 
+        // 检查点：保存快照后在新实例上恢复，后续更新由恢复出的实例继续（结果应与连续运行一致）
+        if (!checkpoint_path.empty()) {
+            auto save_start = std::chrono::high_resolution_clock::now();
+            if (factor->SaveCheckpoint(checkpoint_path) != 0) {
+                std::cerr << "错误: 检查点保存失败: " << checkpoint_path << std::endl;
+                return 1;
+            }
+            double save_elapsed = getElapsedMs(save_start);
+            auto restore_start = std::chrono::high_resolution_clock::now();
+            auto restored = createM_vpc_mut_ty_log2();
+            if (restored->RestoreCheckpoint(checkpoint_path) != 0) {
+                std::cerr << "错误: 检查点恢复失败: " << checkpoint_path << std::endl;
+                return 1;
+            }
+            double restore_elapsed = getElapsedMs(restore_start);
+            factor = std::move(restored);
+            cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 检查点: 保存耗时 " << std::fixed << std::setprecision(3) << save_elapsed
+                 << " ms, 恢复耗时 " << restore_elapsed << " ms" << endl;
+        }
+
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] 开始持续更新..." << endl;
         int update_count = 0;
         int current_time = lagWindow;
@@ -145,13 +181,13 @@ int main() {
 
             {
                 PROFILE_SCOPE("m_vpc_mut_ty_log2::Update");
-                factor.Update(updateAmt, updateClose);
+                factor->Update(updateAmt, updateClose);
             }
 
             double update_elapsed = getElapsedMs(update_start);
             update_count++;
 
-            const Ve& update_value = factor.getValue();
+            const Ve& update_value = factor->getValue();
             output_file << (current_time + update_size - 1) << "," << update_count << ",update,"
                         << std::fixed << std::setprecision(3) << update_elapsed;
             for (int i = 0; i < num_stocks; ++i) {
@@ -179,7 +215,7 @@ int main() {
             current_time += update_size;
         }
 
-        factor.Finish();
+        factor->Finish();
         output_file.close();
 
         cout << "[" << Tool::Timestamp::getCurrentTimestamp() << "] === 计算完成 ===" << endl;